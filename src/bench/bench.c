@@ -0,0 +1,708 @@
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "le_vec.h"
+#include "le_vec_aggregates.h"
+#include "le_vec_compressed.h"
+#include "le_vec_hash.h"
+#include "le_vec_histogram.h"
+#include "le_vec_jagged.h"
+#include "le_vec_math.h"
+#include "le_vec_persistent.h"
+#include "le_vec_rle.h"
+#include "le_vec_sorted.h"
+#include "le_vec_table.h"
+#include "le_vec_text.h"
+#include "util.h"
+#include "bench/common.h"
+
+// Returns a value that is not present in input
+LE_VEC_TYPE absent_value(struct le_vec const *input) {
+    LE_VEC_TYPE value = -1;
+    while (le_vec_count(input, value) != 0) {
+        value--;
+    }
+
+    return value;
+}
+
+LE_VEC_TYPE add_one(LE_VEC_TYPE value) {
+    return value + 1;
+}
+
+void *setup_absent(struct le_vec const *input) {
+    LE_VEC_TYPE *value = malloc(sizeof(LE_VEC_TYPE));
+    *value = absent_value(input);
+
+    return value;
+}
+
+void *setup_copy(struct le_vec const *input) {
+    return le_vec_copy(input);
+}
+
+void teardown_vec(void *state) {
+    le_vec_destroy(state);
+}
+
+void run_push_back(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec *v = le_vec_init();
+    for (size_t i = 0; i < le_vec_get_length(input); i++) {
+        le_vec_push_back(v, le_vec_get_at(input, i));
+    }
+    le_vec_destroy(v);
+}
+
+void run_extend(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec *v = le_vec_init();
+    le_vec_extend(v, input);
+    le_vec_destroy(v);
+}
+
+void run_find(void *state, struct le_vec const *input) {
+    bench_consume(le_vec_find(input, *(LE_VEC_TYPE *)state));
+}
+
+void run_find_all(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec *out = le_vec_init();
+    bench_consume(le_vec_find_all(input, le_vec_get_at(input, 0), out));
+    le_vec_destroy(out);
+}
+
+void run_equal(void *state, struct le_vec const *input) {
+    bench_consume(le_vec_equal(input, state));
+}
+
+void run_compare(void *state, struct le_vec const *input) {
+    bench_consume(le_vec_compare(input, state));
+}
+
+void run_hash(void *state, struct le_vec const *input) {
+    (void)state;
+
+    bench_consume((long long)le_vec_hash(input));
+}
+
+void run_count(void *state, struct le_vec const *input) {
+    bench_consume(le_vec_count(input, *(LE_VEC_TYPE *)state));
+}
+
+void run_histogram(void *state, struct le_vec const *input) {
+    (void)state;
+
+    size_t counts[256];
+    le_vec_histogram(input, 0, 255, counts);
+    bench_consume((long long)counts[0]);
+}
+
+void run_value_counts(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec_value_count *counts;
+    bench_consume((long long)le_vec_value_counts(input, &counts));
+    free(counts);
+}
+
+// Keys are the first 16 elements: a dense range for low cardinality inputs, sparse for uniform ones
+void run_count_many(void *state, struct le_vec const *input) {
+    (void)state;
+
+    LE_VEC_TYPE keys[16];
+    size_t counts[16];
+    for (size_t i = 0; i < 16; i++) {
+        keys[i] = le_vec_get_at(input, i);
+    }
+    le_vec_count_many(input, keys, 16, counts);
+    bench_consume((long long)counts[0]);
+}
+
+void run_map(void *state, struct le_vec const *input) {
+    (void)state;
+
+    le_vec_destroy(le_vec_map(input, add_one));
+}
+
+// Grows vector in doubling steps and shrinks it back
+void run_resize(void *state, struct le_vec const *input) {
+    (void)state;
+
+    size_t length = le_vec_get_length(input);
+    struct le_vec *v = le_vec_init();
+
+    size_t l = 1;
+    for (; l < length; l *= 2) {
+        le_vec_resize(v, l);
+    }
+    for (; l > 0; l /= 2) {
+        le_vec_resize(v, l);
+    }
+
+    le_vec_destroy(v);
+}
+
+void run_resize_fill(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec *v = le_vec_init();
+    le_vec_resize_fill(v, le_vec_get_length(input), 7);
+    bench_consume(le_vec_get_at(v, 0));
+    le_vec_destroy(v);
+}
+
+void run_resize_fill_zero(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec *v = le_vec_init();
+    le_vec_resize_fill(v, le_vec_get_length(input), 0);
+    bench_consume(le_vec_get_at(v, 0));
+    le_vec_destroy(v);
+}
+
+void run_iota(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec *v = le_vec_init_with_capacity(le_vec_get_length(input));
+    le_vec_resize_uninit(v, le_vec_get_length(input));
+    le_vec_iota(v, 0, 3);
+    bench_consume(le_vec_get_at(v, 0));
+    le_vec_destroy(v);
+}
+
+void run_replace_all(void *state, struct le_vec const *input) {
+    struct le_vec *v = state;
+    LE_VEC_TYPE first = le_vec_get_at(input, 0);
+    LE_VEC_TYPE other = first == 0 ? 1 : 0;
+
+    // Replacing back and forth keeps the amount of work the same for every run
+    le_vec_replace_all(v, first, other);
+    le_vec_replace_all(v, other, first);
+}
+
+// Copying is measured too, so that every run compacts the same input
+void run_remove_value(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec *v = le_vec_copy(input);
+    bench_consume(le_vec_remove_value(v, le_vec_get_at(input, 0)));
+    le_vec_destroy(v);
+}
+
+void run_sort(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec *v = le_vec_copy(input);
+    le_vec_sort(v);
+    le_vec_destroy(v);
+}
+
+// Selection runs on a fresh copy like sort, so the two compare directly
+void run_nth_element(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec *v = le_vec_copy(input);
+    le_vec_nth_element(v, le_vec_get_length(v) / 2);
+    le_vec_destroy(v);
+}
+
+void run_partial_sort(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec *v = le_vec_copy(input);
+    le_vec_partial_sort(v, 100);
+    le_vec_destroy(v);
+}
+
+void run_top_k(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec *out = le_vec_init();
+    le_vec_top_k(input, 100, out);
+    le_vec_destroy(out);
+}
+
+// Scanning in place changes values, but not the amount of work
+void run_inclusive_scan(void *state, struct le_vec const *input) {
+    (void)input;
+
+    le_vec_inclusive_scan(state);
+}
+
+// Pair of sets: distinct input values and every other of them
+struct sets {
+    struct le_vec *a;
+    struct le_vec *b;
+    struct le_vec *out;
+};
+
+void *setup_sets(struct le_vec const *input) {
+    struct sets *sets = malloc(sizeof(struct sets));
+    sets->a = le_vec_copy(input);
+    le_vec_sort(sets->a);
+    le_vec_unique(sets->a);
+
+    sets->b = le_vec_init();
+    for (size_t i = 0; i < le_vec_get_length(sets->a); i += 2) {
+        le_vec_push_back(sets->b, le_vec_get_at(sets->a, i));
+    }
+
+    sets->out = le_vec_init();
+    return sets;
+}
+
+void teardown_sets(void *state) {
+    struct sets *sets = state;
+    le_vec_destroy(sets->a);
+    le_vec_destroy(sets->b);
+    le_vec_destroy(sets->out);
+    free(sets);
+}
+
+void run_set_union(void *state, struct le_vec const *input) {
+    (void)input;
+
+    struct sets *sets = state;
+    bench_consume(le_vec_set_union(sets->a, sets->b, sets->out));
+}
+
+void run_set_intersection(void *state, struct le_vec const *input) {
+    (void)input;
+
+    struct sets *sets = state;
+    bench_consume(le_vec_set_intersection(sets->a, sets->b, sets->out));
+}
+
+struct indexed {
+    struct le_vec *indexes;
+    struct le_vec *out;
+};
+
+// Indexes all over the input, every access is a likely cache miss
+void *setup_random_indexes(struct le_vec const *input) {
+    size_t length = le_vec_get_length(input);
+    struct indexed *indexed = malloc(sizeof(struct indexed));
+    indexed->indexes = le_vec_init_with_length(length);
+    indexed->out = le_vec_copy(input);
+
+    uint64_t random = 11;
+    for (size_t i = 0; i < length; i++) {
+        le_vec_set_at(indexed->indexes, i, (LE_VEC_TYPE)(bench_random(&random) % length));
+    }
+
+    return indexed;
+}
+
+// Indexes shuffled only within blocks of 64 neighbouring elements
+void *setup_clustered_indexes(struct le_vec const *input) {
+    size_t length = le_vec_get_length(input);
+    struct indexed *indexed = malloc(sizeof(struct indexed));
+    indexed->indexes = le_vec_init_with_length(length);
+    indexed->out = le_vec_copy(input);
+
+    uint64_t random = 11;
+    for (size_t i = 0; i < length; i++) {
+        size_t index = (i & ~(size_t)63) + bench_random(&random) % 64;
+        le_vec_set_at(indexed->indexes, i, (LE_VEC_TYPE)(index < length ? index : i));
+    }
+
+    return indexed;
+}
+
+void teardown_indexed(void *state) {
+    struct indexed *indexed = state;
+    le_vec_destroy(indexed->indexes);
+    le_vec_destroy(indexed->out);
+    free(indexed);
+}
+
+void run_gather(void *state, struct le_vec const *input) {
+    struct indexed *indexed = state;
+    bench_consume(le_vec_gather(indexed->out, input, indexed->indexes));
+}
+
+void run_scatter(void *state, struct le_vec const *input) {
+    struct indexed *indexed = state;
+    bench_consume(le_vec_scatter(indexed->out, indexed->indexes, input));
+}
+
+void run_add(void *state, struct le_vec const *input) {
+    bench_consume(le_vec_add(state, input));
+}
+
+void run_axpy(void *state, struct le_vec const *input) {
+    bench_consume(le_vec_axpy(state, 3, input));
+}
+
+void run_dot(void *state, struct le_vec const *input) {
+    bench_consume(le_vec_dot(state, input, NULL));
+}
+
+void run_sum(void *state, struct le_vec const *input) {
+    (void)input;
+
+    bench_consume(le_vec_sum(state));
+}
+
+void *setup_tracked(struct le_vec const *input) {
+    struct le_vec *v = le_vec_copy(input);
+    le_vec_track_aggregates(v, true);
+
+    return v;
+}
+
+// A poll after a few updates, as dashboards do
+void run_tracked_sum(void *state, struct le_vec const *input) {
+    size_t length = le_vec_get_length(input);
+    uint64_t random = 5;
+
+    for (size_t i = 0; i < 16; i++) {
+        le_vec_set_at(state, bench_random(&random) % length, (LE_VEC_TYPE)i);
+    }
+    bench_consume(le_vec_sum(state) + le_vec_max(state, NULL));
+}
+
+// Input as comma-separated text
+void *setup_text(struct le_vec const *input) {
+    size_t length = le_vec_get_length(input);
+    char *text = malloc(length * 12 + 1);
+    size_t text_length = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        text_length += (size_t)sprintf(text + text_length, "%d,", le_vec_get_at(input, i));
+    }
+
+    return text;
+}
+
+void run_parse_ints(void *state, struct le_vec const *input) {
+    (void)input;
+
+    struct le_vec *v = le_vec_init();
+    le_vec_parse_ints(v, state, strlen(state), ',', NULL);
+    le_vec_destroy(v);
+}
+
+void *setup_text_buffer(struct le_vec const *input) {
+    return malloc(le_vec_get_length(input) * 12 + 1);
+}
+
+void run_format(void *state, struct le_vec const *input) {
+    size_t capacity = le_vec_get_length(input) * 12 + 1;
+    bench_consume((long long)le_vec_format(input, state, capacity, ','));
+}
+
+void *setup_compressed(struct le_vec const *input) {
+    return le_vec_compressed_init(input);
+}
+
+void teardown_compressed(void *state) {
+    le_vec_compressed_destroy(state);
+}
+
+size_t bytes_compressed(void *state) {
+    return le_vec_compressed_get_size(state);
+}
+
+void run_compressed_init(void *state, struct le_vec const *input) {
+    (void)state;
+
+    le_vec_compressed_destroy(le_vec_compressed_init(input));
+}
+
+void run_compressed_sum(void *state, struct le_vec const *input) {
+    (void)input;
+
+    bench_consume(le_vec_compressed_sum(state));
+}
+
+void run_compressed_count(void *state, struct le_vec const *input) {
+    bench_consume(le_vec_compressed_count(state, le_vec_get_at(input, 0)));
+}
+
+void run_compressed_get_at(void *state, struct le_vec const *input) {
+    size_t length = le_vec_get_length(input);
+    uint64_t random = 7;
+    long long sum = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        sum += le_vec_compressed_get_at(state, bench_random(&random) % length);
+    }
+    bench_consume(sum);
+}
+
+void *setup_rle(struct le_vec const *input) {
+    return le_vec_rle_init_from_vec(input);
+}
+
+void teardown_rle(void *state) {
+    le_vec_rle_destroy(state);
+}
+
+size_t bytes_rle(void *state) {
+    return le_vec_rle_get_size(state);
+}
+
+void run_rle_count(void *state, struct le_vec const *input) {
+    bench_consume(le_vec_rle_count(state, le_vec_get_at(input, 0)));
+}
+
+void run_rle_replace_all(void *state, struct le_vec const *input) {
+    LE_VEC_TYPE first = le_vec_get_at(input, 0);
+    LE_VEC_TYPE other = first == 0 ? 1 : 0;
+
+    le_vec_rle_replace_all(state, first, other);
+    le_vec_rle_replace_all(state, other, first);
+}
+
+// Input as the first column of a 4-column table
+void *setup_table(struct le_vec const *input) {
+    struct le_vec_table *t = le_vec_table_init(4);
+    for (size_t i = 0; i < le_vec_get_length(input); i++) {
+        LE_VEC_TYPE value = le_vec_get_at(input, i);
+        LE_VEC_TYPE row[] = {value, value + 1, value + 2, value + 3};
+        le_vec_table_push_back(t, row);
+    }
+
+    return t;
+}
+
+void teardown_table(void *state) {
+    le_vec_table_destroy(state);
+}
+
+void run_table_push_back(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec_table *t = le_vec_table_init(4);
+    for (size_t i = 0; i < le_vec_get_length(input); i++) {
+        LE_VEC_TYPE value = le_vec_get_at(input, i);
+        LE_VEC_TYPE row[] = {value, value, value, value};
+        le_vec_table_push_back(t, row);
+    }
+    le_vec_table_destroy(t);
+}
+
+void run_table_count(void *state, struct le_vec const *input) {
+    bench_consume(le_vec_count(le_vec_table_column(state, 0), le_vec_get_at(input, 0)));
+}
+
+// Splits input into rows of 8, one le_vec per row, as a baseline for jagged arrays
+void run_vecs_push_back(void *state, struct le_vec const *input) {
+    (void)state;
+
+    size_t length = le_vec_get_length(input);
+    size_t rows = (length + 7) / 8;
+    struct le_vec **vecs = malloc(rows * sizeof(struct le_vec *));
+    for (size_t row = 0; row < rows; row++) {
+        vecs[row] = le_vec_init();
+    }
+    for (size_t i = 0; i < length; i++) {
+        le_vec_push_back(vecs[i / 8], le_vec_get_at(input, i));
+    }
+
+    for (size_t row = 0; row < rows; row++) {
+        le_vec_destroy(vecs[row]);
+    }
+    free(vecs);
+}
+
+void run_jagged_push_back(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec_jagged *j = le_vec_jagged_init();
+    for (size_t i = 0; i < le_vec_get_length(input); i++) {
+        if (i % 8 == 0) {
+            le_vec_jagged_push_row(j, NULL, 0);
+        }
+        le_vec_jagged_push_back(j, le_vec_get_at(input, i));
+    }
+    bench_consume((long long)le_vec_jagged_get_rows_length(j));
+    le_vec_jagged_destroy(j);
+}
+
+void *setup_persistent(struct le_vec const *input) {
+    return le_vec_persistent_init_from_vec(input);
+}
+
+void teardown_persistent(void *state) {
+    le_vec_persistent_destroy(state);
+}
+
+void run_persistent_transient_push_back(void *state, struct le_vec const *input) {
+    (void)state;
+
+    struct le_vec_persistent *empty = le_vec_persistent_init();
+    struct le_vec_transient *t = le_vec_persistent_transient(empty);
+    for (size_t i = 0; i < le_vec_get_length(input); i++) {
+        le_vec_transient_push_back(t, le_vec_get_at(input, i));
+    }
+    le_vec_persistent_destroy(le_vec_transient_persistent(t));
+    le_vec_persistent_destroy(empty);
+}
+
+// Each update makes a new version, the previous one is dropped
+void run_persistent_set_at(void *state, struct le_vec const *input) {
+    size_t length = le_vec_get_length(input);
+    uint64_t random = 11;
+
+    struct le_vec_persistent *p = le_vec_persistent_set_at(state, 0, 0);
+    for (size_t i = 0; i < 1024; i++) {
+        struct le_vec_persistent *next = le_vec_persistent_set_at(p, bench_random(&random) % length, (LE_VEC_TYPE)i);
+        le_vec_persistent_destroy(p);
+        p = next;
+    }
+    le_vec_persistent_destroy(p);
+}
+
+void run_persistent_get_at(void *state, struct le_vec const *input) {
+    size_t length = le_vec_get_length(input);
+    uint64_t random = 7;
+    long long sum = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        sum += le_vec_persistent_get_at(state, bench_random(&random) % length);
+    }
+    bench_consume(sum);
+}
+
+struct bench_case CASES[] = {
+    {"push_back", NULL, run_push_back, NULL},
+    {"extend", NULL, run_extend, NULL},
+    {"find", setup_absent, run_find, free},
+    {"find_all", NULL, run_find_all, NULL},
+    {"equal", setup_copy, run_equal, teardown_vec},
+    {"compare", setup_copy, run_compare, teardown_vec},
+    {"hash", NULL, run_hash, NULL},
+    {"count", setup_absent, run_count, free},
+    {"histogram/256", NULL, run_histogram, NULL},
+    {"value_counts", NULL, run_value_counts, NULL},
+    {"count_many/16", NULL, run_count_many, NULL},
+    {"map", NULL, run_map, NULL},
+    {"resize", NULL, run_resize, NULL},
+    {"resize_fill", NULL, run_resize_fill, NULL},
+    {"resize_fill/zero", NULL, run_resize_fill_zero, NULL},
+    {"iota", NULL, run_iota, NULL},
+    {"replace_all", setup_copy, run_replace_all, teardown_vec},
+    {"remove_value", NULL, run_remove_value, NULL},
+    {"sort", NULL, run_sort, NULL},
+    {"nth_element", NULL, run_nth_element, NULL},
+    {"partial_sort/100", NULL, run_partial_sort, NULL},
+    {"top_k/100", NULL, run_top_k, NULL},
+    {"inclusive_scan", setup_copy, run_inclusive_scan, teardown_vec},
+    {"set_union", setup_sets, run_set_union, teardown_sets},
+    {"set_intersection", setup_sets, run_set_intersection, teardown_sets},
+    {"add", setup_copy, run_add, teardown_vec},
+    {"axpy", setup_copy, run_axpy, teardown_vec},
+    {"dot", setup_copy, run_dot, teardown_vec},
+    {"sum", setup_copy, run_sum, teardown_vec},
+    {"aggregates/tracked_sum", setup_tracked, run_tracked_sum, teardown_vec},
+    {"gather/random", setup_random_indexes, run_gather, teardown_indexed},
+    {"gather/clustered", setup_clustered_indexes, run_gather, teardown_indexed},
+    {"scatter/random", setup_random_indexes, run_scatter, teardown_indexed},
+    {"scatter/clustered", setup_clustered_indexes, run_scatter, teardown_indexed},
+    {"parse_ints", setup_text, run_parse_ints, free},
+    {"format", setup_text_buffer, run_format, free},
+    {"compressed/init", NULL, run_compressed_init, NULL},
+    {"compressed/sum", setup_compressed, run_compressed_sum, teardown_compressed, bytes_compressed},
+    {"compressed/count", setup_compressed, run_compressed_count, teardown_compressed, bytes_compressed},
+    {"compressed/get_at_random", setup_compressed, run_compressed_get_at, teardown_compressed, bytes_compressed},
+    {"rle/count", setup_rle, run_rle_count, teardown_rle, bytes_rle},
+    {"rle/replace_all", setup_rle, run_rle_replace_all, teardown_rle, bytes_rle},
+    {"table/push_back", NULL, run_table_push_back, NULL},
+    {"table/count", setup_table, run_table_count, teardown_table},
+    {"vecs/push_back/8", NULL, run_vecs_push_back, NULL},
+    {"jagged/push_back/8", NULL, run_jagged_push_back, NULL},
+    {"persistent/transient_push_back", NULL, run_persistent_transient_push_back, NULL},
+    {"persistent/set_at", setup_persistent, run_persistent_set_at, teardown_persistent},
+    {"persistent/get_at_random", setup_persistent, run_persistent_get_at, teardown_persistent},
+};
+
+void print_usage(const char *name) {
+    printf(
+        "Usage: %s [options]\n"
+        "  --json PATH         write results as JSON\n"
+        "  --baseline PATH     compare medians against saved results, fail on regressions\n"
+        "  --allow-missing-baseline\n"
+        "                      only warn if the baseline file is missing or unreadable\n"
+        "  --threshold PCT     allowed slowdown against baseline (default 10)\n"
+        "  --filter STR        run only cases with STR in name\n"
+        "  --min-length N      smallest input length (default 1024)\n"
+        "  --max-length N      largest input length (default 33554432)\n"
+        "  --samples N         minimal number of samples (default 11)\n"
+        "  --threads N         threads of parallel cases, 1 runs everything on one core\n"
+        "                      (default: one per allowed cpu)\n",
+        name
+    );
+}
+
+int main(int argc, char **argv) {
+    struct bench_config config = {
+        .min_length = 1024,
+        // 128 MiB of ints, well beyond any LLC
+        .max_length = 32 * 1024 * 1024,
+        .min_samples = 11,
+        .filter = NULL,
+        .json_path = NULL,
+        .baseline_path = NULL,
+        .allow_missing_baseline = false,
+        .threshold = 0.1,
+        .threads = 0,
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (strcmp(arg, "--help") == 0) {
+            print_usage(argv[0]);
+            return 0;
+        }
+        if (strcmp(arg, "--allow-missing-baseline") == 0) {
+            config.allow_missing_baseline = true;
+            continue;
+        }
+        if (value == NULL) {
+            print_usage(argv[0]);
+            return 2;
+        }
+
+        if (strcmp(arg, "--json") == 0) {
+            config.json_path = value;
+        } else if (strcmp(arg, "--baseline") == 0) {
+            config.baseline_path = value;
+        } else if (strcmp(arg, "--threshold") == 0) {
+            config.threshold = atof(value) / 100;
+        } else if (strcmp(arg, "--filter") == 0) {
+            config.filter = value;
+        } else if (strcmp(arg, "--min-length") == 0) {
+            config.min_length = strtoull(value, NULL, 10);
+        } else if (strcmp(arg, "--max-length") == 0) {
+            config.max_length = strtoull(value, NULL, 10);
+        } else if (strcmp(arg, "--samples") == 0) {
+            config.min_samples = strtoull(value, NULL, 10);
+        } else if (strcmp(arg, "--threads") == 0) {
+            config.threads = strtoull(value, NULL, 10);
+        } else {
+            print_usage(argv[0]);
+            return 2;
+        }
+        i++;
+    }
+
+    if (config.min_length == 0) {
+        config.min_length = 1;
+    }
+
+    puts("Running benchmarks...");
+    printf("\n");
+
+    return bench_run(CASES, array_length(CASES), &config);
+}
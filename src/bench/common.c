@@ -0,0 +1,361 @@
+#define _GNU_SOURCE
+
+#include <sched.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "le_vec.h"
+#include "bench/common.h"
+
+// Every sample is at least this long, short runs are repeated inside one sample
+#define MIN_SAMPLE_NS 200000ull
+// Minimal time spent on warmup, lets CPU leave power-saving states
+#define WARMUP_NS 50000000ull
+// Samples are taken until this much time is spent (or max samples reached)
+#define TARGET_NS 300000000ull
+#define MAX_SAMPLES 101
+
+struct bench_result {
+    char name[64];
+    char dist[32];
+    size_t length;
+    size_t samples;
+    double median_ns;
+    double p99_ns;
+    // Bytes held by state of the case, 0 if it doesn't report them. Not saved to JSON
+    size_t bytes;
+};
+
+static volatile long long sink;
+
+static const char *DIST_NAMES[] = {
+    [BENCH_DIST_SEQUENTIAL] = "sequential",
+    [BENCH_DIST_UNIFORM] = "uniform",
+    [BENCH_DIST_LOW_CARDINALITY] = "low_cardinality",
+};
+
+uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t bench_random(uint64_t *state) {
+    uint64_t x = *state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *state = x;
+    return x * 0x2545F4914F6CDD1Dull;
+}
+
+void bench_consume(long long value) {
+    sink = value;
+}
+
+// Keeps the process on fixed cores, so that timings don't include migrations. Threads of parallel
+// cases inherit the mask, so it holds one core per library thread: just the current one when threading
+// is off, that core and the next allowed ones otherwise.
+static void pin_cpus(size_t threads) {
+    int cpu = sched_getcpu();
+    cpu_set_t allowed;
+    if (cpu < 0 || sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+        return;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    size_t count = 1;
+    for (int other = 0; other < CPU_SETSIZE && count < threads; other++) {
+        if (other != cpu && CPU_ISSET(other, &allowed)) {
+            CPU_SET(other, &set);
+            count++;
+        }
+    }
+
+    if (sched_setaffinity(0, sizeof(set), &set) != 0) {
+        fprintf(stderr, "warning: failed to pin to %zu cpu(s)\n", count);
+        return;
+    }
+
+    // More threads than cores would only be time-sliced
+    le_vec_set_thread_count(count);
+}
+
+static void check_governor(void) {
+    FILE *f = fopen("/sys/devices/system/cpu/cpu0/cpufreq/scaling_governor", "r");
+    if (f == NULL) {
+        return;
+    }
+
+    char governor[64] = {0};
+    if (fgets(governor, sizeof(governor), f) != NULL && strncmp(governor, "performance", 11) != 0) {
+        fprintf(stderr, "warning: cpu governor is not 'performance', timings might be unstable\n");
+    }
+    fclose(f);
+}
+
+static struct le_vec *generate_input(size_t length, enum bench_dist dist) {
+    struct le_vec *v = le_vec_init();
+    uint64_t state = 0x9E3779B97F4A7C15ull ^ length;
+
+    for (size_t i = 0; i < length; i++) {
+        LE_VEC_TYPE value;
+        switch (dist) {
+            case BENCH_DIST_SEQUENTIAL:
+                value = (LE_VEC_TYPE)i;
+                break;
+            case BENCH_DIST_UNIFORM:
+                value = (LE_VEC_TYPE)bench_random(&state);
+                break;
+            default:
+                value = (LE_VEC_TYPE)(bench_random(&state) % 8);
+                break;
+        }
+        le_vec_push_back(v, value);
+    }
+
+    return v;
+}
+
+static int compare_u64(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t time_runs(struct bench_case const *c, void *state, struct le_vec const *input, size_t runs) {
+    uint64_t start = bench_now_ns();
+    for (size_t i = 0; i < runs; i++) {
+        c->run(state, input);
+    }
+    return bench_now_ns() - start;
+}
+
+static void measure(struct bench_case const *c, struct le_vec const *input, size_t min_samples, struct bench_result *result) {
+    void *state = c->setup != NULL ? c->setup(input) : NULL;
+    result->bytes = c->bytes != NULL ? c->bytes(state) : 0;
+
+    // Calibrate runs per sample, which also serves as the first warmup run
+    uint64_t single = time_runs(c, state, input, 1);
+    size_t runs = single >= MIN_SAMPLE_NS ? 1 : (size_t)(MIN_SAMPLE_NS / (single + 1)) + 1;
+
+    uint64_t warmup_start = bench_now_ns();
+    do {
+        time_runs(c, state, input, runs);
+    } while (bench_now_ns() - warmup_start < WARMUP_NS);
+
+    uint64_t samples[MAX_SAMPLES];
+    size_t samples_length = 0;
+    uint64_t spent = 0;
+
+    while (samples_length < MAX_SAMPLES && (samples_length < min_samples || spent < TARGET_NS)) {
+        uint64_t ns = time_runs(c, state, input, runs);
+        samples[samples_length++] = ns / runs;
+        spent += ns;
+    }
+
+    if (c->teardown != NULL) {
+        c->teardown(state);
+    }
+
+    qsort(samples, samples_length, sizeof(uint64_t), compare_u64);
+
+    size_t p99_index = (samples_length * 99 + 99) / 100 - 1;
+    result->samples = samples_length;
+    result->median_ns = (double)samples[samples_length / 2];
+    result->p99_ns = (double)samples[p99_index];
+}
+
+static bool write_json(const char *path, struct bench_result const *results, size_t length) {
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        return false;
+    }
+
+    fprintf(f, "{\n  \"results\": [\n");
+    for (size_t i = 0; i < length; i++) {
+        struct bench_result const *r = &results[i];
+        fprintf(
+            f,
+            "    {\"name\": \"%s\", \"dist\": \"%s\", \"length\": %zu, \"samples\": %zu, \"median_ns\": %.1f, \"p99_ns\": %.1f}%s\n",
+            r->name, r->dist, r->length, r->samples, r->median_ns, r->p99_ns,
+            i + 1 < length ? "," : ""
+        );
+    }
+    fprintf(f, "  ]\n}\n");
+
+    fclose(f);
+    return true;
+}
+
+// Reads results written by write_json(). Returns number of results or -1 if the file can't be opened.
+static long read_json(const char *path, struct bench_result **results) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return -1;
+    }
+
+    size_t capacity = 64;
+    size_t length = 0;
+    *results = malloc(capacity * sizeof(struct bench_result));
+
+    char line[512];
+    while (fgets(line, sizeof(line), f) != NULL) {
+        struct bench_result r;
+        int matched = sscanf(
+            line,
+            " {\"name\": \"%63[^\"]\", \"dist\": \"%31[^\"]\", \"length\": %zu, \"samples\": %zu, \"median_ns\": %lf, \"p99_ns\": %lf}",
+            r.name, r.dist, &r.length, &r.samples, &r.median_ns, &r.p99_ns
+        );
+        if (matched != 6) {
+            continue;
+        }
+
+        if (length == capacity) {
+            capacity *= 2;
+            *results = realloc(*results, capacity * sizeof(struct bench_result));
+        }
+        (*results)[length++] = r;
+    }
+
+    fclose(f);
+    return (long)length;
+}
+
+static struct bench_result const *find_result(struct bench_result const *results, size_t length, struct bench_result const *r) {
+    for (size_t i = 0; i < length; i++) {
+        struct bench_result const *candidate = &results[i];
+        if (candidate->length == r->length && strcmp(candidate->name, r->name) == 0 && strcmp(candidate->dist, r->dist) == 0) {
+            return candidate;
+        }
+    }
+
+    return NULL;
+}
+
+// Returns number of regressions
+static size_t compare_with_baseline(const char *path, struct bench_result const *baseline, size_t baseline_length, struct bench_result const *results, size_t length, double threshold) {
+    size_t regressions = 0;
+    printf("\nComparing against %s (threshold %.0f%%)...\n", path, threshold * 100);
+
+    for (size_t i = 0; i < length; i++) {
+        struct bench_result const *r = &results[i];
+        struct bench_result const *base = find_result(baseline, baseline_length, r);
+        if (base == NULL || base->median_ns <= 0) {
+            continue;
+        }
+
+        double ratio = r->median_ns / base->median_ns;
+        if (ratio > 1 + threshold) {
+            printf(
+                "REGRESSION %-28s %-16s %10zu: %.1f ns -> %.1f ns (%+.1f%%)\n",
+                r->name, r->dist, r->length, base->median_ns, r->median_ns, (ratio - 1) * 100
+            );
+            regressions++;
+        }
+    }
+
+    if (regressions == 0) {
+        printf("No regressions.\n");
+    }
+
+    return regressions;
+}
+
+int bench_run(struct bench_case const *cases, size_t cases_length, struct bench_config const *config) {
+    // Read baseline before measuring anything so that a missing one fails fast
+    struct bench_result *baseline = NULL;
+    long baseline_length = 0;
+    if (config->baseline_path != NULL) {
+        baseline_length = read_json(config->baseline_path, &baseline);
+        if (baseline_length <= 0) {
+            free(baseline);
+            baseline = NULL;
+            if (!config->allow_missing_baseline) {
+                fprintf(stderr, "error: no baseline results in %s, run 'make bench-baseline' to save one\n", config->baseline_path);
+                return 1;
+            }
+            fprintf(stderr, "warning: no baseline results in %s, skipping comparison\n", config->baseline_path);
+        }
+    }
+
+    pin_cpus(config->threads != 0 ? config->threads : le_vec_get_thread_count());
+    check_governor();
+    printf("Threads: %zu\n\n", le_vec_get_thread_count());
+
+    size_t results_capacity = 64;
+    size_t results_length = 0;
+    struct bench_result *results = malloc(results_capacity * sizeof(struct bench_result));
+
+    printf("%-28s %-16s %10s %8s %14s %14s %10s\n", "name", "dist", "length", "samples", "median ns", "p99 ns", "ns/elem");
+
+    for (size_t length = config->min_length; length <= config->max_length; length *= 32) {
+        for (size_t dist = 0; dist < sizeof(DIST_NAMES) / sizeof(*DIST_NAMES); dist++) {
+            struct le_vec *input = generate_input(length, (enum bench_dist)dist);
+
+            for (size_t i = 0; i < cases_length; i++) {
+                struct bench_case const *c = &cases[i];
+                if (config->filter != NULL && strstr(c->name, config->filter) == NULL) {
+                    continue;
+                }
+
+                if (results_length == results_capacity) {
+                    results_capacity *= 2;
+                    results = realloc(results, results_capacity * sizeof(struct bench_result));
+                }
+
+                struct bench_result *r = &results[results_length++];
+                snprintf(r->name, sizeof(r->name), "%s", c->name);
+                snprintf(r->dist, sizeof(r->dist), "%s", DIST_NAMES[dist]);
+                r->length = length;
+
+                measure(c, input, config->min_samples, r);
+
+                printf(
+                    "%-28s %-16s %10zu %8zu %14.1f %14.1f %10.3f\n",
+                    r->name, r->dist, r->length, r->samples, r->median_ns, r->p99_ns, r->median_ns / (double)length
+                );
+                if (r->bytes != 0) {
+                    size_t plain = length * sizeof(LE_VEC_TYPE);
+                    printf(
+                        "%-28s %-16s %10zu   memory: %zu bytes, plain %zu bytes, ratio %.2f\n",
+                        r->name, r->dist, r->length, r->bytes, plain, (double)plain / (double)r->bytes
+                    );
+                }
+                fflush(stdout);
+            }
+
+            le_vec_destroy(input);
+        }
+    }
+
+    int status = 0;
+
+    if (config->json_path != NULL) {
+        if (write_json(config->json_path, results, results_length)) {
+            printf("\nResults written to %s\n", config->json_path);
+        } else {
+            fprintf(stderr, "error: failed to write %s\n", config->json_path);
+            status = 1;
+        }
+    }
+
+    if (baseline != NULL) {
+        size_t regressions = compare_with_baseline(config->baseline_path, baseline, (size_t)baseline_length, results, results_length, config->threshold);
+        if (regressions != 0) {
+            printf("%zu benchmark(s) regressed.\n", regressions);
+            status = 1;
+        }
+    }
+
+    free(baseline);
+    free(results);
+    return status;
+}
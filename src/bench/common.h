@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "le_vec.h"
+
+// Distribution of generated input elements
+enum bench_dist {
+    // 0, 1, 2, ...
+    BENCH_DIST_SEQUENTIAL,
+    // Uniformly random over the whole LE_VEC_TYPE range
+    BENCH_DIST_UNIFORM,
+    // Random values from [0; 8)
+    BENCH_DIST_LOW_CARDINALITY,
+};
+
+// One microbenchmark, run for every input length and distribution
+struct bench_case {
+    const char *name;
+    // Builds state from generated input, not measured. Might be NULL
+    void *(*setup)(struct le_vec const *input);
+    // Measured part, must leave state ready for another run
+    void (*run)(void *state, struct le_vec const *input);
+    // Frees state. Might be NULL
+    void (*teardown)(void *state);
+    // Returns bytes held by state, reported against plain input bytes. Might be NULL
+    size_t (*bytes)(void *state);
+};
+
+struct bench_config {
+    size_t min_length;
+    size_t max_length;
+    // Minimal number of measured samples per case
+    size_t min_samples;
+    // Cases with names not containing filter are skipped. Might be NULL
+    const char *filter;
+    // Where to write JSON results. Might be NULL
+    const char *json_path;
+    // Results to compare against. Might be NULL
+    const char *baseline_path;
+    // Skip comparison instead of failing when baseline_path has no results
+    bool allow_missing_baseline;
+    // Allowed slowdown of median against baseline, 0.1 = 10%
+    double threshold;
+    // Threads of parallel cases, each gets its own core. 0 - library default
+    size_t threads;
+};
+
+// Runs all cases, prints report, writes and compares JSON.
+// Returns process exit code: non-zero if anything regressed against baseline
+int bench_run(struct bench_case const *cases, size_t cases_length, struct bench_config const *config);
+
+// Returns monotonic time in nanoseconds
+uint64_t bench_now_ns(void);
+// Returns next pseudo-random number (xorshift64*)
+uint64_t bench_random(uint64_t *state);
+
+// Keeps the compiler from throwing away a computed value
+void bench_consume(long long value);
@@ -1,58 +1,67 @@
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "le_vec.h"
+#include "le_vec_aggregates.h"
+#include "le_vec_dirty.h"
+#include "le_vec_internal.h"
+#include "le_vec_simd.h"
+#include "le_vec_trace.h"
 
-struct le_vec {
-    size_t capacity;
-    size_t length;
-    LE_VEC_TYPE *data;
-};
-
-// Expands data so that capacity is >= request.
-bool __le_vec_expand_to_request(struct le_vec *v, size_t request);
-// Expands data. Call this.
-bool _le_vec_expand(struct le_vec *v);
-// Explicitly and stupidly sets a length to a new value.
-void _le_vec_set_length(struct le_vec *v, size_t new_length);
-// Reallocates data and so that capacity == length.
-void _le_vec_shrink_down_to_length(struct le_vec *v);
-// Applies f for each element in src and stores result in dest.
-// dest.length must be >= src.lentgth to fit all elements.
-void _le_vec_map(struct le_vec *dest, struct le_vec const *src, LE_VEC_TYPE (*f)(LE_VEC_TYPE));
-
-struct le_vec *le_vec_init(void) {
+struct le_vec *_le_vec_create(size_t capacity, size_t length) {
     struct le_vec *v = malloc(sizeof(struct le_vec));
-    LE_VEC_TYPE *data = malloc(LE_VEC_DEFAULT_CAPACITY);
+    LE_VEC_TYPE *data = malloc(capacity * sizeof(LE_VEC_TYPE));
 
-    v->capacity = LE_VEC_DEFAULT_CAPACITY;
-    v->length = 0;
+    v->capacity = capacity;
+    v->length = length;
     v->data = data;
+    v->dirty = NULL;
+    v->aggregates = NULL;
+
+    LE_VEC_STATS_INIT(v);
+    LE_VEC_STATS_ON_ALLOC(v, capacity * sizeof(LE_VEC_TYPE));
+    LE_VEC_TRACE(init, v, 0, capacity, length);
 
     return v;
 }
 
+struct le_vec *le_vec_init(void) {
+    LE_VEC_STATS_CALL(NULL, LE_VEC_OP_INIT);
+
+    return _le_vec_create(LE_VEC_DEFAULT_CAPACITY, 0);
+}
+
 struct le_vec *le_vec_init_with_length(size_t request) {
+    LE_VEC_STATS_CALL(NULL, LE_VEC_OP_INIT);
+
     if (request == 0) {
         return NULL;
     }
 
-    struct le_vec *v = malloc(sizeof(struct le_vec));
-    LE_VEC_TYPE *data = malloc(request);
+    return _le_vec_create(request, request);
+}
 
-    v->capacity = request;
-    v->length = request;
-    v->data = data;
+struct le_vec *le_vec_init_with_capacity(size_t capacity) {
+    LE_VEC_STATS_CALL(NULL, LE_VEC_OP_INIT);
 
-    return v;
+    return _le_vec_create(capacity > 0 ? capacity : LE_VEC_DEFAULT_CAPACITY, 0);
 }
 
 void le_vec_destroy(struct le_vec *v) {
+    LE_VEC_STATS_CALL(NULL, LE_VEC_OP_DESTROY);
+
     if (v == NULL) {
         return;
     }
 
+    LE_VEC_STATS_ON_FREE(v, v->capacity * sizeof(LE_VEC_TYPE));
+    LE_VEC_TRACE(destroy, v, v->capacity, 0, v->length);
+
+    le_vec_track_changes(v, false);
+    le_vec_track_aggregates(v, false);
     free(v->data);
     v->data = NULL;
     free(v);
@@ -71,6 +80,8 @@ bool le_vec_is_empty(struct le_vec const *v) {
 }
 
 void le_vec_push_back(struct le_vec *v, LE_VEC_TYPE value) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_PUSH_BACK);
+
     if (v->length >= v->capacity) {
         _le_vec_expand(v);
     }
@@ -78,9 +89,12 @@ void le_vec_push_back(struct le_vec *v, LE_VEC_TYPE value) {
 
     size_t last_index = le_vec_get_last_index(v);
     v->data[last_index] = value;
+    LE_VEC_MARK_DIRTY(v, last_index, last_index + 1);
 }
 
 LE_VEC_TYPE le_vec_pop_back(struct le_vec *v) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_POP_BACK);
+
     size_t last_index = le_vec_get_last_index(v);
     LE_VEC_TYPE value = v->data[last_index];
 
@@ -110,31 +124,87 @@ size_t le_vec_get_last_index(struct le_vec const *v) {
 }
 
 LE_VEC_TYPE le_vec_get_at(struct le_vec const *v, size_t index) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_GET_AT);
+
     return v->data[index];
 }
 
 bool le_vec_set_at(struct le_vec *v, size_t index, LE_VEC_TYPE value) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_SET_AT);
+
     if (!le_vec_is_index_valid(v, index)) {
         return false;
     }
 
     v->data[index] = value;
+    LE_VEC_MARK_DIRTY(v, index, index + 1);
     return true;
 }
 
+void _le_vec_realloc_data(struct le_vec *v, size_t capacity) {
+#ifdef LE_VEC_STATS
+    uintptr_t old_address = (uintptr_t)v->data;
+    size_t old_bytes = v->capacity * sizeof(LE_VEC_TYPE);
+#endif
+    size_t old_capacity = v->capacity;
+
+    // A pair of probes, so that tracers can measure realloc latency
+    LE_VEC_TRACE(realloc_start, v, old_capacity, capacity, v->length);
+    v->data = realloc(v->data, capacity * sizeof(LE_VEC_TYPE));
+    v->capacity = capacity;
+    LE_VEC_TRACE(realloc_done, v, old_capacity, capacity, v->length);
+
+    LE_VEC_STATS_ON_REALLOC(v, old_bytes, capacity * sizeof(LE_VEC_TYPE), (uintptr_t)v->data != old_address);
+}
+
+// Returns capacity for at least `request` elements, doubling current one.
+static size_t grown_capacity(size_t capacity, size_t request) {
+    if (capacity == 0) {
+        capacity = LE_VEC_DEFAULT_CAPACITY;
+    }
+
+    while (capacity < request) {
+        capacity *= 2;
+    }
+
+    return capacity;
+}
+
 bool __le_vec_expand_to_request(struct le_vec *v, size_t request) {
     size_t capacity = le_vec_get_capacity(v);
     if (capacity >= request) {
         return false;
     }
 
-    while (capacity < request) {
-        capacity *= 2;
+    capacity = grown_capacity(capacity, request);
+    LE_VEC_TRACE(expand, v, v->capacity, capacity, v->length);
+    _le_vec_realloc_data(v, capacity);
+
+    return true;
+}
+
+bool _le_vec_expand_zeroed(struct le_vec *v, size_t request) {
+    size_t old_capacity = le_vec_get_capacity(v);
+    if (old_capacity >= request) {
+        return false;
     }
 
-    v->data = realloc(v->data, capacity);
+    size_t capacity = grown_capacity(old_capacity, request);
+    LE_VEC_TRACE(expand, v, old_capacity, capacity, v->length);
+    LE_VEC_TRACE(realloc_start, v, old_capacity, capacity, v->length);
+
+    // Big blocks come from fresh mappings, which calloc does not clear again
+    LE_VEC_TYPE *data = calloc(capacity, sizeof(LE_VEC_TYPE));
+    if (v->length > 0) {
+        memcpy(data, v->data, v->length * sizeof(LE_VEC_TYPE));
+    }
+    free(v->data);
+    v->data = data;
     v->capacity = capacity;
 
+    LE_VEC_TRACE(realloc_done, v, old_capacity, capacity, v->length);
+    LE_VEC_STATS_ON_REALLOC(v, old_capacity * sizeof(LE_VEC_TYPE), capacity * sizeof(LE_VEC_TYPE), true);
+
     return true;
 }
 
@@ -147,13 +217,13 @@ void _le_vec_set_length(struct le_vec *v, size_t new_length) {
 }
 
 void _le_vec_shrink_down_to_length(struct le_vec *v) {
-    size_t length = le_vec_get_length(v);
-
-    v->data = realloc(v->data, length);
-    v->capacity = length;
+    LE_VEC_TRACE(shrink, v, v->capacity, v->length, v->length);
+    _le_vec_realloc_data(v, le_vec_get_length(v));
 }
 
 void le_vec_resize(struct le_vec *v, size_t new_length) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_RESIZE);
+
     size_t capacity = le_vec_get_capacity(v);
     size_t length = le_vec_get_length(v);
 
@@ -161,9 +231,14 @@ void le_vec_resize(struct le_vec *v, size_t new_length) {
         return;
     }
 
+    if (new_length > length) {
+        LE_VEC_MARK_DIRTY(v, length, new_length);
+    }
+
     if (new_length > capacity) {
         __le_vec_expand_to_request(v, new_length);
         _le_vec_set_length(v, new_length);
+        LE_VEC_TRACE(resize, v, capacity, le_vec_get_capacity(v), new_length);
         return;
     }
 
@@ -172,9 +247,28 @@ void le_vec_resize(struct le_vec *v, size_t new_length) {
     if (le_vec_get_length(v) < le_vec_get_capacity(v) / 2) {
         _le_vec_shrink_down_to_length(v);
     }
+
+    LE_VEC_TRACE(resize, v, capacity, le_vec_get_capacity(v), new_length);
+}
+
+void le_vec_resize_uninit(struct le_vec *v, size_t new_length) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_RESIZE);
+
+    size_t capacity = le_vec_get_capacity(v);
+    size_t length = le_vec_get_length(v);
+
+    if (new_length > length) {
+        LE_VEC_MARK_DIRTY(v, length, new_length);
+    }
+
+    __le_vec_expand_to_request(v, new_length);
+    _le_vec_set_length(v, new_length);
+    LE_VEC_TRACE(resize, v, capacity, le_vec_get_capacity(v), new_length);
 }
 
 void le_vec_extend(struct le_vec *v, struct le_vec const *other) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_EXTEND);
+
     if (le_vec_is_empty(other)) {
         return;
     }
@@ -183,6 +277,7 @@ void le_vec_extend(struct le_vec *v, struct le_vec const *other) {
     size_t other_length = le_vec_get_length(other);
 
     size_t total_length = v_length + other_length;
+    size_t capacity = le_vec_get_capacity(v);
 
     le_vec_resize(v, total_length);
 
@@ -192,6 +287,144 @@ void le_vec_extend(struct le_vec *v, struct le_vec const *other) {
 
         le_vec_set_at(v, v_index, le_vec_get_at(other, other_index));
     }
+
+    LE_VEC_TRACE(extend, v, capacity, le_vec_get_capacity(v), total_length);
+}
+
+bool le_vec_insert_at(struct le_vec *v, size_t index, LE_VEC_TYPE value) {
+    return le_vec_insert_n_at(v, index, value, 1);
+}
+
+bool le_vec_insert_n_at(struct le_vec *v, size_t index, LE_VEC_TYPE value, size_t n) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_INSERT);
+
+    size_t length = le_vec_get_length(v);
+    if (index > length) {
+        return false;
+    }
+
+    __le_vec_expand_to_request(v, length + n);
+    memmove(v->data + index + n, v->data + index, (length - index) * sizeof(LE_VEC_TYPE));
+    for (size_t i = 0; i < n; i++) {
+        v->data[index + i] = value;
+    }
+    _le_vec_set_length(v, length + n);
+    LE_VEC_MARK_DIRTY(v, index, length + n);
+
+    return true;
+}
+
+bool le_vec_erase_range(struct le_vec *v, size_t start, size_t end) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_ERASE);
+
+    size_t length = le_vec_get_length(v);
+    if (start > end || end > length) {
+        return false;
+    }
+
+    memmove(v->data + start, v->data + end, (length - end) * sizeof(LE_VEC_TYPE));
+    _le_vec_set_length(v, length - (end - start));
+    if (end > start) {
+        LE_VEC_MARK_DIRTY(v, start, length - (end - start));
+    }
+
+    return true;
+}
+
+// Compacts kept elements of data[start; length) to data[out; ...), returns new length.
+static size_t remove_value_scalar(LE_VEC_TYPE *data, size_t start, size_t length, size_t out, LE_VEC_TYPE value) {
+    for (size_t i = start; i < length; i++) {
+        // Branchless: always write, advance only if kept
+        data[out] = data[i];
+        out += data[i] != value;
+    }
+
+    return out;
+}
+
+#ifdef LE_VEC_X86
+// Writing 8 lanes at `out` is safe: out <= i, so only already loaded elements get overwritten
+LE_VEC_TARGET("avx2,bmi,bmi2,popcnt")
+static size_t remove_value_avx2(LE_VEC_TYPE *data, size_t length, LE_VEC_TYPE value) {
+    __m256i needle = _mm256_set1_epi32(value);
+    size_t out = 0;
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        __m256i x = _mm256_loadu_si256((__m256i const *)(data + i));
+        unsigned removed = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, needle)));
+        unsigned kept = ~removed & 0xFF;
+
+        __m256i packed = _mm256_permutevar8x32_epi32(x, le_vec_left_pack_permutation(kept));
+        _mm256_storeu_si256((__m256i *)(data + out), packed);
+        out += _mm_popcnt_u32(kept);
+    }
+
+    return remove_value_scalar(data, i, length, out, value);
+}
+
+LE_VEC_TARGET("avx512f,popcnt")
+static size_t remove_value_avx512(LE_VEC_TYPE *data, size_t length, LE_VEC_TYPE value) {
+    __m512i needle = _mm512_set1_epi32(value);
+    size_t out = 0;
+    size_t i = 0;
+
+    for (; i + 16 <= length; i += 16) {
+        __m512i x = _mm512_loadu_si512(data + i);
+        __mmask16 kept = _mm512_cmpneq_epi32_mask(x, needle);
+
+        _mm512_storeu_si512(data + out, _mm512_maskz_compress_epi32(kept, x));
+        out += _mm_popcnt_u32(kept);
+    }
+
+    return remove_value_scalar(data, i, length, out, value);
+}
+#endif
+
+size_t le_vec_remove_value(struct le_vec *v, LE_VEC_TYPE value) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_REMOVE);
+
+    size_t length = le_vec_get_length(v);
+    size_t new_length;
+
+#ifdef LE_VEC_X86
+    if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx512f")) {
+        new_length = remove_value_avx512(v->data, length, value);
+    } else if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx2") && LE_VEC_CPU_SUPPORTS("bmi2")) {
+        new_length = remove_value_avx2(v->data, length, value);
+    } else {
+        new_length = remove_value_scalar(v->data, 0, length, 0, value);
+    }
+#else
+    new_length = remove_value_scalar(v->data, 0, length, 0, value);
+#endif
+
+    _le_vec_set_length(v, new_length);
+    if (new_length < length) {
+        LE_VEC_MARK_DIRTY(v, 0, new_length);
+    }
+
+    return length - new_length;
+}
+
+size_t le_vec_remove_if(struct le_vec *v, bool (*pred)(LE_VEC_TYPE)) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_REMOVE);
+
+    size_t length = le_vec_get_length(v);
+    size_t out = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        LE_VEC_TYPE value = v->data[i];
+        v->data[out] = value;
+        out += !pred(value);
+    }
+
+    _le_vec_set_length(v, out);
+    if (out < length) {
+        LE_VEC_MARK_DIRTY(v, 0, out);
+    }
+
+    return length - out;
 }
 
 void _le_vec_map(struct le_vec *dest, struct le_vec const *src, LE_VEC_TYPE (*f)(LE_VEC_TYPE)) {
@@ -201,6 +434,8 @@ void _le_vec_map(struct le_vec *dest, struct le_vec const *src, LE_VEC_TYPE (*f)
 }
 
 struct le_vec *le_vec_map(struct le_vec const *v, LE_VEC_TYPE (*f)(LE_VEC_TYPE)) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_MAP);
+
     struct le_vec *new_v = le_vec_init_with_length(le_vec_get_length(v));
 
     _le_vec_map(new_v, v, f);
@@ -209,7 +444,10 @@ struct le_vec *le_vec_map(struct le_vec const *v, LE_VEC_TYPE (*f)(LE_VEC_TYPE))
 }
 
 void le_vec_for_each(struct le_vec *v, LE_VEC_TYPE (*f)(LE_VEC_TYPE)) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_MAP);
+
     _le_vec_map(v, v, f);
+    LE_VEC_MARK_DIRTY(v, 0, le_vec_get_length(v));
 }
 
 LE_VEC_TYPE return_itself(LE_VEC_TYPE value) {
@@ -220,7 +458,40 @@ struct le_vec *le_vec_copy(struct le_vec const *v) {
     return le_vec_map(v, return_itself);
 }
 
+bool le_vec_equal(struct le_vec const *a, struct le_vec const *b) {
+    size_t length = le_vec_get_length(a);
+    if (length != le_vec_get_length(b)) {
+        return false;
+    }
+
+    return length == 0 || memcmp(a->data, b->data, length * sizeof(LE_VEC_TYPE)) == 0;
+}
+
+// Elements are skipped in blocks compared with memcmp, which only tells whether a block differs:
+// its byte order is not the order of signed values
+#define COMPARE_BLOCK 64
+
+int le_vec_compare(struct le_vec const *a, struct le_vec const *b) {
+    size_t a_length = le_vec_get_length(a);
+    size_t b_length = le_vec_get_length(b);
+    size_t length = a_length < b_length ? a_length : b_length;
+    size_t i = 0;
+
+    while (i + COMPARE_BLOCK <= length && memcmp(a->data + i, b->data + i, COMPARE_BLOCK * sizeof(LE_VEC_TYPE)) == 0) {
+        i += COMPARE_BLOCK;
+    }
+    for (; i < length; i++) {
+        if (a->data[i] != b->data[i]) {
+            return a->data[i] < b->data[i] ? -1 : 1;
+        }
+    }
+
+    return (a_length > b_length) - (a_length < b_length);
+}
+
 struct le_vec *le_vec_reversed(struct le_vec const *v) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_REVERSE);
+
     size_t v_length = le_vec_get_length(v);
     size_t v_last_index = le_vec_get_last_index(v);
     struct le_vec *new_v = le_vec_init_with_length(v_length);
@@ -236,6 +507,8 @@ struct le_vec *le_vec_reversed(struct le_vec const *v) {
 }
 
 void le_vec_reverse(struct le_vec *v) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_REVERSE);
+
     size_t v_length = le_vec_get_length(v);
     size_t v_last_index = le_vec_get_last_index(v);
 
@@ -250,6 +523,8 @@ void le_vec_reverse(struct le_vec *v) {
 }
 
 struct le_vec *le_vec_slice(struct le_vec const *v, size_t start, size_t end) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_SLICE);
+
     if (!le_vec_is_index_valid(v, start) || !le_vec_is_index_valid(v, end - 1)) {
         return NULL;
     }
@@ -273,6 +548,8 @@ struct le_vec *le_vec_slice(struct le_vec const *v, size_t start, size_t end) {
 }
 
 size_t le_vec_count(struct le_vec const *v, LE_VEC_TYPE value) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_COUNT);
+
     size_t cntr = 0;
     for (size_t i = 0; i < le_vec_get_length(v); i++) {
         if (le_vec_get_at(v, i) == value) {
@@ -288,17 +565,9 @@ size_t le_vec_find(struct le_vec const *v, LE_VEC_TYPE elem) {
 }
 
 size_t le_vec_find_n(struct le_vec const *v, LE_VEC_TYPE elem, size_t n) {
-    size_t cntr = 0;
-    for (size_t i = 0; i < le_vec_get_length(v); i++) {
-        if (le_vec_get_at(v, i) == elem) {
-            cntr++;
-            if (cntr == n) {
-                return i;
-            }
-        }
-    }
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_FIND);
 
-    return (size_t)-1;
+    return _le_vec_search(v->data, le_vec_get_length(v), elem, n, false);
 }
 
 size_t le_vec_rfind(struct le_vec const *v, LE_VEC_TYPE elem) {
@@ -306,20 +575,124 @@ size_t le_vec_rfind(struct le_vec const *v, LE_VEC_TYPE elem) {
 }
 
 size_t le_vec_rfind_n(struct le_vec const *v, LE_VEC_TYPE elem, size_t n) {
-    size_t cntr = 0;
-    size_t v_last_index = le_vec_get_last_index(v);
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_FIND);
 
-    for (size_t i = 0; i < le_vec_get_length(v); i++) {
-        size_t v_index = v_last_index - i;
-        if (le_vec_get_at(v, v_index) == elem) {
-            cntr++;
-            if (cntr == n) {
-                return v_index;
-            }
+    return _le_vec_search(v->data, le_vec_get_length(v), elem, n, true);
+}
+
+// Matches are collected block by block, so out grows with the result instead of the whole vector
+#define FIND_ALL_BLOCK 4096
+// Vector stores write a full register of indexes past the last match
+#define FIND_ALL_SLACK 16
+
+// Writes indexes of elements of data[start; end) equal to value to out, returns number of matches.
+static size_t find_all_scalar(LE_VEC_TYPE const *data, size_t start, size_t end, LE_VEC_TYPE value, LE_VEC_TYPE *out) {
+    size_t found = 0;
+    for (size_t i = start; i < end; i++) {
+        // Branchless: always write, advance only if matched
+        out[found] = (LE_VEC_TYPE)i;
+        found += data[i] == value;
+    }
+
+    return found;
+}
+
+#ifdef LE_VEC_X86
+// Indexes of a group of 8 are left packed by the mask of matches, groups without matches are skipped
+LE_VEC_TARGET("avx2,bmi,bmi2,popcnt")
+static size_t find_all_avx2(LE_VEC_TYPE const *data, size_t start, size_t end, LE_VEC_TYPE value, LE_VEC_TYPE *out) {
+    __m256i needle = _mm256_set1_epi32(value);
+    __m256i indexes = _mm256_add_epi32(_mm256_set1_epi32((int)start), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    __m256i step = _mm256_set1_epi32(8);
+    size_t found = 0;
+    size_t i = start;
+
+    for (; i + 8 <= end; i += 8) {
+        __m256i x = _mm256_loadu_si256((__m256i const *)(data + i));
+        unsigned matched = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(x, needle)));
+        if (matched != 0) {
+            __m256i packed = _mm256_permutevar8x32_epi32(indexes, le_vec_left_pack_permutation(matched));
+            _mm256_storeu_si256((__m256i *)(out + found), packed);
+            found += _mm_popcnt_u32(matched);
+        }
+        indexes = _mm256_add_epi32(indexes, step);
+    }
+
+    return found + find_all_scalar(data, i, end, value, out + found);
+}
+
+LE_VEC_TARGET("avx512f,popcnt")
+static size_t find_all_avx512(LE_VEC_TYPE const *data, size_t start, size_t end, LE_VEC_TYPE value, LE_VEC_TYPE *out) {
+    __m512i needle = _mm512_set1_epi32(value);
+    __m512i indexes = _mm512_add_epi32(_mm512_set1_epi32((int)start),
+                                       _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15));
+    __m512i step = _mm512_set1_epi32(16);
+    size_t found = 0;
+    size_t i = start;
+
+    for (; i + 16 <= end; i += 16) {
+        __m512i x = _mm512_loadu_si512(data + i);
+        __mmask16 matched = _mm512_cmpeq_epi32_mask(x, needle);
+        if (matched != 0) {
+            _mm512_storeu_si512(out + found, _mm512_maskz_compress_epi32(matched, indexes));
+            found += _mm_popcnt_u32(matched);
         }
+        indexes = _mm512_add_epi32(indexes, step);
     }
 
-    return (size_t)-1;
+    return found + find_all_scalar(data, i, end, value, out + found);
+}
+#endif
+
+static size_t find_all_block(LE_VEC_TYPE const *data, size_t start, size_t end, LE_VEC_TYPE value, LE_VEC_TYPE *out) {
+#ifdef LE_VEC_X86
+    if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx512f")) {
+        return find_all_avx512(data, start, end, value, out);
+    }
+    if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx2") && LE_VEC_CPU_SUPPORTS("bmi2")) {
+        return find_all_avx2(data, start, end, value, out);
+    }
+#endif
+    return find_all_scalar(data, start, end, value, out);
+}
+
+size_t le_vec_find_all(struct le_vec const *v, LE_VEC_TYPE elem, struct le_vec *out) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_FIND);
+
+    size_t length = le_vec_get_length(v);
+    size_t found = 0;
+
+    for (size_t start = 0; start < length; start += FIND_ALL_BLOCK) {
+        size_t end = length - start > FIND_ALL_BLOCK ? start + FIND_ALL_BLOCK : length;
+        __le_vec_expand_to_request(out, found + (end - start) + FIND_ALL_SLACK);
+        found += find_all_block(v->data, start, end, elem, out->data + found);
+    }
+
+    _le_vec_set_length(out, found);
+    LE_VEC_MARK_DIRTY(out, 0, found);
+
+    return found;
+}
+
+size_t le_vec_find_all_if(struct le_vec const *v, bool (*pred)(LE_VEC_TYPE), struct le_vec *out) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_FIND);
+
+    size_t length = le_vec_get_length(v);
+    size_t found = 0;
+
+    for (size_t start = 0; start < length; start += FIND_ALL_BLOCK) {
+        size_t end = length - start > FIND_ALL_BLOCK ? start + FIND_ALL_BLOCK : length;
+        __le_vec_expand_to_request(out, found + (end - start));
+        for (size_t i = start; i < end; i++) {
+            out->data[found] = (LE_VEC_TYPE)i;
+            found += pred(v->data[i]);
+        }
+    }
+
+    _le_vec_set_length(out, found);
+    LE_VEC_MARK_DIRTY(out, 0, found);
+
+    return found;
 }
 
 size_t le_vec_replace_all(struct le_vec *v, LE_VEC_TYPE old_el, LE_VEC_TYPE new_el) {
@@ -327,6 +700,8 @@ size_t le_vec_replace_all(struct le_vec *v, LE_VEC_TYPE old_el, LE_VEC_TYPE new_
 }
 
 size_t le_vec_replace_n(struct le_vec *v, LE_VEC_TYPE old_el, LE_VEC_TYPE new_el, size_t n) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_REPLACE);
+
     if (old_el == new_el || n == 0) {
         return 0;
     }
@@ -347,6 +722,8 @@ size_t le_vec_replace_n(struct le_vec *v, LE_VEC_TYPE old_el, LE_VEC_TYPE new_el
 }
 
 size_t le_vec_rreplace_n(struct le_vec *v, LE_VEC_TYPE old_el, LE_VEC_TYPE new_el, size_t n) {
+    LE_VEC_STATS_CALL(v, LE_VEC_OP_REPLACE);
+
     if (old_el == new_el || n == 0) {
         return 0;
     }
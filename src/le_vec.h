@@ -18,6 +18,8 @@ struct le_vec;
 struct le_vec *le_vec_init(void);
 // Creates and initiates le_vec with requested length
 struct le_vec *le_vec_init_with_length(size_t request);
+// Creates and initiates empty le_vec with room for `capacity` elements (0 - default capacity)
+struct le_vec *le_vec_init_with_capacity(size_t capacity);
 // Destroys le_vec.
 void le_vec_destroy(struct le_vec *v);
 
@@ -45,20 +47,61 @@ LE_VEC_TYPE le_vec_get_at(struct le_vec const *v, size_t index);
 // Sets element at index to a new value.
 bool le_vec_set_at(struct le_vec *v, size_t index, LE_VEC_TYPE value);
 
-// Changes the length of vector. If vector is shrank, data might get lost
+// Changes the length of vector. If vector is shrank, data might get lost, new elements are not initialized
 void le_vec_resize(struct le_vec *v, size_t new_length);
+// Same as `resize()`, but never gives memory back, for growing before new elements get overwritten
+void le_vec_resize_uninit(struct le_vec *v, size_t new_length);
+// Same as `resize()`, but new elements are set to value (big growth with 0 gets fresh zero pages instead of stores)
+void le_vec_resize_fill(struct le_vec *v, size_t new_length, LE_VEC_TYPE value);
+// Sets elements to start, start + step, start + 2 * step, ... (values wrap around on overflow)
+void le_vec_iota(struct le_vec *v, LE_VEC_TYPE start, LE_VEC_TYPE step);
 
 // Adds all elements of `other` after the end of v
 void le_vec_extend(struct le_vec *v, struct le_vec const *other);
 
+// Inserts value before element at index (index == length appends)
+// Returns false if index is out of range
+bool le_vec_insert_at(struct le_vec *v, size_t index, LE_VEC_TYPE value);
+// Inserts `n` copies of value before element at index (index == length appends)
+// Returns false if index is out of range
+bool le_vec_insert_n_at(struct le_vec *v, size_t index, LE_VEC_TYPE value, size_t n);
+// Removes [start; end) elements
+// Returns false if something is wrong with indexes
+bool le_vec_erase_range(struct le_vec *v, size_t start, size_t end);
+// Removes all elements equal to value in a single pass, keeps order of the rest
+// Returns number of removed elements
+size_t le_vec_remove_value(struct le_vec *v, LE_VEC_TYPE value);
+// Removes all elements for which `pred()` is true in a single pass, keeps order of the rest
+// Returns number of removed elements
+size_t le_vec_remove_if(struct le_vec *v, bool (*pred)(LE_VEC_TYPE));
+
 // Creates a new vector, where each element is a result of `f()` on corresponding `v` element
 struct le_vec *le_vec_map(struct le_vec const *v, LE_VEC_TYPE (*f)(LE_VEC_TYPE));
 // Same as `map()`, but does so in-place.
 void le_vec_for_each(struct le_vec *v, LE_VEC_TYPE (*f)(LE_VEC_TYPE));
 
+// Replaces each element with sum of elements up to and including it (sums wrap around on overflow)
+void le_vec_inclusive_scan(struct le_vec *v);
+// Creates a vector of sums of `v` elements up to and including corresponding one
+struct le_vec *le_vec_inclusive_scanned(struct le_vec const *v);
+// Replaces each element with sum of elements before it, first element becomes 0
+void le_vec_exclusive_scan(struct le_vec *v);
+// Creates a vector of sums of `v` elements before corresponding one
+struct le_vec *le_vec_exclusive_scanned(struct le_vec const *v);
+// Same as `inclusive_scan()`, but combines elements with `op()`, which must be associative
+void le_vec_scan(struct le_vec *v, LE_VEC_TYPE (*op)(LE_VEC_TYPE, LE_VEC_TYPE));
+// Same as `inclusive_scanned()`, but combines elements with `op()`, which must be associative
+struct le_vec *le_vec_scanned(struct le_vec const *v, LE_VEC_TYPE (*op)(LE_VEC_TYPE, LE_VEC_TYPE));
+
 // Creates a copy of vector
 struct le_vec *le_vec_copy(struct le_vec const *v);
 
+// Checks if vectors have the same length and elements
+bool le_vec_equal(struct le_vec const *a, struct le_vec const *b);
+// Compares vectors lexicographically (a vector is less than its extensions)
+// Returns -1 if a < b, 0 if a equals b, 1 if a > b
+int le_vec_compare(struct le_vec const *a, struct le_vec const *b);
+
 // Creates a reversed copy of vector
 struct le_vec *le_vec_reversed(struct le_vec const *v);
 // Reverses vector in-place
@@ -68,6 +111,15 @@ void le_vec_reverse(struct le_vec *v);
 // Returns NULL if something is wrong with indexes
 struct le_vec *le_vec_slice(struct le_vec const *v, size_t start, size_t end);
 
+// Sets dst to elements of src at given indexes: dst[i] = src[indexes[i]]
+// Returns false (dst is not changed) if some index is out of range or dst is src or indexes
+bool le_vec_gather(struct le_vec *dst, struct le_vec const *src, struct le_vec const *indexes);
+// Writes elements of src to dst at given indexes: dst[indexes[i]] = src[i]
+// If an index repeats, any of its values might land (big vectors are scattered by several threads)
+// Returns false (dst is not changed) if lengths of indexes and src differ, some index is out of range
+// or dst is src or indexes
+bool le_vec_scatter(struct le_vec *dst, struct le_vec const *indexes, struct le_vec const *src);
+
 // Returns number of elements with specified value
 size_t le_vec_count(struct le_vec const *v, LE_VEC_TYPE value);
 // Returns index of first elem entry
@@ -82,6 +134,12 @@ size_t le_vec_rfind(struct le_vec const *v, LE_VEC_TYPE elem);
 // Returns index of `n`th elem entry from end
 // Returns invalid index if not found
 size_t le_vec_rfind_n(struct le_vec const *v, LE_VEC_TYPE elem, size_t n);
+// Writes indexes of all elem entries in ascending order to out, replacing its contents, out must not be v
+// Indexes are stored as LE_VEC_TYPE (as for gather), so v must be shorter than its maximum value
+// Returns number of found entries
+size_t le_vec_find_all(struct le_vec const *v, LE_VEC_TYPE elem, struct le_vec *out);
+// Same as `find_all()`, but finds elements for which `pred()` is true
+size_t le_vec_find_all_if(struct le_vec const *v, bool (*pred)(LE_VEC_TYPE), struct le_vec *out);
 
 // Replaces all `old_el`s with `new_el`
 size_t le_vec_replace_all(struct le_vec *v, LE_VEC_TYPE old_el, LE_VEC_TYPE new_el);
@@ -89,3 +147,14 @@ size_t le_vec_replace_all(struct le_vec *v, LE_VEC_TYPE old_el, LE_VEC_TYPE new_
 size_t le_vec_replace_n(struct le_vec *v, LE_VEC_TYPE old_el, LE_VEC_TYPE new_el, size_t n);
 // Replaces first n (or less, if there are no so many) `old_el`s with `new_el` going from end to start
 size_t le_vec_rreplace_n(struct le_vec *v, LE_VEC_TYPE old_el, LE_VEC_TYPE new_el, size_t n);
+
+// Sets number of threads used by parallel algorithms on large vectors (0 - one per CPU the process may run on, default)
+void le_vec_set_thread_count(size_t count);
+// Returns number of threads used by parallel algorithms on large vectors
+size_t le_vec_get_thread_count(void);
+
+// Sets how many elements ahead gather, scatter and value counting prefetch random accesses to memory beyond L2 size
+// (0 - no prefetching, default 32)
+void le_vec_set_prefetch_distance(size_t distance);
+// Returns how many elements ahead gather, scatter and value counting prefetch their random accesses
+size_t le_vec_get_prefetch_distance(void);
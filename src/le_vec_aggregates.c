@@ -0,0 +1,313 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "le_vec.h"
+#include "le_vec_aggregates.h"
+#include "le_vec_internal.h"
+#include "le_vec_simd.h"
+
+// Number of elements summarized by a tree leaf
+#define BLOCK 64
+
+struct summary {
+    size_t count;
+    // Wraps around instead of overflowing
+    unsigned long long sum;
+    // Meaningful only if count > 0
+    LE_VEC_TYPE min;
+    LE_VEC_TYPE max;
+};
+
+// Segment tree over blocks, node 1 is the root, children of node n are 2n and 2n + 1,
+// leaves are [leaves; 2 * leaves). A stale node is recomputed when a query needs it,
+// and all ancestors of a stale node are stale too.
+struct _le_vec_aggregates {
+    // Power of two, >= number of blocks
+    size_t leaves;
+    // Length of vector when aggregates last saw it
+    size_t known_length;
+    struct summary *nodes;
+    bool *valid;
+};
+
+static struct summary summarize_scalar(LE_VEC_TYPE const *data, size_t start, size_t end) {
+    LE_VEC_TYPE min = data[start];
+    LE_VEC_TYPE max = data[start];
+    unsigned long long sum = 0;
+    for (size_t i = start; i < end; i++) {
+        LE_VEC_TYPE value = data[i];
+        sum += (unsigned long long)(long long)value;
+        min = value < min ? value : min;
+        max = value > max ? value : max;
+    }
+
+    struct summary s = {end - start, sum, min, max};
+    return s;
+}
+
+#ifdef LE_VEC_X86
+// Sums are widened to 64 bits, each half of a load is sign-extended and added separately
+LE_VEC_TARGET("avx2")
+static struct summary summarize_avx2(LE_VEC_TYPE const *data, size_t start, size_t end) {
+    __m256i sums = _mm256_setzero_si256();
+    __m256i mins = _mm256_set1_epi32(data[start]);
+    __m256i maxs = mins;
+    size_t i = start;
+
+    for (; i + 8 <= end; i += 8) {
+        __m256i x = _mm256_loadu_si256((__m256i const *)(data + i));
+        sums = _mm256_add_epi64(sums, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(x)));
+        sums = _mm256_add_epi64(sums, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(x, 1)));
+        mins = _mm256_min_epi32(mins, x);
+        maxs = _mm256_max_epi32(maxs, x);
+    }
+
+    LE_VEC_TYPE lanes[8];
+    struct summary s = {0, 0, 0, 0};
+    _mm256_storeu_si256((__m256i *)lanes, mins);
+    s.min = lanes[0];
+    for (size_t lane = 1; lane < 8; lane++) {
+        s.min = lanes[lane] < s.min ? lanes[lane] : s.min;
+    }
+    _mm256_storeu_si256((__m256i *)lanes, maxs);
+    s.max = lanes[0];
+    for (size_t lane = 1; lane < 8; lane++) {
+        s.max = lanes[lane] > s.max ? lanes[lane] : s.max;
+    }
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+    s.sum = (unsigned long long)_mm_cvtsi128_si64(half) + (unsigned long long)_mm_extract_epi64(half, 1);
+    s.count = i - start;
+
+    if (i < end) {
+        struct summary tail = summarize_scalar(data, i, end);
+        s.count += tail.count;
+        s.sum += tail.sum;
+        s.min = tail.min < s.min ? tail.min : s.min;
+        s.max = tail.max > s.max ? tail.max : s.max;
+    }
+
+    return s;
+}
+#endif
+
+static struct summary summarize(LE_VEC_TYPE const *data, size_t start, size_t end) {
+    if (end <= start) {
+        struct summary empty = {0, 0, 0, 0};
+        return empty;
+    }
+
+#ifdef LE_VEC_X86
+    if (sizeof(LE_VEC_TYPE) == 4 && end - start >= 8 && LE_VEC_CPU_SUPPORTS("avx2")) {
+        return summarize_avx2(data, start, end);
+    }
+#endif
+    return summarize_scalar(data, start, end);
+}
+
+static struct summary combine(struct summary a, struct summary b) {
+    if (a.count == 0) {
+        return b;
+    }
+    if (b.count == 0) {
+        return a;
+    }
+
+    struct summary s = {a.count + b.count, a.sum + b.sum, a.min < b.min ? a.min : b.min, a.max > b.max ? a.max : b.max};
+    return s;
+}
+
+// Makes room for `blocks` leaves, all nodes become stale.
+static void expand_leaves(struct _le_vec_aggregates *a, size_t blocks) {
+    size_t leaves = a->leaves;
+    while (leaves < blocks) {
+        leaves *= 2;
+    }
+
+    a->nodes = realloc(a->nodes, 2 * leaves * sizeof(struct summary));
+    a->valid = realloc(a->valid, 2 * leaves * sizeof(bool));
+    memset(a->valid, 0, 2 * leaves * sizeof(bool));
+    a->leaves = leaves;
+}
+
+static size_t blocks_of(size_t length) {
+    return (length + BLOCK - 1) / BLOCK;
+}
+
+// Marks leaves of blocks [first; last] and their ancestors stale.
+static void invalidate_blocks(struct _le_vec_aggregates *a, size_t first, size_t last) {
+    if (last >= a->leaves) {
+        expand_leaves(a, last + 1);
+        return;
+    }
+
+    for (size_t block = first; block <= last; block++) {
+        // Stops at the first stale node, everything above it is stale already
+        for (size_t node = a->leaves + block; node >= 1 && a->valid[node]; node /= 2) {
+            a->valid[node] = false;
+        }
+    }
+}
+
+void _le_vec_invalidate_aggregates(struct le_vec *v, size_t start, size_t end) {
+    if (start < end) {
+        invalidate_blocks(v->aggregates, start / BLOCK, (end - 1) / BLOCK);
+    }
+}
+
+void le_vec_track_aggregates(struct le_vec *v, bool enabled) {
+    if (!enabled) {
+        if (v->aggregates != NULL) {
+            free(v->aggregates->nodes);
+            free(v->aggregates->valid);
+            free(v->aggregates);
+            v->aggregates = NULL;
+        }
+        return;
+    }
+
+    if (v->aggregates != NULL) {
+        return;
+    }
+
+    struct _le_vec_aggregates *a = malloc(sizeof(struct _le_vec_aggregates));
+    a->leaves = 1;
+    a->known_length = le_vec_get_length(v);
+    a->nodes = NULL;
+    a->valid = NULL;
+    expand_leaves(a, blocks_of(a->known_length));
+
+    v->aggregates = a;
+}
+
+bool le_vec_is_tracking_aggregates(struct le_vec const *v) {
+    return v->aggregates != NULL;
+}
+
+// Elements removed from the end are not reported, so blocks between the old and the new end are dropped here.
+static void sync_length(struct le_vec *v) {
+    struct _le_vec_aggregates *a = v->aggregates;
+    size_t length = le_vec_get_length(v);
+    if (length == a->known_length) {
+        return;
+    }
+
+    size_t shorter = length < a->known_length ? length : a->known_length;
+    size_t longer = length < a->known_length ? a->known_length : length;
+    invalidate_blocks(a, shorter / BLOCK, blocks_of(longer) - 1);
+    a->known_length = length;
+}
+
+static struct summary refresh(struct le_vec const *v, size_t node) {
+    struct _le_vec_aggregates *a = v->aggregates;
+    if (a->valid[node]) {
+        return a->nodes[node];
+    }
+
+    if (node >= a->leaves) {
+        size_t start = (node - a->leaves) * BLOCK;
+        size_t end = start + BLOCK;
+        size_t length = le_vec_get_length(v);
+        a->nodes[node] = summarize(v->data, start, end < length ? end : length);
+    } else {
+        a->nodes[node] = combine(refresh(v, 2 * node), refresh(v, 2 * node + 1));
+    }
+
+    a->valid[node] = true;
+    return a->nodes[node];
+}
+
+// Combines leaves [first; last) bottom-up, taking the fewest nodes covering them.
+static struct summary query_blocks(struct le_vec const *v, size_t first, size_t last) {
+    struct summary s = {0, 0, 0, 0};
+    size_t l = first + v->aggregates->leaves;
+    size_t r = last + v->aggregates->leaves;
+
+    while (l < r) {
+        if (l & 1) {
+            s = combine(s, refresh(v, l++));
+        }
+        if (r & 1) {
+            s = combine(s, refresh(v, --r));
+        }
+        l /= 2;
+        r /= 2;
+    }
+
+    return s;
+}
+
+static struct summary query(struct le_vec *v, size_t start, size_t end) {
+    if (v->aggregates == NULL) {
+        return summarize(v->data, start, end);
+    }
+
+    sync_length(v);
+    if (start == 0 && end == le_vec_get_length(v)) {
+        return refresh(v, 1);
+    }
+
+    // Partial blocks at the ends are summarized directly, whole ones in between come from the tree
+    size_t first = (start + BLOCK - 1) / BLOCK;
+    size_t last = end / BLOCK;
+    if (first >= last) {
+        return summarize(v->data, start, end);
+    }
+
+    struct summary s = summarize(v->data, start, first * BLOCK);
+    s = combine(s, query_blocks(v, first, last));
+    return combine(s, summarize(v->data, last * BLOCK, end));
+}
+
+static bool is_range_valid(struct le_vec const *v, size_t start, size_t end) {
+    return start <= end && end <= le_vec_get_length(v);
+}
+
+static void set_success(bool *success, bool value) {
+    if (success != NULL) {
+        *success = value;
+    }
+}
+
+long long le_vec_sum(struct le_vec *v) {
+    return (long long)query(v, 0, le_vec_get_length(v)).sum;
+}
+
+LE_VEC_TYPE le_vec_min(struct le_vec *v, bool *success) {
+    return le_vec_range_min(v, 0, le_vec_get_length(v), success);
+}
+
+LE_VEC_TYPE le_vec_max(struct le_vec *v, bool *success) {
+    return le_vec_range_max(v, 0, le_vec_get_length(v), success);
+}
+
+long long le_vec_range_sum(struct le_vec *v, size_t start, size_t end, bool *success) {
+    if (!is_range_valid(v, start, end)) {
+        set_success(success, false);
+        return 0;
+    }
+
+    set_success(success, true);
+    return (long long)query(v, start, end).sum;
+}
+
+LE_VEC_TYPE le_vec_range_min(struct le_vec *v, size_t start, size_t end, bool *success) {
+    if (!is_range_valid(v, start, end) || start == end) {
+        set_success(success, false);
+        return (LE_VEC_TYPE)0;
+    }
+
+    set_success(success, true);
+    return query(v, start, end).min;
+}
+
+LE_VEC_TYPE le_vec_range_max(struct le_vec *v, size_t start, size_t end, bool *success) {
+    if (!is_range_valid(v, start, end) || start == end) {
+        set_success(success, false);
+        return (LE_VEC_TYPE)0;
+    }
+
+    set_success(success, true);
+    return query(v, start, end).max;
+}
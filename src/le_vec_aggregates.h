@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+
+// Sum, minimum and maximum of vectors and their ranges.
+// Without tracking every query scans elements. With le_vec_track_aggregates() the vector keeps
+// a tree of summaries of 64-element blocks: modifications only mark their blocks stale (O(1) per block),
+// queries recompute stale blocks they need and answer in O(log n) plus two partial blocks.
+
+// Starts or stops keeping aggregates of vector up to date (off by default)
+void le_vec_track_aggregates(struct le_vec *v, bool enabled);
+// Checks if aggregates of vector are kept
+bool le_vec_is_tracking_aggregates(struct le_vec const *v);
+
+// Returns sum of elements, 0 for empty vector (sum wraps around on overflow of long long)
+long long le_vec_sum(struct le_vec *v);
+// Returns the smallest element
+// If vector is empty - success = false (success might be NULL)
+LE_VEC_TYPE le_vec_min(struct le_vec *v, bool *success);
+// Returns the largest element
+// If vector is empty - success = false (success might be NULL)
+LE_VEC_TYPE le_vec_max(struct le_vec *v, bool *success);
+
+// Returns sum of [start; end) elements
+// If something is wrong with indexes - success = false and 0 is returned (success might be NULL)
+long long le_vec_range_sum(struct le_vec *v, size_t start, size_t end, bool *success);
+// Returns the smallest of [start; end) elements
+// If range is empty or something is wrong with indexes - success = false (success might be NULL)
+LE_VEC_TYPE le_vec_range_min(struct le_vec *v, size_t start, size_t end, bool *success);
+// Returns the largest of [start; end) elements
+// If range is empty or something is wrong with indexes - success = false (success might be NULL)
+LE_VEC_TYPE le_vec_range_max(struct le_vec *v, size_t start, size_t end, bool *success);
@@ -0,0 +1,348 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "le_vec_bool.h"
+#include "le_vec_simd.h"
+
+#define WORD_BITS 64
+
+// Element i is bit (i % 64) of word (i / 64).
+// Bits past length are always kept zero, so whole words can be counted and compared.
+struct le_vec_bool {
+    size_t capacity;
+    size_t length;
+    uint64_t *words;
+};
+
+static size_t words_for(size_t bits) {
+    return (bits + WORD_BITS - 1) / WORD_BITS;
+}
+
+// Mask of valid bits in word `word` of a vector with `length` elements.
+static uint64_t valid_mask(size_t length, size_t word) {
+    size_t bits = length - word * WORD_BITS;
+    return bits >= WORD_BITS ? UINT64_MAX : (((uint64_t)1 << bits) - 1);
+}
+
+// Returns word with ones at positions of elements equal to value.
+static uint64_t matching(struct le_vec_bool const *b, size_t word, bool value) {
+    uint64_t w = b->words[word];
+    return value ? w : ~w & valid_mask(b->length, word);
+}
+
+static void expand_to_request(struct le_vec_bool *b, size_t request) {
+    size_t capacity = b->capacity;
+    if (capacity >= request) {
+        return;
+    }
+
+    while (capacity < request) {
+        capacity *= 2;
+    }
+
+    size_t old_words = words_for(b->capacity);
+    size_t new_words = words_for(capacity);
+
+    b->words = realloc(b->words, new_words * sizeof(uint64_t));
+    memset(b->words + old_words, 0, (new_words - old_words) * sizeof(uint64_t));
+    b->capacity = capacity;
+}
+
+// Zeroes bits [length; capacity) so that the invariant holds after shrinking.
+static void clear_tail(struct le_vec_bool *b, size_t old_length) {
+    size_t first = b->length / WORD_BITS;
+    size_t last = words_for(old_length);
+
+    if (first >= last) {
+        return;
+    }
+
+    b->words[first] &= valid_mask(b->length, first);
+    memset(b->words + first + 1, 0, (last - first - 1) * sizeof(uint64_t));
+}
+
+static LE_VEC_ALWAYS_INLINE size_t count_ones_body(uint64_t const *words, size_t length) {
+    size_t cntr = 0;
+    for (size_t i = 0; i < length; i++) {
+        cntr += __builtin_popcountll(words[i]);
+    }
+
+    return cntr;
+}
+
+// Returns position of `n`th (1-based) set bit of w. w must have at least n set bits.
+static unsigned select_bit(uint64_t w, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        w &= w - 1;
+    }
+
+    return __builtin_ctzll(w);
+}
+
+static size_t count_ones_generic(uint64_t const *words, size_t length) {
+    return count_ones_body(words, length);
+}
+
+static size_t find_n_generic(struct le_vec_bool const *b, bool elem, size_t n) {
+    size_t words = words_for(b->length);
+
+    for (size_t i = 0; i < words; i++) {
+        uint64_t w = matching(b, i, elem);
+        size_t ones = __builtin_popcountll(w);
+        if (n <= ones) {
+            return i * WORD_BITS + select_bit(w, n);
+        }
+        n -= ones;
+    }
+
+    return (size_t)-1;
+}
+
+#ifdef LE_VEC_X86
+LE_VEC_TARGET("popcnt")
+static size_t count_ones_popcnt(uint64_t const *words, size_t length) {
+    return count_ones_body(words, length);
+}
+
+// pdep deposits the n-th set bit alone, tzcnt then gives its position
+LE_VEC_TARGET("popcnt,bmi,bmi2")
+static size_t find_n_bmi2(struct le_vec_bool const *b, bool elem, size_t n) {
+    size_t words = words_for(b->length);
+
+    for (size_t i = 0; i < words; i++) {
+        uint64_t w = matching(b, i, elem);
+        size_t ones = _mm_popcnt_u64(w);
+        if (n <= ones) {
+            return i * WORD_BITS + _tzcnt_u64(_pdep_u64((uint64_t)1 << (n - 1), w));
+        }
+        n -= ones;
+    }
+
+    return (size_t)-1;
+}
+#endif
+
+static size_t count_ones(uint64_t const *words, size_t length) {
+#ifdef LE_VEC_X86
+    if (LE_VEC_CPU_SUPPORTS("popcnt")) {
+        return count_ones_popcnt(words, length);
+    }
+#endif
+    return count_ones_generic(words, length);
+}
+
+struct le_vec_bool *le_vec_bool_init(void) {
+    struct le_vec_bool *b = malloc(sizeof(struct le_vec_bool));
+
+    b->capacity = LE_VEC_BOOL_DEFAULT_CAPACITY;
+    b->length = 0;
+    b->words = calloc(words_for(LE_VEC_BOOL_DEFAULT_CAPACITY), sizeof(uint64_t));
+
+    return b;
+}
+
+struct le_vec_bool *le_vec_bool_init_with_length(size_t request) {
+    struct le_vec_bool *b = le_vec_bool_init();
+    le_vec_bool_resize(b, request);
+
+    return b;
+}
+
+void le_vec_bool_destroy(struct le_vec_bool *b) {
+    if (b == NULL) {
+        return;
+    }
+
+    free(b->words);
+    b->words = NULL;
+    free(b);
+}
+
+size_t le_vec_bool_get_length(struct le_vec_bool const *b) {
+    return b->length;
+}
+
+size_t le_vec_bool_get_capacity(struct le_vec_bool const *b) {
+    return b->capacity;
+}
+
+bool le_vec_bool_is_empty(struct le_vec_bool const *b) {
+    return b->length == 0;
+}
+
+void le_vec_bool_push_back(struct le_vec_bool *b, bool value) {
+    expand_to_request(b, b->length + 1);
+
+    size_t index = b->length;
+    b->words[index / WORD_BITS] |= (uint64_t)value << (index % WORD_BITS);
+    b->length++;
+}
+
+bool le_vec_bool_pop_back(struct le_vec_bool *b) {
+    size_t index = b->length - 1;
+    uint64_t bit = (uint64_t)1 << (index % WORD_BITS);
+    bool value = (b->words[index / WORD_BITS] & bit) != 0;
+
+    b->words[index / WORD_BITS] &= ~bit;
+    b->length--;
+
+    return value;
+}
+
+bool le_vec_bool_get_at(struct le_vec_bool const *b, size_t index) {
+    return (b->words[index / WORD_BITS] >> (index % WORD_BITS)) & 1;
+}
+
+bool le_vec_bool_set_at(struct le_vec_bool *b, size_t index, bool value) {
+    if (index >= b->length) {
+        return false;
+    }
+
+    uint64_t bit = (uint64_t)1 << (index % WORD_BITS);
+    uint64_t *word = &b->words[index / WORD_BITS];
+    *word = value ? (*word | bit) : (*word & ~bit);
+
+    return true;
+}
+
+void le_vec_bool_resize(struct le_vec_bool *b, size_t new_length) {
+    size_t old_length = b->length;
+
+    expand_to_request(b, new_length);
+    b->length = new_length;
+
+    if (new_length < old_length) {
+        clear_tail(b, old_length);
+    }
+}
+
+static uint64_t reverse_word(uint64_t w) {
+    w = ((w >> 1) & 0x5555555555555555ull) | ((w & 0x5555555555555555ull) << 1);
+    w = ((w >> 2) & 0x3333333333333333ull) | ((w & 0x3333333333333333ull) << 2);
+    w = ((w >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((w & 0x0F0F0F0F0F0F0F0Full) << 4);
+    return __builtin_bswap64(w);
+}
+
+void le_vec_bool_reverse(struct le_vec_bool *b) {
+    size_t words = words_for(b->length);
+    if (words == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < words / 2; i++) {
+        uint64_t l = reverse_word(b->words[i]);
+        b->words[i] = reverse_word(b->words[words - 1 - i]);
+        b->words[words - 1 - i] = l;
+    }
+    if (words % 2 == 1) {
+        b->words[words / 2] = reverse_word(b->words[words / 2]);
+    }
+
+    // Zero tail bits are now at the start, shift them out
+    unsigned pad = words * WORD_BITS - b->length;
+    if (pad == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i + 1 < words; i++) {
+        b->words[i] = (b->words[i] >> pad) | (b->words[i + 1] << (WORD_BITS - pad));
+    }
+    b->words[words - 1] >>= pad;
+}
+
+size_t le_vec_bool_count(struct le_vec_bool const *b, bool value) {
+    size_t ones = count_ones(b->words, words_for(b->length));
+    return value ? ones : b->length - ones;
+}
+
+size_t le_vec_bool_find(struct le_vec_bool const *b, bool elem) {
+    size_t words = words_for(b->length);
+
+    for (size_t i = 0; i < words; i++) {
+        uint64_t w = matching(b, i, elem);
+        if (w != 0) {
+            return i * WORD_BITS + __builtin_ctzll(w);
+        }
+    }
+
+    return (size_t)-1;
+}
+
+size_t le_vec_bool_find_n(struct le_vec_bool const *b, bool elem, size_t n) {
+    if (n == 0) {
+        return (size_t)-1;
+    }
+
+#ifdef LE_VEC_X86
+    if (LE_VEC_CPU_SUPPORTS("popcnt") && LE_VEC_CPU_SUPPORTS("bmi2")) {
+        return find_n_bmi2(b, elem, n);
+    }
+#endif
+    return find_n_generic(b, elem, n);
+}
+
+size_t le_vec_bool_rfind(struct le_vec_bool const *b, bool elem) {
+    for (size_t i = words_for(b->length); i > 0; i--) {
+        uint64_t w = matching(b, i - 1, elem);
+        if (w != 0) {
+            return (i - 1) * WORD_BITS + (WORD_BITS - 1 - __builtin_clzll(w));
+        }
+    }
+
+    return (size_t)-1;
+}
+
+bool le_vec_bool_and(struct le_vec_bool *dest, struct le_vec_bool const *other) {
+    if (dest->length != other->length) {
+        return false;
+    }
+
+    size_t words = words_for(dest->length);
+    for (size_t i = 0; i < words; i++) {
+        dest->words[i] &= other->words[i];
+    }
+
+    return true;
+}
+
+bool le_vec_bool_or(struct le_vec_bool *dest, struct le_vec_bool const *other) {
+    if (dest->length != other->length) {
+        return false;
+    }
+
+    size_t words = words_for(dest->length);
+    for (size_t i = 0; i < words; i++) {
+        dest->words[i] |= other->words[i];
+    }
+
+    return true;
+}
+
+bool le_vec_bool_xor(struct le_vec_bool *dest, struct le_vec_bool const *other) {
+    if (dest->length != other->length) {
+        return false;
+    }
+
+    size_t words = words_for(dest->length);
+    for (size_t i = 0; i < words; i++) {
+        dest->words[i] ^= other->words[i];
+    }
+
+    return true;
+}
+
+bool le_vec_bool_andnot(struct le_vec_bool *dest, struct le_vec_bool const *other) {
+    if (dest->length != other->length) {
+        return false;
+    }
+
+    size_t words = words_for(dest->length);
+    for (size_t i = 0; i < words; i++) {
+        dest->words[i] &= ~other->words[i];
+    }
+
+    return true;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Default vector capacity in bits
+#define LE_VEC_BOOL_DEFAULT_CAPACITY 256
+
+// Bit-packed vector of booleans
+// Stores 64 elements per machine word, so counting and searching process 64 elements at once.
+struct le_vec_bool;
+
+// Creates and initiates le_vec_bool
+struct le_vec_bool *le_vec_bool_init(void);
+// Creates and initiates le_vec_bool with requested length, all elements are false
+struct le_vec_bool *le_vec_bool_init_with_length(size_t request);
+// Destroys le_vec_bool.
+void le_vec_bool_destroy(struct le_vec_bool *b);
+
+// Returns vector length
+size_t le_vec_bool_get_length(struct le_vec_bool const *b);
+// Returns vector capacity (available space)
+size_t le_vec_bool_get_capacity(struct le_vec_bool const *b);
+// Checks if vector empty (does not contain any elements)
+bool le_vec_bool_is_empty(struct le_vec_bool const *b);
+
+// Pushes element after the last element, increments length
+void le_vec_bool_push_back(struct le_vec_bool *b, bool value);
+// Removes and returns element the last element, decrements length
+bool le_vec_bool_pop_back(struct le_vec_bool *b);
+
+// Gets element at index.
+bool le_vec_bool_get_at(struct le_vec_bool const *b, size_t index);
+// Sets element at index to a new value.
+bool le_vec_bool_set_at(struct le_vec_bool *b, size_t index, bool value);
+
+// Changes the length of vector. New elements are false
+void le_vec_bool_resize(struct le_vec_bool *b, size_t new_length);
+
+// Reverses vector in-place
+void le_vec_bool_reverse(struct le_vec_bool *b);
+
+// Returns number of elements with specified value
+size_t le_vec_bool_count(struct le_vec_bool const *b, bool value);
+// Returns index of first elem entry
+// Returns invalid index if not found
+size_t le_vec_bool_find(struct le_vec_bool const *b, bool elem);
+// Returns index of `n`th elem entry
+// Returns invalid index if not found
+size_t le_vec_bool_find_n(struct le_vec_bool const *b, bool elem, size_t n);
+// Returns index of first elem entry from end
+// Returns invalid index if not found
+size_t le_vec_bool_rfind(struct le_vec_bool const *b, bool elem);
+
+// dest = dest & other. Returns false if lengths differ
+bool le_vec_bool_and(struct le_vec_bool *dest, struct le_vec_bool const *other);
+// dest = dest | other. Returns false if lengths differ
+bool le_vec_bool_or(struct le_vec_bool *dest, struct le_vec_bool const *other);
+// dest = dest ^ other. Returns false if lengths differ
+bool le_vec_bool_xor(struct le_vec_bool *dest, struct le_vec_bool const *other);
+// dest = dest & ~other. Returns false if lengths differ
+bool le_vec_bool_andnot(struct le_vec_bool *dest, struct le_vec_bool const *other);
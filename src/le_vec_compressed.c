@@ -0,0 +1,365 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_compressed.h"
+
+// Values are packed "vertically" into 4 lanes: element i goes to lane (i % 4),
+// where it takes slot (i / 4). Each lane is a stream of `width`-bit values spread over
+// every 4th 32-bit word, so a block of 128 values takes exactly 4 * width words
+// and one SSE register unpacks 4 values at once with the very same shifts.
+#define LANES 4
+#define SLOTS (LE_VEC_COMPRESSED_BLOCK_LENGTH / LANES)
+
+enum block_mode {
+    // value = base + packed
+    BLOCK_MODE_FOR,
+    // value = previous value in the same lane + packed (base for the first 4 values)
+    BLOCK_MODE_DELTA,
+};
+
+struct block {
+    // Offset of the first packed word in `words`
+    size_t offset;
+    int32_t base;
+    uint8_t width;
+    uint8_t mode;
+};
+
+struct le_vec_compressed {
+    size_t length;
+    size_t blocks_length;
+    struct block *blocks;
+    size_t words_length;
+    uint32_t *words;
+};
+
+static unsigned bit_width(uint32_t value) {
+    return value == 0 ? 0 : 32 - __builtin_clz(value);
+}
+
+static uint32_t width_mask(unsigned width) {
+    return width == 32 ? UINT32_MAX : (((uint32_t)1 << width) - 1);
+}
+
+// Copies block values into `out`, padding it with last value up to a whole block.
+static void load_block(int32_t *out, LE_VEC_TYPE const *values, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        out[i] = values[i];
+    }
+    for (size_t i = length; i < LE_VEC_COMPRESSED_BLOCK_LENGTH; i++) {
+        out[i] = values[length - 1];
+    }
+}
+
+// Picks encoding for the block and writes what is going to be packed into `packed`.
+static void encode_block(struct block *b, uint32_t *packed, int32_t const *values) {
+    int32_t min = values[0];
+    for (size_t i = 1; i < LE_VEC_COMPRESSED_BLOCK_LENGTH; i++) {
+        min = values[i] < min ? values[i] : min;
+    }
+
+    int32_t delta_base = values[0];
+    for (size_t i = 1; i < LANES; i++) {
+        delta_base = values[i] < delta_base ? values[i] : delta_base;
+    }
+
+    // OR of all values has the same bit width as their maximum
+    uint32_t for_bits = 0;
+    uint32_t delta_bits = 0;
+    for (size_t i = 0; i < LE_VEC_COMPRESSED_BLOCK_LENGTH; i++) {
+        uint32_t previous = i < LANES ? (uint32_t)delta_base : (uint32_t)values[i - LANES];
+        for_bits |= (uint32_t)values[i] - (uint32_t)min;
+        delta_bits |= (uint32_t)values[i] - previous;
+    }
+
+    unsigned for_width = bit_width(for_bits);
+    unsigned delta_width = bit_width(delta_bits);
+
+    if (delta_width < for_width) {
+        b->mode = BLOCK_MODE_DELTA;
+        b->base = delta_base;
+        b->width = delta_width;
+        for (size_t i = 0; i < LE_VEC_COMPRESSED_BLOCK_LENGTH; i++) {
+            uint32_t previous = i < LANES ? (uint32_t)delta_base : (uint32_t)values[i - LANES];
+            packed[i] = (uint32_t)values[i] - previous;
+        }
+    } else {
+        b->mode = BLOCK_MODE_FOR;
+        b->base = min;
+        b->width = for_width;
+        for (size_t i = 0; i < LE_VEC_COMPRESSED_BLOCK_LENGTH; i++) {
+            packed[i] = (uint32_t)values[i] - (uint32_t)min;
+        }
+    }
+}
+
+static void pack_block(uint32_t *words, uint32_t const *packed, unsigned width) {
+    if (width == 0) {
+        return;
+    }
+
+    for (size_t i = 0; i < LE_VEC_COMPRESSED_BLOCK_LENGTH; i++) {
+        size_t lane = i % LANES;
+        size_t bit = (i / LANES) * width;
+        size_t word = bit / 32;
+        unsigned shift = bit % 32;
+
+        words[word * LANES + lane] |= packed[i] << shift;
+        if (shift + width > 32) {
+            words[(word + 1) * LANES + lane] |= packed[i] >> (32 - shift);
+        }
+    }
+}
+
+static uint32_t unpack_one(uint32_t const *words, unsigned width, size_t lane, size_t slot) {
+    if (width == 0) {
+        return 0;
+    }
+
+    size_t bit = slot * width;
+    size_t word = bit / 32;
+    unsigned shift = bit % 32;
+
+    uint32_t value = words[word * LANES + lane] >> shift;
+    if (shift + width > 32) {
+        value |= words[(word + 1) * LANES + lane] << (32 - shift);
+    }
+
+    return value & width_mask(width);
+}
+
+// Decodes first `slots` slots (4 values each) of the block into `out`.
+static void unpack_slots(int32_t *out, struct le_vec_compressed const *c, struct block const *b, size_t slots) {
+    uint32_t const *words = c->words + b->offset;
+    unsigned width = b->width;
+
+#if defined(__SSE2__)
+    __m128i mask = _mm_set1_epi32((int32_t)width_mask(width));
+    __m128i acc = _mm_set1_epi32(b->base);
+
+    for (size_t slot = 0; slot < slots; slot++) {
+        __m128i value = _mm_setzero_si128();
+        if (width != 0) {
+            size_t bit = slot * width;
+            size_t word = bit / 32;
+            unsigned shift = bit % 32;
+
+            __m128i lo = _mm_loadu_si128((__m128i const *)(words + word * LANES));
+            value = _mm_srl_epi32(lo, _mm_cvtsi32_si128(shift));
+            if (shift + width > 32) {
+                __m128i hi = _mm_loadu_si128((__m128i const *)(words + (word + 1) * LANES));
+                value = _mm_or_si128(value, _mm_sll_epi32(hi, _mm_cvtsi32_si128(32 - shift)));
+            }
+            value = _mm_and_si128(value, mask);
+        }
+
+        if (b->mode == BLOCK_MODE_DELTA) {
+            acc = _mm_add_epi32(acc, value);
+            _mm_storeu_si128((__m128i *)(out + slot * LANES), acc);
+        } else {
+            _mm_storeu_si128((__m128i *)(out + slot * LANES), _mm_add_epi32(acc, value));
+        }
+    }
+#else
+    uint32_t acc[LANES] = {(uint32_t)b->base, (uint32_t)b->base, (uint32_t)b->base, (uint32_t)b->base};
+
+    for (size_t slot = 0; slot < slots; slot++) {
+        for (size_t lane = 0; lane < LANES; lane++) {
+            uint32_t value = unpack_one(words, width, lane, slot);
+            if (b->mode == BLOCK_MODE_DELTA) {
+                acc[lane] += value;
+                out[slot * LANES + lane] = (int32_t)acc[lane];
+            } else {
+                out[slot * LANES + lane] = (int32_t)(acc[lane] + value);
+            }
+        }
+    }
+#endif
+}
+
+// Decodes a whole block into `out`.
+static void unpack_block(int32_t *out, struct le_vec_compressed const *c, struct block const *b) {
+    unpack_slots(out, c, b, SLOTS);
+}
+
+// Returns number of real (not padding) elements in block.
+static size_t block_length(struct le_vec_compressed const *c, size_t block_index) {
+    size_t start = block_index * LE_VEC_COMPRESSED_BLOCK_LENGTH;
+    size_t left = c->length - start;
+    return left < LE_VEC_COMPRESSED_BLOCK_LENGTH ? left : LE_VEC_COMPRESSED_BLOCK_LENGTH;
+}
+
+struct le_vec_compressed *le_vec_compressed_init(struct le_vec const *v) {
+    struct le_vec_compressed *c = malloc(sizeof(struct le_vec_compressed));
+
+    c->length = le_vec_get_length(v);
+    c->blocks_length = (c->length + LE_VEC_COMPRESSED_BLOCK_LENGTH - 1) / LE_VEC_COMPRESSED_BLOCK_LENGTH;
+    c->blocks = malloc(c->blocks_length * sizeof(struct block));
+
+    int32_t values[LE_VEC_COMPRESSED_BLOCK_LENGTH];
+    uint32_t packed[LE_VEC_COMPRESSED_BLOCK_LENGTH];
+
+    // First pass picks encodings so that packed words are allocated only once
+    size_t words_length = 0;
+    for (size_t i = 0; i < c->blocks_length; i++) {
+        struct block *b = &c->blocks[i];
+
+        load_block(values, v->data + i * LE_VEC_COMPRESSED_BLOCK_LENGTH, block_length(c, i));
+        encode_block(b, packed, values);
+
+        b->offset = words_length;
+        words_length += (size_t)b->width * LANES;
+    }
+
+    c->words_length = words_length;
+    c->words = calloc(words_length == 0 ? 1 : words_length, sizeof(uint32_t));
+
+    for (size_t i = 0; i < c->blocks_length; i++) {
+        struct block *b = &c->blocks[i];
+
+        load_block(values, v->data + i * LE_VEC_COMPRESSED_BLOCK_LENGTH, block_length(c, i));
+        encode_block(b, packed, values);
+        pack_block(c->words + b->offset, packed, b->width);
+    }
+
+    return c;
+}
+
+void le_vec_compressed_destroy(struct le_vec_compressed *c) {
+    if (c == NULL) {
+        return;
+    }
+
+    free(c->blocks);
+    free(c->words);
+    free(c);
+}
+
+struct le_vec *le_vec_compressed_to_vec(struct le_vec_compressed const *c) {
+    struct le_vec *v = le_vec_init();
+    le_vec_resize(v, c->length);
+
+    int32_t values[LE_VEC_COMPRESSED_BLOCK_LENGTH];
+
+    for (size_t i = 0; i < c->blocks_length; i++) {
+        unpack_block(values, c, &c->blocks[i]);
+
+        LE_VEC_TYPE *dest = v->data + i * LE_VEC_COMPRESSED_BLOCK_LENGTH;
+        size_t length = block_length(c, i);
+        for (size_t j = 0; j < length; j++) {
+            dest[j] = values[j];
+        }
+    }
+
+    return v;
+}
+
+size_t le_vec_compressed_get_length(struct le_vec_compressed const *c) {
+    return c->length;
+}
+
+size_t le_vec_compressed_get_size(struct le_vec_compressed const *c) {
+    return c->blocks_length * sizeof(struct block) + c->words_length * sizeof(uint32_t);
+}
+
+double le_vec_compressed_get_ratio(struct le_vec_compressed const *c) {
+    if (c->length == 0) {
+        return 1.0;
+    }
+
+    return (double)(c->length * sizeof(LE_VEC_TYPE)) / (double)le_vec_compressed_get_size(c);
+}
+
+LE_VEC_TYPE le_vec_compressed_get_at(struct le_vec_compressed const *c, size_t index) {
+    struct block const *b = &c->blocks[index / LE_VEC_COMPRESSED_BLOCK_LENGTH];
+    uint32_t const *words = c->words + b->offset;
+
+    size_t in_block = index % LE_VEC_COMPRESSED_BLOCK_LENGTH;
+    size_t lane = in_block % LANES;
+    size_t slot = in_block / LANES;
+
+    if (b->mode == BLOCK_MODE_FOR) {
+        return (int32_t)((uint32_t)b->base + unpack_one(words, b->width, lane, slot));
+    }
+
+    int32_t values[LE_VEC_COMPRESSED_BLOCK_LENGTH];
+    unpack_slots(values, c, b, slot + 1);
+
+    return values[in_block];
+}
+
+// Checks whether value can be stored in block at all (only known for FOR blocks).
+static bool block_may_contain(struct block const *b, LE_VEC_TYPE value) {
+    if (b->mode != BLOCK_MODE_FOR) {
+        return true;
+    }
+
+    return value >= b->base && (uint32_t)value - (uint32_t)b->base <= width_mask(b->width);
+}
+
+size_t le_vec_compressed_count(struct le_vec_compressed const *c, LE_VEC_TYPE value) {
+    int32_t values[LE_VEC_COMPRESSED_BLOCK_LENGTH];
+    size_t cntr = 0;
+
+    for (size_t i = 0; i < c->blocks_length; i++) {
+        struct block const *b = &c->blocks[i];
+        if (!block_may_contain(b, value)) {
+            continue;
+        }
+
+        unpack_block(values, c, b);
+
+        size_t length = block_length(c, i);
+        for (size_t j = 0; j < length; j++) {
+            cntr += values[j] == value;
+        }
+    }
+
+    return cntr;
+}
+
+size_t le_vec_compressed_find(struct le_vec_compressed const *c, LE_VEC_TYPE elem) {
+    int32_t values[LE_VEC_COMPRESSED_BLOCK_LENGTH];
+
+    for (size_t i = 0; i < c->blocks_length; i++) {
+        struct block const *b = &c->blocks[i];
+        if (!block_may_contain(b, elem)) {
+            continue;
+        }
+
+        unpack_block(values, c, b);
+
+        size_t length = block_length(c, i);
+        for (size_t j = 0; j < length; j++) {
+            if (values[j] == elem) {
+                return i * LE_VEC_COMPRESSED_BLOCK_LENGTH + j;
+            }
+        }
+    }
+
+    return (size_t)-1;
+}
+
+long long le_vec_compressed_sum(struct le_vec_compressed const *c) {
+    int32_t values[LE_VEC_COMPRESSED_BLOCK_LENGTH];
+    long long sum = 0;
+
+    for (size_t i = 0; i < c->blocks_length; i++) {
+        unpack_block(values, c, &c->blocks[i]);
+
+        size_t length = block_length(c, i);
+        for (size_t j = 0; j < length; j++) {
+            sum += values[j];
+        }
+    }
+
+    return sum;
+}
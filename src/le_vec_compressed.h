@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+
+// Number of elements in one compressed block
+#define LE_VEC_COMPRESSED_BLOCK_LENGTH 128
+
+// Read-only compressed copy of le_vec
+// Elements are split into blocks of LE_VEC_COMPRESSED_BLOCK_LENGTH, each block is bit-packed
+// either relative to its minimum (frame of reference) or as deltas between neighbours,
+// whichever is smaller. Sorted or clustered data compresses best.
+struct le_vec_compressed;
+
+// Creates compressed copy of vector
+struct le_vec_compressed *le_vec_compressed_init(struct le_vec const *v);
+// Destroys le_vec_compressed.
+void le_vec_compressed_destroy(struct le_vec_compressed *c);
+
+// Creates a regular le_vec with all elements of compressed vector
+struct le_vec *le_vec_compressed_to_vec(struct le_vec_compressed const *c);
+
+// Returns number of elements
+size_t le_vec_compressed_get_length(struct le_vec_compressed const *c);
+// Returns number of bytes used by compressed data (block headers + packed values)
+size_t le_vec_compressed_get_size(struct le_vec_compressed const *c);
+// Returns how many times compressed data is smaller than plain le_vec data
+double le_vec_compressed_get_ratio(struct le_vec_compressed const *c);
+
+// Gets element at index.
+LE_VEC_TYPE le_vec_compressed_get_at(struct le_vec_compressed const *c, size_t index);
+
+// Returns number of elements with specified value
+size_t le_vec_compressed_count(struct le_vec_compressed const *c, LE_VEC_TYPE value);
+// Returns index of first elem entry
+// Returns invalid index if not found
+size_t le_vec_compressed_find(struct le_vec_compressed const *c, LE_VEC_TYPE elem);
+// Returns sum of all elements
+long long le_vec_compressed_sum(struct le_vec_compressed const *c);
@@ -0,0 +1,128 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "le_vec.h"
+#include "le_vec_dirty.h"
+#include "le_vec_internal.h"
+
+struct _le_vec_dirty {
+    size_t words_length;
+    // Bit per block of LE_VEC_DIRTY_BLOCK elements
+    uint64_t *words;
+};
+
+void le_vec_track_changes(struct le_vec *v, bool enabled) {
+    if (!enabled) {
+        if (v->dirty != NULL) {
+            free(v->dirty->words);
+            free(v->dirty);
+            v->dirty = NULL;
+        }
+        return;
+    }
+
+    if (v->dirty == NULL) {
+        v->dirty = calloc(1, sizeof(struct _le_vec_dirty));
+    }
+}
+
+bool le_vec_is_tracking_changes(struct le_vec const *v) {
+    return v->dirty != NULL;
+}
+
+// Grows bitmap to fit `words_length` words.
+static void expand_words(struct _le_vec_dirty *d, size_t words_length) {
+    size_t new_length = d->words_length > 0 ? d->words_length : 1;
+    while (new_length < words_length) {
+        new_length *= 2;
+    }
+
+    d->words = realloc(d->words, new_length * sizeof(uint64_t));
+    memset(d->words + d->words_length, 0, (new_length - d->words_length) * sizeof(uint64_t));
+    d->words_length = new_length;
+}
+
+// Returns bits [from; 64) of a word set
+static uint64_t bits_from(size_t from) {
+    return ~0ull << from;
+}
+
+void _le_vec_mark_dirty(struct le_vec *v, size_t start, size_t end) {
+    if (start >= end) {
+        return;
+    }
+
+    struct _le_vec_dirty *d = v->dirty;
+    size_t first = start / LE_VEC_DIRTY_BLOCK;
+    size_t last = (end - 1) / LE_VEC_DIRTY_BLOCK;
+    if (last / 64 >= d->words_length) {
+        expand_words(d, last / 64 + 1);
+    }
+
+    size_t first_word = first / 64;
+    size_t last_word = last / 64;
+    uint64_t first_bits = bits_from(first % 64);
+    uint64_t last_bits = ~bits_from(last % 64) | (1ull << (last % 64));
+
+    if (first_word == last_word) {
+        d->words[first_word] |= first_bits & last_bits;
+        return;
+    }
+
+    d->words[first_word] |= first_bits;
+    for (size_t word = first_word + 1; word < last_word; word++) {
+        d->words[word] = ~0ull;
+    }
+    d->words[last_word] |= last_bits;
+}
+
+size_t le_vec_take_dirty_ranges(struct le_vec *v, struct le_vec_range **ranges) {
+    *ranges = NULL;
+
+    struct _le_vec_dirty *d = v->dirty;
+    if (d == NULL) {
+        return 0;
+    }
+
+    size_t length = le_vec_get_length(v);
+    size_t ranges_length = 0;
+    size_t ranges_capacity = 0;
+    // Start of the range being collected, invalid index if there is none
+    size_t start = (size_t)-1;
+
+    // Words past the last one are treated as zero, so that the last range gets closed
+    for (size_t word = 0; word <= d->words_length; word++) {
+        uint64_t bits = word < d->words_length ? d->words[word] : 0;
+
+        // Skips words that neither start nor end a range
+        if ((start == (size_t)-1 && bits == 0) || (start != (size_t)-1 && bits == ~0ull)) {
+            continue;
+        }
+
+        for (size_t bit = 0; bit < 64; bit++) {
+            bool set = (bits >> bit) & 1;
+            size_t block_start = (word * 64 + bit) * LE_VEC_DIRTY_BLOCK;
+
+            if (set && start == (size_t)-1) {
+                start = block_start;
+            } else if (!set && start != (size_t)-1) {
+                size_t end = block_start < length ? block_start : length;
+                if (start < end) {
+                    if (ranges_length == ranges_capacity) {
+                        ranges_capacity = ranges_capacity > 0 ? ranges_capacity * 2 : 16;
+                        *ranges = realloc(*ranges, ranges_capacity * sizeof(struct le_vec_range));
+                    }
+                    (*ranges)[ranges_length++] = (struct le_vec_range){start, end};
+                }
+                start = (size_t)-1;
+            }
+        }
+    }
+
+    memset(d->words, 0, d->words_length * sizeof(uint64_t));
+
+    return ranges_length;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+
+// Opt-in tracking of changed elements, so that sync, checksums or replication of a vector
+// can process only what changed since the last time instead of the whole vector.
+// Changes are kept as a bitmap with a bit per block of LE_VEC_DIRTY_BLOCK elements: marking costs
+// O(1) per modified element or range, taking ranges costs O(length / LE_VEC_DIRTY_BLOCK / 64).
+// All modifying functions record changes, including writes that move elements (insert, erase, sort).
+// Removed elements are not reported, compare lengths to find out about them.
+
+// Number of elements covered by one dirty bit, reported ranges are aligned to it
+#define LE_VEC_DIRTY_BLOCK 64
+
+// Changed elements [start; end)
+struct le_vec_range {
+    size_t start;
+    size_t end;
+};
+
+// Starts or stops recording changes of vector (off by default), stopping forgets recorded changes
+void le_vec_track_changes(struct le_vec *v, bool enabled);
+// Checks if changes of vector are recorded
+bool le_vec_is_tracking_changes(struct le_vec const *v);
+
+// Returns number of changed ranges recorded since tracking started or previous take, and forgets them
+// Ranges are sorted, don't overlap or touch, and are cut to the current length
+// `ranges` gets malloc()ed array of them (NULL if there are none), which caller must free()
+size_t le_vec_take_dirty_ranges(struct le_vec *v, struct le_vec_range **ranges);
@@ -0,0 +1,108 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_simd.h"
+
+// Growth by 0 this big takes a fresh zeroed buffer instead of stores
+#define ZEROED_MIN_BYTES (1024 * 1024)
+// Sequences this big bypass caches, they would only evict everything else from them
+#define STREAM_MIN_BYTES (16 * 1024 * 1024)
+
+// Fill is a sequence with step 0.
+struct sequence {
+    LE_VEC_TYPE *data;
+    size_t start;
+    size_t end;
+    LE_VEC_TYPE first;
+    LE_VEC_TYPE step;
+    size_t chunks;
+    bool stream;
+};
+
+// Returns element at index of sequence, wrapping around on overflow.
+static LE_VEC_TYPE sequence_at(LE_VEC_TYPE first, LE_VEC_TYPE step, size_t index) {
+    return (LE_VEC_TYPE)((unsigned long long)first + (unsigned long long)step * index);
+}
+
+static void sequence_scalar(LE_VEC_TYPE *data, size_t start, size_t end, LE_VEC_TYPE first, LE_VEC_TYPE step) {
+    for (size_t i = start; i < end; i++) {
+        data[i] = sequence_at(first, step, i);
+    }
+}
+
+#ifdef LE_VEC_X86
+// Head up to a 32-byte boundary is written by scalar code, so that full registers are stored aligned
+// (streaming stores require it)
+LE_VEC_TARGET("avx2")
+static void sequence_avx2(LE_VEC_TYPE *data, size_t start, size_t end, LE_VEC_TYPE first, LE_VEC_TYPE step, bool stream) {
+    size_t i = start;
+    for (; i < end && ((uintptr_t)(data + i) & 31) != 0; i++) {
+        data[i] = sequence_at(first, step, i);
+    }
+
+    __m256i lanes = _mm256_mullo_epi32(_mm256_set1_epi32(step), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+    __m256i x = _mm256_add_epi32(_mm256_set1_epi32(sequence_at(first, step, i)), lanes);
+    __m256i stride = _mm256_set1_epi32(sequence_at(0, step, 8));
+
+    if (stream) {
+        for (; i + 8 <= end; i += 8) {
+            _mm256_stream_si256((__m256i *)(data + i), x);
+            x = _mm256_add_epi32(x, stride);
+        }
+        _mm_sfence();
+    } else {
+        for (; i + 8 <= end; i += 8) {
+            _mm256_store_si256((__m256i *)(data + i), x);
+            x = _mm256_add_epi32(x, stride);
+        }
+    }
+
+    sequence_scalar(data, i, end, first, step);
+}
+#endif
+
+static void sequence_chunk(void *arg, size_t chunk) {
+    struct sequence *s = arg;
+    size_t start = s->start + _le_vec_chunk_start(s->end - s->start, s->chunks, chunk);
+    size_t end = s->start + _le_vec_chunk_start(s->end - s->start, s->chunks, chunk + 1);
+
+#ifdef LE_VEC_X86
+    if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx2")) {
+        sequence_avx2(s->data, start, end, s->first, s->step, s->stream);
+        return;
+    }
+#endif
+    sequence_scalar(s->data, start, end, s->first, s->step);
+}
+
+// Sets data[i] = first + step * i for i in [start; end), big ranges are written by several threads.
+static void write_sequence(LE_VEC_TYPE *data, size_t start, size_t end, LE_VEC_TYPE first, LE_VEC_TYPE step) {
+    size_t length = end - start;
+    struct sequence s = {data, start, end, first, step, _le_vec_parallel_chunks(length), length * sizeof(LE_VEC_TYPE) >= STREAM_MIN_BYTES};
+
+    _le_vec_parallel_run(s.chunks, sequence_chunk, &s);
+}
+
+void le_vec_resize_fill(struct le_vec *v, size_t new_length, LE_VEC_TYPE value) {
+    size_t length = le_vec_get_length(v);
+    if (new_length <= length) {
+        le_vec_resize(v, new_length);
+        return;
+    }
+
+    bool zeroed = value == 0 && (new_length - length) * sizeof(LE_VEC_TYPE) >= ZEROED_MIN_BYTES && _le_vec_expand_zeroed(v, new_length);
+    le_vec_resize_uninit(v, new_length);
+    if (!zeroed) {
+        write_sequence(v->data, length, new_length, value, 0);
+    }
+}
+
+void le_vec_iota(struct le_vec *v, LE_VEC_TYPE start, LE_VEC_TYPE step) {
+    size_t length = le_vec_get_length(v);
+
+    write_sequence(v->data, 0, length, start, step);
+    LE_VEC_MARK_DIRTY(v, 0, length);
+}
@@ -0,0 +1,160 @@
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_simd.h"
+
+// Randomly accessed data up to this size is expected to stay in L2
+#define CACHED_BYTES (256 * 1024)
+
+// Far enough to hide a DRAM miss behind ~32 loads, close enough to stay in L1
+static size_t prefetch_distance = 32;
+
+void le_vec_set_prefetch_distance(size_t distance) {
+    prefetch_distance = distance;
+}
+
+size_t le_vec_get_prefetch_distance(void) {
+    return prefetch_distance;
+}
+
+// Checks that every index is in [0; limit), a branchless min/max pass the compiler vectorizes.
+static bool are_indexes_valid(LE_VEC_TYPE const *indexes, size_t length, size_t limit) {
+    if (length == 0) {
+        return true;
+    }
+
+    LE_VEC_TYPE min = indexes[0];
+    LE_VEC_TYPE max = indexes[0];
+    for (size_t i = 1; i < length; i++) {
+        min = indexes[i] < min ? indexes[i] : min;
+        max = indexes[i] > max ? indexes[i] : max;
+    }
+
+    return min >= 0 && (size_t)max < limit;
+}
+
+// Number of leading elements that have an element `distance` ahead of them to prefetch.
+static size_t prefetched_length(size_t length, size_t distance) {
+    return distance > 0 && length > distance ? length - distance : 0;
+}
+
+static void gather_scalar(LE_VEC_TYPE *dst, LE_VEC_TYPE const *src, LE_VEC_TYPE const *indexes, size_t length, size_t distance) {
+    size_t prefetched = prefetched_length(length, distance);
+    size_t i = 0;
+
+    for (; i < prefetched; i++) {
+        __builtin_prefetch(src + indexes[i + distance]);
+        dst[i] = src[indexes[i]];
+    }
+    for (; i < length; i++) {
+        dst[i] = src[indexes[i]];
+    }
+}
+
+#ifdef LE_VEC_X86
+LE_VEC_TARGET("avx2")
+static void gather_avx2(LE_VEC_TYPE *dst, LE_VEC_TYPE const *src, LE_VEC_TYPE const *indexes, size_t length) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m256i index = _mm256_loadu_si256((__m256i const *)(indexes + i));
+        _mm256_storeu_si256((__m256i *)(dst + i), _mm256_i32gather_epi32(src, index, 4));
+    }
+
+    gather_scalar(dst + i, src, indexes + i, length - i, 0);
+}
+#endif
+
+// Prefetching only pays off for data that misses caches, otherwise it just takes load slots
+static size_t distance_for(size_t data_length) {
+    return data_length * sizeof(LE_VEC_TYPE) > CACHED_BYTES ? prefetch_distance : 0;
+}
+
+void _le_vec_gather_data(LE_VEC_TYPE *dst, LE_VEC_TYPE const *src, size_t src_length, LE_VEC_TYPE const *indexes, size_t length) {
+    size_t distance = distance_for(src_length);
+
+    // Hardware gather is a bit faster on cached data, but it can't be combined with
+    // prefetching, and scalar loads with prefetching win on data in DRAM
+#ifdef LE_VEC_X86
+    if (distance == 0 && sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx2")) {
+        gather_avx2(dst, src, indexes, length);
+        return;
+    }
+#endif
+    gather_scalar(dst, src, indexes, length, distance);
+}
+
+// No vector scatter before AVX-512, and even there it is no faster than scalar stores
+static void scatter(LE_VEC_TYPE *dst, size_t dst_length, LE_VEC_TYPE const *indexes, LE_VEC_TYPE const *src, size_t length) {
+    size_t distance = distance_for(dst_length);
+    size_t prefetched = prefetched_length(length, distance);
+    size_t i = 0;
+
+    for (; i < prefetched; i++) {
+        __builtin_prefetch(dst + indexes[i + distance], 1);
+        dst[indexes[i]] = src[i];
+    }
+    for (; i < length; i++) {
+        dst[indexes[i]] = src[i];
+    }
+}
+
+struct gather {
+    LE_VEC_TYPE *dst;
+    // Length of the randomly accessed one of dst and src
+    size_t data_length;
+    LE_VEC_TYPE const *src;
+    LE_VEC_TYPE const *indexes;
+    size_t length;
+    size_t chunks;
+};
+
+static void gather_chunk(void *arg, size_t chunk) {
+    struct gather *g = arg;
+    size_t start = _le_vec_chunk_start(g->length, g->chunks, chunk);
+    size_t end = _le_vec_chunk_start(g->length, g->chunks, chunk + 1);
+
+    _le_vec_gather_data(g->dst + start, g->src, g->data_length, g->indexes + start, end - start);
+}
+
+static void scatter_chunk(void *arg, size_t chunk) {
+    struct gather *g = arg;
+    size_t start = _le_vec_chunk_start(g->length, g->chunks, chunk);
+    size_t end = _le_vec_chunk_start(g->length, g->chunks, chunk + 1);
+
+    scatter(g->dst, g->data_length, g->indexes + start, g->src + start, end - start);
+}
+
+bool le_vec_gather(struct le_vec *dst, struct le_vec const *src, struct le_vec const *indexes) {
+    size_t length = le_vec_get_length(indexes);
+    if (dst == src || dst == indexes || !are_indexes_valid(indexes->data, length, le_vec_get_length(src))) {
+        return false;
+    }
+
+    le_vec_resize(dst, length);
+
+    struct gather g = {dst->data, le_vec_get_length(src), src->data, indexes->data, length, _le_vec_parallel_chunks(length)};
+    _le_vec_parallel_run(g.chunks, gather_chunk, &g);
+    LE_VEC_MARK_DIRTY(dst, 0, length);
+
+    return true;
+}
+
+bool le_vec_scatter(struct le_vec *dst, struct le_vec const *indexes, struct le_vec const *src) {
+    size_t length = le_vec_get_length(indexes);
+    if (dst == src || dst == indexes || length != le_vec_get_length(src) || !are_indexes_valid(indexes->data, length, le_vec_get_length(dst))) {
+        return false;
+    }
+
+    struct gather g = {dst->data, le_vec_get_length(dst), src->data, indexes->data, length, _le_vec_parallel_chunks(length)};
+    _le_vec_parallel_run(g.chunks, scatter_chunk, &g);
+    if (dst->dirty != NULL || dst->aggregates != NULL) {
+        for (size_t i = 0; i < length; i++) {
+            size_t index = (size_t)indexes->data[i];
+            LE_VEC_MARK_DIRTY(dst, index, index + 1);
+        }
+    }
+
+    return true;
+}
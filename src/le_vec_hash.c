@@ -0,0 +1,183 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "le_vec.h"
+#include "le_vec_hash.h"
+#include "le_vec_internal.h"
+
+#define PRIME1 11400714785074694791ull
+#define PRIME2 14029467366897019727ull
+#define PRIME3 1609587929392839161ull
+#define PRIME4 9650029242287828579ull
+#define PRIME5 2870177450012600261ull
+
+// Input is consumed in stripes of 4 lanes of 8 bytes, each lane has its own accumulator
+#define STRIPE 32
+
+struct le_vec_hash_state {
+    uint64_t acc[4];
+    // Bytes of a partial stripe, always fewer than STRIPE
+    unsigned char buffer[STRIPE];
+    size_t buffered;
+    // Number of hashed bytes
+    size_t bytes;
+};
+
+static uint64_t rotl(uint64_t x, unsigned r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t read64(unsigned char const *p) {
+    uint64_t x;
+    memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+static uint32_t read32(unsigned char const *p) {
+    uint32_t x;
+    memcpy(&x, p, sizeof(x));
+    return x;
+}
+
+static uint64_t round_lane(uint64_t acc, uint64_t input) {
+    acc += input * PRIME2;
+    acc = rotl(acc, 31);
+    return acc * PRIME1;
+}
+
+static uint64_t merge_lane(uint64_t h, uint64_t acc) {
+    h ^= round_lane(0, acc);
+    return h * PRIME1 + PRIME4;
+}
+
+static void state_reset(struct le_vec_hash_state *h) {
+    h->acc[0] = PRIME1 + PRIME2;
+    h->acc[1] = PRIME2;
+    h->acc[2] = 0;
+    h->acc[3] = -PRIME1;
+    h->buffered = 0;
+    h->bytes = 0;
+}
+
+// Consumes whole stripes of bytes, returns number of consumed bytes.
+static size_t consume_stripes(uint64_t *acc, unsigned char const *p, size_t bytes) {
+    uint64_t a0 = acc[0];
+    uint64_t a1 = acc[1];
+    uint64_t a2 = acc[2];
+    uint64_t a3 = acc[3];
+    size_t i = 0;
+
+    // Lanes are independent, so their multiplications overlap
+    for (; i + STRIPE <= bytes; i += STRIPE) {
+        a0 = round_lane(a0, read64(p + i));
+        a1 = round_lane(a1, read64(p + i + 8));
+        a2 = round_lane(a2, read64(p + i + 16));
+        a3 = round_lane(a3, read64(p + i + 24));
+    }
+
+    acc[0] = a0;
+    acc[1] = a1;
+    acc[2] = a2;
+    acc[3] = a3;
+    return i;
+}
+
+static void state_feed(struct le_vec_hash_state *h, void const *data, size_t bytes) {
+    unsigned char const *p = data;
+    h->bytes += bytes;
+
+    if (h->buffered > 0) {
+        size_t taken = STRIPE - h->buffered < bytes ? STRIPE - h->buffered : bytes;
+        memcpy(h->buffer + h->buffered, p, taken);
+        h->buffered += taken;
+        p += taken;
+        bytes -= taken;
+        if (h->buffered < STRIPE) {
+            return;
+        }
+        consume_stripes(h->acc, h->buffer, STRIPE);
+        h->buffered = 0;
+    }
+
+    size_t consumed = consume_stripes(h->acc, p, bytes);
+    memcpy(h->buffer, p + consumed, bytes - consumed);
+    h->buffered = bytes - consumed;
+}
+
+static uint64_t state_digest(struct le_vec_hash_state const *h) {
+    uint64_t total = (uint64_t)h->bytes;
+    uint64_t hash;
+
+    if (total >= STRIPE) {
+        hash = rotl(h->acc[0], 1) + rotl(h->acc[1], 7) + rotl(h->acc[2], 12) + rotl(h->acc[3], 18);
+        for (size_t lane = 0; lane < 4; lane++) {
+            hash = merge_lane(hash, h->acc[lane]);
+        }
+    } else {
+        hash = PRIME5;
+    }
+    hash += total;
+
+    unsigned char const *p = h->buffer;
+    size_t left = h->buffered;
+    for (; left >= 8; p += 8, left -= 8) {
+        hash ^= round_lane(0, read64(p));
+        hash = rotl(hash, 27) * PRIME1 + PRIME4;
+    }
+    if (left >= 4) {
+        hash ^= (uint64_t)read32(p) * PRIME1;
+        hash = rotl(hash, 23) * PRIME2 + PRIME3;
+        p += 4;
+        left -= 4;
+    }
+    for (; left > 0; p++, left--) {
+        hash ^= *p * PRIME5;
+        hash = rotl(hash, 11) * PRIME1;
+    }
+
+    hash ^= hash >> 33;
+    hash *= PRIME2;
+    hash ^= hash >> 29;
+    hash *= PRIME3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+uint64_t le_vec_hash(struct le_vec const *v) {
+    return le_vec_hash_bytes(v->data, le_vec_get_length(v) * sizeof(LE_VEC_TYPE));
+}
+
+uint64_t le_vec_hash_bytes(void const *data, size_t bytes) {
+    struct le_vec_hash_state h;
+    state_reset(&h);
+    state_feed(&h, data, bytes);
+    return state_digest(&h);
+}
+
+struct le_vec_hash_state *le_vec_hash_init(void) {
+    struct le_vec_hash_state *h = malloc(sizeof(struct le_vec_hash_state));
+    state_reset(h);
+    return h;
+}
+
+void le_vec_hash_destroy(struct le_vec_hash_state *h) {
+    free(h);
+}
+
+bool le_vec_hash_update(struct le_vec_hash_state *h, struct le_vec const *v) {
+    size_t length = le_vec_get_length(v);
+    size_t hashed = h->bytes / sizeof(LE_VEC_TYPE);
+    if (length < hashed) {
+        return false;
+    }
+
+    state_feed(h, v->data + hashed, (length - hashed) * sizeof(LE_VEC_TYPE));
+    return true;
+}
+
+uint64_t le_vec_hash_digest(struct le_vec_hash_state const *h) {
+    return state_digest(h);
+}
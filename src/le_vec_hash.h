@@ -0,0 +1,29 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "le_vec.h"
+
+// 64-bit non-cryptographic hashing of vector contents (XXH64 of element bytes, seed 0).
+// Hashes depend on LE_VEC_TYPE and byte order, so they are not meant to be stored across platforms.
+
+// Incremental hash of a growing vector
+struct le_vec_hash_state;
+
+// Returns hash of elements of vector, equal vectors have equal hashes
+uint64_t le_vec_hash(struct le_vec const *v);
+// Returns XXH64 (seed 0) of `bytes` bytes at data, le_vec_hash() is this hash of the bytes of elements
+uint64_t le_vec_hash_bytes(void const *data, size_t bytes);
+
+// Creates state of an empty vector
+struct le_vec_hash_state *le_vec_hash_init(void);
+// Destroys hash state
+void le_vec_hash_destroy(struct le_vec_hash_state *h);
+// Hashes elements of vector appended since the previous update, so a growing vector is hashed once in total
+// Elements seen by earlier updates must stay unchanged
+// Returns false (state is not changed) if vector got shorter than already hashed part
+bool le_vec_hash_update(struct le_vec_hash_state *h, struct le_vec const *v);
+// Returns hash of elements seen so far, same as le_vec_hash() of them (state stays usable)
+uint64_t le_vec_hash_digest(struct le_vec_hash_state const *h);
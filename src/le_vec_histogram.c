@@ -0,0 +1,424 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "le_vec.h"
+#include "le_vec_histogram.h"
+#include "le_vec_internal.h"
+
+// Consecutive elements go to different sub-histograms, so runs of equal values increment
+// different counters instead of waiting for each other's stores to the same one
+#define SUB_HISTOGRAMS 4
+// Ranges with more bins are counted straight into the result, copies of them would not fit in L2
+#define SUB_HISTOGRAM_MAX_BINS (16 * 1024)
+// 32-bit sub-histogram counters are flushed after this many elements, before any of them can overflow
+#define FLUSH_LENGTH ((size_t)1 << 30)
+// Keys spanning at most this many values are counted with a histogram instead of a hash table
+#define DENSE_KEYS_MAX_BINS (64 * 1024)
+// Hash tables start with 1 << TABLE_MIN_BITS slots
+#define TABLE_MIN_BITS 6
+// Hash tables up to this size are expected to stay in L2, larger ones get their slots prefetched
+#define CACHED_BYTES (256 * 1024)
+// Prefetching is turned on or off once per this many elements, as the table grows
+#define PREFETCH_BLOCK 1024
+
+// Values below low wrap around to huge numbers, so a single compare catches both sides.
+// Returns bins for values out of range.
+static size_t bin_of(LE_VEC_TYPE value, LE_VEC_TYPE low, size_t bins) {
+    size_t bin = (size_t)((long long)value - (long long)low);
+    return bin < bins ? bin : bins;
+}
+
+// Adds numbers of elements equal to each of [low; low + bins) to counts
+static void count_range(LE_VEC_TYPE const *data, size_t length, LE_VEC_TYPE low, size_t bins, size_t *counts) {
+    if (bins > SUB_HISTOGRAM_MAX_BINS || length < SUB_HISTOGRAMS * bins) {
+        for (size_t i = 0; i < length; i++) {
+            size_t bin = bin_of(data[i], low, bins);
+            if (bin < bins) {
+                counts[bin]++;
+            }
+        }
+        return;
+    }
+
+    // One extra bin per sub-histogram takes values out of range without a branch
+    size_t stride = bins + 1;
+    uint32_t *sub = calloc(SUB_HISTOGRAMS * stride, sizeof(uint32_t));
+
+    for (size_t start = 0; start < length; start += FLUSH_LENGTH) {
+        size_t end = length - start > FLUSH_LENGTH ? start + FLUSH_LENGTH : length;
+        size_t i = start;
+        for (; i + SUB_HISTOGRAMS <= end; i += SUB_HISTOGRAMS) {
+            for (size_t s = 0; s < SUB_HISTOGRAMS; s++) {
+                sub[s * stride + bin_of(data[i + s], low, bins)]++;
+            }
+        }
+        for (; i < end; i++) {
+            sub[bin_of(data[i], low, bins)]++;
+        }
+
+        for (size_t s = 0; s < SUB_HISTOGRAMS; s++) {
+            for (size_t bin = 0; bin < bins; bin++) {
+                counts[bin] += sub[s * stride + bin];
+            }
+        }
+        memset(sub, 0, SUB_HISTOGRAMS * stride * sizeof(uint32_t));
+    }
+
+    free(sub);
+}
+
+struct partial_counts {
+    size_t *counts;
+    // `sources` arrays of `length` counts one after another
+    size_t const *partials;
+    size_t sources;
+    size_t length;
+    size_t chunks;
+};
+
+static void merge_chunk(void *arg, size_t chunk) {
+    struct partial_counts *p = arg;
+    size_t start = _le_vec_chunk_start(p->length, p->chunks, chunk);
+    size_t end = _le_vec_chunk_start(p->length, p->chunks, chunk + 1);
+
+    for (size_t source = 0; source < p->sources; source++) {
+        size_t const *partial = p->partials + source * p->length;
+        for (size_t i = start; i < end; i++) {
+            p->counts[i] += partial[i];
+        }
+    }
+}
+
+// Adds counts of other threads to counts, every merging thread takes its own range of counters
+static void merge_counts(size_t *counts, size_t const *partials, size_t sources, size_t length) {
+    struct partial_counts p = {counts, partials, sources, length, _le_vec_parallel_chunks(sources * length)};
+    _le_vec_parallel_run(p.chunks, merge_chunk, &p);
+}
+
+struct histogram {
+    LE_VEC_TYPE const *data;
+    size_t length;
+    size_t chunks;
+    LE_VEC_TYPE low;
+    size_t bins;
+    // Chunk 0 counts straight into the result, others into their own arrays in partials
+    size_t *counts;
+    size_t *partials;
+};
+
+static void histogram_chunk(void *arg, size_t chunk) {
+    struct histogram *h = arg;
+    size_t start = _le_vec_chunk_start(h->length, h->chunks, chunk);
+    size_t end = _le_vec_chunk_start(h->length, h->chunks, chunk + 1);
+    size_t *counts = chunk == 0 ? h->counts : h->partials + (chunk - 1) * h->bins;
+
+    count_range(h->data + start, end - start, h->low, h->bins, counts);
+}
+
+static void histogram(LE_VEC_TYPE const *data, size_t length, LE_VEC_TYPE low, size_t bins, size_t *counts) {
+    memset(counts, 0, bins * sizeof(size_t));
+
+    // Arrays of other threads are not worth it when there are more bins than elements in a chunk
+    size_t chunks = _le_vec_parallel_chunks(length);
+    size_t *partials = chunks > 1 && bins <= length / chunks ? calloc((chunks - 1) * bins, sizeof(size_t)) : NULL;
+    if (partials == NULL) {
+        count_range(data, length, low, bins, counts);
+        return;
+    }
+
+    struct histogram h = {data, length, chunks, low, bins, counts, partials};
+    _le_vec_parallel_run(chunks, histogram_chunk, &h);
+    merge_counts(counts, partials, chunks - 1, bins);
+    free(partials);
+}
+
+bool le_vec_histogram(struct le_vec const *v, LE_VEC_TYPE low, LE_VEC_TYPE high, size_t *counts) {
+    if (low > high) {
+        return false;
+    }
+
+    histogram(v->data, le_vec_get_length(v), low, (size_t)((long long)high - (long long)low) + 1, counts);
+    return true;
+}
+
+struct slot {
+    LE_VEC_TYPE key;
+    // Count (or another positive number), 0 marks an empty slot
+    size_t value;
+};
+
+// Open addressing with linear probing, load factor is kept at most 1/2
+struct table {
+    unsigned bits;
+    size_t length;
+    struct slot *slots;
+};
+
+// Fibonacci hashing: top bits of the product depend on all bits of key
+static size_t slot_of(LE_VEC_TYPE key, unsigned bits) {
+    return (size_t)(((uint64_t)(long long)key * 0x9E3779B97F4A7C15ull) >> (64 - bits));
+}
+
+static void table_init(struct table *t, unsigned bits) {
+    t->bits = bits;
+    t->length = 0;
+    t->slots = calloc((size_t)1 << bits, sizeof(struct slot));
+}
+
+static void table_destroy(struct table *t) {
+    free(t->slots);
+}
+
+// Distance to prefetch slots of keys ahead at, 0 while table fits in cache
+// Returns how far ahead to prefetch slots of tables having `slots` slots in total
+static size_t prefetch_distance_of(size_t slots) {
+    return slots * sizeof(struct slot) > CACHED_BYTES ? le_vec_get_prefetch_distance() : 0;
+}
+
+// Returns value of key, NULL if there is none
+static size_t *table_find(struct table const *t, LE_VEC_TYPE key) {
+    size_t mask = ((size_t)1 << t->bits) - 1;
+    for (size_t slot = slot_of(key, t->bits);; slot = (slot + 1) & mask) {
+        if (t->slots[slot].value == 0) {
+            return NULL;
+        }
+        if (t->slots[slot].key == key) {
+            return &t->slots[slot].value;
+        }
+    }
+}
+
+static void table_grow(struct table *t);
+
+// Adds amount (> 0) to value of key, a missing key starts with 0
+static void table_add(struct table *t, LE_VEC_TYPE key, size_t amount) {
+    size_t mask = ((size_t)1 << t->bits) - 1;
+    size_t slot = slot_of(key, t->bits);
+    while (t->slots[slot].value != 0 && t->slots[slot].key != key) {
+        slot = (slot + 1) & mask;
+    }
+
+    if (t->slots[slot].value == 0) {
+        t->slots[slot].key = key;
+        t->length++;
+    }
+    t->slots[slot].value += amount;
+
+    if (2 * t->length > mask + 1) {
+        table_grow(t);
+    }
+}
+
+static void table_grow(struct table *t) {
+    struct table old = *t;
+    table_init(t, old.bits + 1);
+
+    for (size_t slot = 0; slot < ((size_t)1 << old.bits); slot++) {
+        if (old.slots[slot].value != 0) {
+            table_add(t, old.slots[slot].key, old.slots[slot].value);
+        }
+    }
+    table_destroy(&old);
+}
+
+// Every key belongs to one of parts, so that parts merge independently.
+// Multiplier differs from slot_of(), otherwise keys of a part would crowd in a part of its table.
+static size_t part_of(LE_VEC_TYPE key, size_t parts) {
+    if (parts == 1) {
+        return 0;
+    }
+
+    uint64_t hash = (uint64_t)(long long)key * 0xC2B2AE3D27D4EB4Full;
+    return (size_t)(((hash >> 32) * parts) >> 32);
+}
+
+// Keys are split into as many parts as there are chunks. Every chunk counts each part in its own table,
+// so that merging a part reads only the tables holding its keys.
+struct value_counts {
+    LE_VEC_TYPE const *data;
+    size_t length;
+    size_t chunks;
+    // tables[chunk * chunks + part]
+    struct table *tables;
+    // Table of every part after merging
+    struct table *merged;
+};
+
+static void count_values_chunk(void *arg, size_t chunk) {
+    struct value_counts *c = arg;
+    size_t start = _le_vec_chunk_start(c->length, c->chunks, chunk);
+    size_t end = _le_vec_chunk_start(c->length, c->chunks, chunk + 1);
+    size_t parts = c->chunks;
+    struct table *tables = &c->tables[chunk * parts];
+
+    for (size_t part = 0; part < parts; part++) {
+        table_init(&tables[part], TABLE_MIN_BITS);
+    }
+
+    for (size_t block = start; block < end; block += PREFETCH_BLOCK) {
+        size_t block_end = end - block > PREFETCH_BLOCK ? block + PREFETCH_BLOCK : end;
+        size_t slots = 0;
+        for (size_t part = 0; part < parts; part++) {
+            slots += (size_t)1 << tables[part].bits;
+        }
+        size_t distance = prefetch_distance_of(slots);
+
+        for (size_t i = block; i < block_end; i++) {
+            if (distance > 0 && i + distance < end) {
+                LE_VEC_TYPE ahead = c->data[i + distance];
+                struct table const *t = &tables[part_of(ahead, parts)];
+                __builtin_prefetch(&t->slots[slot_of(ahead, t->bits)], 1);
+            }
+            table_add(&tables[part_of(c->data[i], parts)], c->data[i], 1);
+        }
+    }
+}
+
+// Takes over the table of chunk 0 and adds tables of the other chunks to it
+static void merge_values_chunk(void *arg, size_t part) {
+    struct value_counts *c = arg;
+    struct table *merged = &c->merged[part];
+
+    *merged = c->tables[part];
+    for (size_t chunk = 1; chunk < c->chunks; chunk++) {
+        struct table *t = &c->tables[chunk * c->chunks + part];
+        for (size_t slot = 0; slot < ((size_t)1 << t->bits); slot++) {
+            if (t->slots[slot].value != 0) {
+                table_add(merged, t->slots[slot].key, t->slots[slot].value);
+            }
+        }
+        table_destroy(t);
+    }
+}
+
+static int compare_value_counts(void const *a, void const *b) {
+    LE_VEC_TYPE x = ((struct le_vec_value_count const *)a)->value;
+    LE_VEC_TYPE y = ((struct le_vec_value_count const *)b)->value;
+    return (x > y) - (x < y);
+}
+
+size_t le_vec_value_counts(struct le_vec const *v, struct le_vec_value_count **counts) {
+    size_t length = le_vec_get_length(v);
+    size_t chunks = _le_vec_parallel_chunks(length);
+    struct table *tables = malloc((chunks + 1) * chunks * sizeof(struct table));
+    struct value_counts c = {v->data, length, chunks, tables, tables + chunks * chunks};
+
+    _le_vec_parallel_run(chunks, count_values_chunk, &c);
+    struct table *result = tables;
+    if (chunks > 1) {
+        _le_vec_parallel_run(chunks, merge_values_chunk, &c);
+        result = c.merged;
+    }
+
+    size_t distinct = 0;
+    for (size_t part = 0; part < chunks; part++) {
+        distinct += result[part].length;
+    }
+
+    *counts = distinct > 0 ? malloc(distinct * sizeof(struct le_vec_value_count)) : NULL;
+    size_t k = 0;
+    for (size_t part = 0; part < chunks; part++) {
+        struct table *t = &result[part];
+        for (size_t slot = 0; slot < ((size_t)1 << t->bits); slot++) {
+            if (t->slots[slot].value != 0) {
+                (*counts)[k].value = t->slots[slot].key;
+                (*counts)[k].count = t->slots[slot].value;
+                k++;
+            }
+        }
+        table_destroy(t);
+    }
+    free(tables);
+
+    if (distinct > 0) {
+        qsort(*counts, distinct, sizeof(struct le_vec_value_count), compare_value_counts);
+    }
+    return distinct;
+}
+
+struct key_counts {
+    LE_VEC_TYPE const *data;
+    size_t length;
+    size_t chunks;
+    // Maps keys to their counter + 1
+    struct table const *keys;
+    size_t distinct;
+    // `distinct` counters per chunk
+    size_t *counts;
+};
+
+static void count_keys_chunk(void *arg, size_t chunk) {
+    struct key_counts *k = arg;
+    size_t start = _le_vec_chunk_start(k->length, k->chunks, chunk);
+    size_t end = _le_vec_chunk_start(k->length, k->chunks, chunk + 1);
+    size_t *counts = k->counts + chunk * k->distinct;
+    size_t distance = prefetch_distance_of((size_t)1 << k->keys->bits);
+
+    for (size_t i = start; i < end; i++) {
+        if (distance > 0 && i + distance < end) {
+            __builtin_prefetch(&k->keys->slots[slot_of(k->data[i + distance], k->keys->bits)]);
+        }
+        size_t const *counter = table_find(k->keys, k->data[i]);
+        if (counter != NULL) {
+            counts[*counter - 1]++;
+        }
+    }
+}
+
+void le_vec_count_many(struct le_vec const *v, LE_VEC_TYPE const *keys, size_t keys_length, size_t *counts) {
+    if (keys_length == 0) {
+        return;
+    }
+
+    size_t length = le_vec_get_length(v);
+    LE_VEC_TYPE low = keys[0];
+    LE_VEC_TYPE high = keys[0];
+    for (size_t i = 1; i < keys_length; i++) {
+        low = keys[i] < low ? keys[i] : low;
+        high = keys[i] > high ? keys[i] : high;
+    }
+
+    size_t span = (size_t)((long long)high - (long long)low) + 1;
+    if (span <= DENSE_KEYS_MAX_BINS) {
+        size_t *bins = malloc(span * sizeof(size_t));
+        histogram(v->data, length, low, span, bins);
+        for (size_t i = 0; i < keys_length; i++) {
+            counts[i] = bins[bin_of(keys[i], low, span)];
+        }
+        free(bins);
+        return;
+    }
+
+    // Repeated keys share a counter
+    struct table table;
+    table_init(&table, TABLE_MIN_BITS);
+    size_t *counter_of = malloc(keys_length * sizeof(size_t));
+    size_t distinct = 0;
+    for (size_t i = 0; i < keys_length; i++) {
+        size_t const *counter = table_find(&table, keys[i]);
+        if (counter != NULL) {
+            counter_of[i] = *counter - 1;
+        } else {
+            counter_of[i] = distinct++;
+            table_add(&table, keys[i], distinct);
+        }
+    }
+
+    size_t chunks = _le_vec_parallel_chunks(length);
+    struct key_counts k = {v->data, length, chunks, &table, distinct, calloc(chunks * distinct, sizeof(size_t))};
+    _le_vec_parallel_run(chunks, count_keys_chunk, &k);
+    if (chunks > 1) {
+        merge_counts(k.counts, k.counts + distinct, chunks - 1, distinct);
+    }
+
+    for (size_t i = 0; i < keys_length; i++) {
+        counts[i] = k.counts[counter_of[i]];
+    }
+
+    free(k.counts);
+    free(counter_of);
+    table_destroy(&table);
+}
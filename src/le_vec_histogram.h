@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+
+// Frequency tables built in a single pass over elements (large vectors are split between threads,
+// counts of threads are then merged by several threads too).
+
+// Distinct value and number of its occurrences
+struct le_vec_value_count {
+    LE_VEC_TYPE value;
+    size_t count;
+};
+
+// Counts elements equal to each value of [low; high]: counts[i] - number of elements equal to low + i
+// counts must have room for high - low + 1 values, elements outside of [low; high] are skipped
+// Meant for dense small ranges, takes O(high - low) memory
+// Returns false (counts are not changed) if low > high
+bool le_vec_histogram(struct le_vec const *v, LE_VEC_TYPE low, LE_VEC_TYPE high, size_t *counts);
+
+// Counts occurrences of every distinct element (hash table, for sparse values of any range)
+// *counts gets a malloc'd array of (value, count) pairs in ascending order of values,
+// caller frees it (NULL if vector is empty)
+// Returns number of distinct values
+size_t le_vec_value_counts(struct le_vec const *v, struct le_vec_value_count **counts);
+
+// Counts occurrences of each of keys: counts[i] - number of elements equal to keys[i]
+// Costs one pass over vector regardless of number of keys
+void le_vec_count_many(struct le_vec const *v, LE_VEC_TYPE const *keys, size_t keys_length, size_t *counts);
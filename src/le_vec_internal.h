@@ -0,0 +1,141 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+#include "le_vec_stats.h"
+
+// Internals shared between le_vec translation units.
+// Not a part of the public API, don't include it from outside src/.
+
+#ifdef LE_VEC_STATS
+// Counters behind le_vec_stats, updated with relaxed atomics
+struct _le_vec_counters {
+    _Atomic size_t allocs;
+    _Atomic size_t reallocs;
+    _Atomic size_t frees;
+    _Atomic size_t bytes_moved;
+    _Atomic size_t capacity_bytes;
+    _Atomic size_t peak_capacity_bytes;
+    _Atomic size_t calls[LE_VEC_OPS_LENGTH];
+    _Atomic unsigned long long cycles[LE_VEC_OPS_LENGTH];
+};
+#endif
+
+// Changes recorded by le_vec_track_changes()
+struct _le_vec_dirty;
+// Block summaries kept by le_vec_track_aggregates()
+struct _le_vec_aggregates;
+
+struct le_vec {
+    size_t capacity;
+    size_t length;
+    LE_VEC_TYPE *data;
+    // NULL unless changes are tracked
+    struct _le_vec_dirty *dirty;
+    // NULL unless aggregates are tracked
+    struct _le_vec_aggregates *aggregates;
+#ifdef LE_VEC_STATS
+    struct _le_vec_counters counters;
+#endif
+};
+
+// Creates vector with given capacity and length, data is not initialized.
+struct le_vec *_le_vec_create(size_t capacity, size_t length);
+// Reallocates data to fit exactly `capacity` elements.
+void _le_vec_realloc_data(struct le_vec *v, size_t capacity);
+
+// Expands data so that capacity is >= request.
+bool __le_vec_expand_to_request(struct le_vec *v, size_t request);
+// Same as `__le_vec_expand_to_request()`, but moves data to a zeroed buffer, so elements past length are 0.
+bool _le_vec_expand_zeroed(struct le_vec *v, size_t request);
+// Expands data. Call this.
+bool _le_vec_expand(struct le_vec *v);
+// Explicitly and stupidly sets a length to a new value.
+void _le_vec_set_length(struct le_vec *v, size_t new_length);
+// Reallocates data and so that capacity == length.
+void _le_vec_shrink_down_to_length(struct le_vec *v);
+
+// Vectors shorter than this are processed by a single thread, each thread gets at least this many elements
+#define _LE_VEC_PARALLEL_GRAIN (256 * 1024)
+
+// Returns number of chunks to split `length` elements into, 1 if it is not worth going parallel.
+size_t _le_vec_parallel_chunks(size_t length);
+// Runs task(arg, chunk) for every chunk in [0; chunks), each on its own thread
+// (on several NUMA nodes threads are pinned to nodes of their chunks). Returns when all of them are done.
+void _le_vec_parallel_run(size_t chunks, void (*task)(void *arg, size_t chunk), void *arg);
+// Returns index of the first element of chunk `chunk` when `length` elements are split into `chunks`.
+// Chunk ends where the next one starts, the last one ends at length.
+size_t _le_vec_chunk_start(size_t length, size_t chunks, size_t chunk);
+// Returns NUMA node that keeps chunk `chunk` out of `chunks` (see le_vec_numa.h).
+int _le_vec_chunk_node(size_t chunks, size_t chunk);
+// Restricts calling thread to CPUs of NUMA node.
+void _le_vec_numa_pin_current_thread(int node);
+
+// Sets dst[i] = src[indexes[i]] for i in [0; length), indexes must be in [0; src_length).
+// Prefetches from big src, uses AVX2 gather on small one.
+void _le_vec_gather_data(LE_VEC_TYPE *dst, LE_VEC_TYPE const *src, size_t src_length, LE_VEC_TYPE const *indexes, size_t length);
+
+// Returns index of `n`th element equal to value counting from the start (from the end if reverse),
+// invalid index if there are fewer of them. Big data is searched by several threads that stop early.
+size_t _le_vec_search(LE_VEC_TYPE const *data, size_t length, LE_VEC_TYPE value, size_t n, bool reverse);
+
+// Records [start; end) as changed, v must track changes. Use LE_VEC_MARK_DIRTY().
+void _le_vec_mark_dirty(struct le_vec *v, size_t start, size_t end);
+// Drops summaries of blocks overlapping [start; end), v must track aggregates. Use LE_VEC_MARK_DIRTY().
+void _le_vec_invalidate_aggregates(struct le_vec *v, size_t start, size_t end);
+// Must follow every write to elements [start; end): records the change if v tracks changes
+// (see le_vec_dirty.h) and drops stale aggregates if v tracks them (see le_vec_aggregates.h).
+// Removal of elements from the end needs no call, tracked aggregates notice the new length themselves.
+#define LE_VEC_MARK_DIRTY(v, start, end)                        \
+    do {                                                        \
+        if ((v)->dirty != NULL) {                               \
+            _le_vec_mark_dirty((v), (start), (end));            \
+        }                                                       \
+        if ((v)->aggregates != NULL) {                          \
+            _le_vec_invalidate_aggregates((v), (start), (end)); \
+        }                                                       \
+    } while (0)
+
+// Applies f for each element in src and stores result in dest.
+// dest.length must be >= src.lentgth to fit all elements.
+void _le_vec_map(struct le_vec *dest, struct le_vec const *src, LE_VEC_TYPE (*f)(LE_VEC_TYPE));
+
+#ifdef LE_VEC_STATS
+void _le_vec_stats_init(struct le_vec *v);
+void _le_vec_stats_on_alloc(struct le_vec *v, size_t bytes);
+void _le_vec_stats_on_realloc(struct le_vec *v, size_t old_bytes, size_t new_bytes, bool moved);
+void _le_vec_stats_on_free(struct le_vec *v, size_t bytes);
+void _le_vec_stats_count(struct le_vec const *v, enum le_vec_op op);
+
+struct _le_vec_stats_timer {
+    struct le_vec const *v;
+    enum le_vec_op op;
+    unsigned long long start;
+};
+
+struct _le_vec_stats_timer _le_vec_stats_begin(struct le_vec const *v, enum le_vec_op op);
+void _le_vec_stats_end(struct _le_vec_stats_timer *timer);
+
+#define LE_VEC_STATS_INIT(v) _le_vec_stats_init(v)
+#define LE_VEC_STATS_ON_ALLOC(v, bytes) _le_vec_stats_on_alloc((v), (bytes))
+#define LE_VEC_STATS_ON_REALLOC(v, old_bytes, new_bytes, moved) _le_vec_stats_on_realloc((v), (old_bytes), (new_bytes), (moved))
+#define LE_VEC_STATS_ON_FREE(v, bytes) _le_vec_stats_on_free((v), (bytes))
+
+// Counts a call of `op` on `v` (NULL for global only); with LE_VEC_STATS_CYCLES
+// also adds cycles spent until the end of the enclosing scope.
+#ifdef LE_VEC_STATS_CYCLES
+#define LE_VEC_STATS_CALL(v, op)                                                               \
+    struct _le_vec_stats_timer _le_vec_stats_timer __attribute__((cleanup(_le_vec_stats_end))) = \
+        _le_vec_stats_begin((v), (op))
+#else
+#define LE_VEC_STATS_CALL(v, op) _le_vec_stats_count((v), (op))
+#endif
+#else
+#define LE_VEC_STATS_INIT(v)
+#define LE_VEC_STATS_ON_ALLOC(v, bytes)
+#define LE_VEC_STATS_ON_REALLOC(v, old_bytes, new_bytes, moved)
+#define LE_VEC_STATS_ON_FREE(v, bytes)
+#define LE_VEC_STATS_CALL(v, op)
+#endif
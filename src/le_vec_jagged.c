@@ -0,0 +1,298 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_jagged.h"
+
+struct row {
+    size_t start;
+    size_t length;
+};
+
+struct le_vec_jagged {
+    struct row *rows;
+    size_t rows_length;
+    size_t rows_capacity;
+    LE_VEC_TYPE *values;
+    size_t values_capacity;
+    // End of the used part of values, rows and holes are before it
+    size_t values_end;
+    // Number of elements in rows, values_end - live are holes
+    size_t live;
+    // Rows follow each other in row order without holes
+    bool compact;
+    // Read-only views, refreshed on request
+    struct le_vec row_view;
+    struct le_vec values_view;
+};
+
+static void view_init(struct le_vec *v) {
+    v->dirty = NULL;
+    v->aggregates = NULL;
+    LE_VEC_STATS_INIT(v);
+}
+
+static struct le_vec_jagged *create(size_t rows_capacity, size_t values_capacity) {
+    struct le_vec_jagged *j = malloc(sizeof(struct le_vec_jagged));
+
+    j->rows_capacity = rows_capacity > LE_VEC_DEFAULT_CAPACITY ? rows_capacity : LE_VEC_DEFAULT_CAPACITY;
+    j->rows = malloc(j->rows_capacity * sizeof(struct row));
+    j->rows_length = 0;
+    j->values_capacity = values_capacity > LE_VEC_DEFAULT_CAPACITY ? values_capacity : LE_VEC_DEFAULT_CAPACITY;
+    j->values = malloc(j->values_capacity * sizeof(LE_VEC_TYPE));
+    j->values_end = 0;
+    j->live = 0;
+    j->compact = true;
+    view_init(&j->row_view);
+    view_init(&j->values_view);
+
+    return j;
+}
+
+struct le_vec_jagged *le_vec_jagged_init(void) {
+    return create(LE_VEC_DEFAULT_CAPACITY, LE_VEC_DEFAULT_CAPACITY);
+}
+
+struct le_vec_jagged *le_vec_jagged_init_from_vecs(struct le_vec const *const *vecs, size_t length) {
+    size_t total = 0;
+    for (size_t i = 0; i < length; i++) {
+        total += le_vec_get_length(vecs[i]);
+    }
+
+    struct le_vec_jagged *j = create(length, total);
+    for (size_t i = 0; i < length; i++) {
+        size_t row_length = le_vec_get_length(vecs[i]);
+        memcpy(j->values + j->values_end, vecs[i]->data, row_length * sizeof(LE_VEC_TYPE));
+        j->rows[i].start = j->values_end;
+        j->rows[i].length = row_length;
+        j->values_end += row_length;
+    }
+    j->rows_length = length;
+    j->live = total;
+
+    return j;
+}
+
+void le_vec_jagged_destroy(struct le_vec_jagged *j) {
+    if (j == NULL) {
+        return;
+    }
+
+    free(j->rows);
+    free(j->values);
+    free(j);
+}
+
+size_t le_vec_jagged_get_rows_length(struct le_vec_jagged const *j) {
+    return j->rows_length;
+}
+
+size_t le_vec_jagged_get_values_length(struct le_vec_jagged const *j) {
+    return j->live;
+}
+
+size_t le_vec_jagged_get_row_length(struct le_vec_jagged const *j, size_t row) {
+    return j->rows[row].length;
+}
+
+static bool is_at_end(struct le_vec_jagged const *j, struct row const *r) {
+    return r->start + r->length == j->values_end;
+}
+
+// Expands values so that `extra` more fit after the used part. Rows keep their positions.
+static void reserve_values(struct le_vec_jagged *j, size_t extra) {
+    size_t request = j->values_end + extra;
+    if (request <= j->values_capacity) {
+        return;
+    }
+
+    size_t capacity = j->values_capacity;
+    while (capacity < request) {
+        capacity *= 2;
+    }
+
+    j->values = realloc(j->values, capacity * sizeof(LE_VEC_TYPE));
+    j->values_capacity = capacity;
+}
+
+void le_vec_jagged_compact(struct le_vec_jagged *j) {
+    size_t capacity = j->live > LE_VEC_DEFAULT_CAPACITY ? j->live : LE_VEC_DEFAULT_CAPACITY;
+    if (j->compact) {
+        if (j->values_capacity > capacity) {
+            j->values = realloc(j->values, capacity * sizeof(LE_VEC_TYPE));
+            j->values_capacity = capacity;
+        }
+        return;
+    }
+
+    LE_VEC_TYPE *values = malloc(capacity * sizeof(LE_VEC_TYPE));
+    size_t end = 0;
+
+    for (size_t row = 0; row < j->rows_length; row++) {
+        struct row *r = &j->rows[row];
+        memcpy(values + end, j->values + r->start, r->length * sizeof(LE_VEC_TYPE));
+        r->start = end;
+        end += r->length;
+    }
+
+    free(j->values);
+    j->values = values;
+    j->values_capacity = capacity;
+    j->values_end = end;
+    j->compact = true;
+}
+
+// Pushes `length` values after the last element of row, moving row to the end of the buffer if needed.
+static void append_to_row(struct le_vec_jagged *j, size_t row, LE_VEC_TYPE const *values, size_t length) {
+    if (j->values_end - j->live > j->live) {
+        le_vec_jagged_compact(j);
+    }
+
+    struct row *r = &j->rows[row];
+    if (is_at_end(j, r)) {
+        reserve_values(j, length);
+    } else {
+        // Old place of row becomes a hole
+        reserve_values(j, r->length + length);
+        memcpy(j->values + j->values_end, j->values + r->start, r->length * sizeof(LE_VEC_TYPE));
+        r->start = j->values_end;
+        j->values_end += r->length;
+        j->compact = false;
+    }
+
+    if (length > 0) {
+        memcpy(j->values + j->values_end, values, length * sizeof(LE_VEC_TYPE));
+    }
+    r->length += length;
+    j->values_end += length;
+    j->live += length;
+}
+
+void le_vec_jagged_push_row(struct le_vec_jagged *j, LE_VEC_TYPE const *values, size_t length) {
+    if (j->rows_length >= j->rows_capacity) {
+        j->rows_capacity *= 2;
+        j->rows = realloc(j->rows, j->rows_capacity * sizeof(struct row));
+    }
+
+    struct row *r = &j->rows[j->rows_length++];
+    r->start = j->values_end;
+    r->length = 0;
+    if (length > 0) {
+        append_to_row(j, j->rows_length - 1, values, length);
+    }
+}
+
+void le_vec_jagged_push_back(struct le_vec_jagged *j, LE_VEC_TYPE value) {
+    if (j->rows_length == 0) {
+        le_vec_jagged_push_row(j, NULL, 0);
+    }
+
+    struct row *r = &j->rows[j->rows_length - 1];
+    // Fast path of building: the last row sits at the end of the buffer
+    if (is_at_end(j, r) && j->values_end < j->values_capacity) {
+        j->values[j->values_end++] = value;
+        r->length++;
+        j->live++;
+        return;
+    }
+
+    append_to_row(j, j->rows_length - 1, &value, 1);
+}
+
+bool le_vec_jagged_pop_row(struct le_vec_jagged *j) {
+    if (j->rows_length == 0) {
+        return false;
+    }
+
+    struct row *r = &j->rows[j->rows_length - 1];
+    if (is_at_end(j, r)) {
+        j->values_end = r->start;
+    }
+    j->live -= r->length;
+    j->rows_length--;
+
+    return true;
+}
+
+LE_VEC_TYPE le_vec_jagged_get_at(struct le_vec_jagged const *j, size_t row, size_t index) {
+    return j->values[j->rows[row].start + index];
+}
+
+bool le_vec_jagged_set_at(struct le_vec_jagged *j, size_t row, size_t index, LE_VEC_TYPE value) {
+    if (row >= j->rows_length || index >= j->rows[row].length) {
+        return false;
+    }
+
+    j->values[j->rows[row].start + index] = value;
+    return true;
+}
+
+bool le_vec_jagged_row_push_back(struct le_vec_jagged *j, size_t row, LE_VEC_TYPE value) {
+    if (row >= j->rows_length) {
+        return false;
+    }
+
+    append_to_row(j, row, &value, 1);
+    return true;
+}
+
+bool le_vec_jagged_set_row(struct le_vec_jagged *j, size_t row, LE_VEC_TYPE const *values, size_t length) {
+    if (row >= j->rows_length) {
+        return false;
+    }
+
+    struct row *r = &j->rows[row];
+    if (length <= r->length) {
+        if (length > 0) {
+            memcpy(j->values + r->start, values, length * sizeof(LE_VEC_TYPE));
+        }
+        if (is_at_end(j, r)) {
+            j->values_end = r->start + length;
+        } else if (length < r->length) {
+            j->compact = false;
+        }
+        j->live -= r->length - length;
+        r->length = length;
+        return true;
+    }
+
+    // Row is emptied, so that growing it copies only the new values
+    if (is_at_end(j, r)) {
+        j->values_end = r->start;
+    } else {
+        r->start = j->values_end;
+        j->compact = false;
+    }
+    j->live -= r->length;
+    r->length = 0;
+    append_to_row(j, row, values, length);
+
+    return true;
+}
+
+struct le_vec const *le_vec_jagged_row(struct le_vec_jagged *j, size_t row) {
+    if (row >= j->rows_length) {
+        return NULL;
+    }
+
+    struct le_vec *v = &j->row_view;
+    v->capacity = j->rows[row].length;
+    v->length = j->rows[row].length;
+    v->data = j->values + j->rows[row].start;
+
+    return v;
+}
+
+struct le_vec const *le_vec_jagged_values(struct le_vec_jagged *j) {
+    le_vec_jagged_compact(j);
+
+    struct le_vec *v = &j->values_view;
+    v->capacity = j->values_capacity;
+    v->length = j->live;
+    v->data = j->values;
+
+    return v;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+
+// Jagged (ragged) array: many variable-length rows sharing a single values buffer (CSR layout).
+// A row costs a (start, length) pair instead of a le_vec header and its own allocation,
+// and rows laid out one after another are scanned sequentially.
+// Rows are built by appending at the end. A row growing anywhere else is moved to the end of the buffer,
+// leaving a hole behind; holes are dropped by compaction, explicit or automatic.
+struct le_vec_jagged;
+
+// Creates and initiates empty jagged array
+struct le_vec_jagged *le_vec_jagged_init(void);
+// Creates jagged array with a row for each of `length` vectors, in that order. One allocation for all values
+struct le_vec_jagged *le_vec_jagged_init_from_vecs(struct le_vec const *const *vecs, size_t length);
+// Destroys le_vec_jagged.
+void le_vec_jagged_destroy(struct le_vec_jagged *j);
+
+// Returns number of rows
+size_t le_vec_jagged_get_rows_length(struct le_vec_jagged const *j);
+// Returns number of elements in all rows
+size_t le_vec_jagged_get_values_length(struct le_vec_jagged const *j);
+// Returns number of elements in row
+size_t le_vec_jagged_get_row_length(struct le_vec_jagged const *j, size_t row);
+
+// Pushes row with copies of `length` values after the last row (length might be 0)
+void le_vec_jagged_push_row(struct le_vec_jagged *j, LE_VEC_TYPE const *values, size_t length);
+// Pushes value after the last element of the last row (of a new row if there are none). O(1) amortized
+void le_vec_jagged_push_back(struct le_vec_jagged *j, LE_VEC_TYPE value);
+// Removes the last row
+// Returns false if there are no rows
+bool le_vec_jagged_pop_row(struct le_vec_jagged *j);
+
+// Gets element at index of row.
+LE_VEC_TYPE le_vec_jagged_get_at(struct le_vec_jagged const *j, size_t row, size_t index);
+// Sets element at index of row to a new value.
+// Returns false if row or index is out of range
+bool le_vec_jagged_set_at(struct le_vec_jagged *j, size_t row, size_t index, LE_VEC_TYPE value);
+// Pushes value after the last element of row. O(1) amortized for the row at the end of the buffer,
+// other rows are moved there first
+// Returns false if row is out of range
+bool le_vec_jagged_row_push_back(struct le_vec_jagged *j, size_t row, LE_VEC_TYPE value);
+// Replaces elements of row with copies of `length` values. Rows that don't get longer are rewritten in place,
+// others are moved to the end of the buffer
+// Returns false if row is out of range
+bool le_vec_jagged_set_row(struct le_vec_jagged *j, size_t row, LE_VEC_TYPE const *values, size_t length);
+
+// Moves rows next to each other in row order and shrinks buffer to fit them. O(values)
+// Happens by itself when holes take more room than elements of rows
+void le_vec_jagged_compact(struct le_vec_jagged *j);
+
+// Returns row as a read-only vector, to be used with any le_vec function that does not modify it
+// (count, find, copy, ...). There is one row view per jagged array: it is valid until the next call
+// of le_vec_jagged_row() or change of the array.
+// Returns NULL if row is out of range
+struct le_vec const *le_vec_jagged_row(struct le_vec_jagged *j, size_t row);
+// Returns elements of all rows in row order as a read-only vector, compacting the array first if needed.
+// Valid until the next change of the array.
+struct le_vec const *le_vec_jagged_values(struct le_vec_jagged *j);
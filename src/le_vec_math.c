@@ -0,0 +1,407 @@
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_math.h"
+#include "le_vec_simd.h"
+
+enum op {
+    OP_ADD,
+    OP_SUBTRACT,
+    OP_MULTIPLY,
+    OP_ADD_SCALAR,
+    OP_SUBTRACT_SCALAR,
+    OP_MULTIPLY_SCALAR,
+    OP_AXPY,
+    OP_CLAMP,
+    OP_ABS,
+};
+
+// dst[i] = op(a[i], b[i]), where b is only read by operations between two vectors.
+// Scalar operand, axpy factor and clamp low bound are all `k`.
+struct operands {
+    LE_VEC_TYPE *dst;
+    LE_VEC_TYPE const *a;
+    LE_VEC_TYPE const *b;
+    size_t length;
+    LE_VEC_TYPE k;
+    LE_VEC_TYPE high;
+};
+
+static LE_VEC_ALWAYS_INLINE bool reads_b(enum op op) {
+    return op == OP_ADD || op == OP_SUBTRACT || op == OP_MULTIPLY || op == OP_AXPY;
+}
+
+// Arithmetic goes through unsigned long long, so that overflow wraps around instead of being undefined
+static LE_VEC_ALWAYS_INLINE LE_VEC_TYPE apply_scalar(enum op op, LE_VEC_TYPE x, LE_VEC_TYPE y, LE_VEC_TYPE k, LE_VEC_TYPE high) {
+    unsigned long long ux = (unsigned long long)x;
+    unsigned long long uy = (unsigned long long)y;
+    unsigned long long uk = (unsigned long long)k;
+
+    switch (op) {
+        case OP_ADD:
+            return (LE_VEC_TYPE)(ux + uy);
+        case OP_SUBTRACT:
+            return (LE_VEC_TYPE)(ux - uy);
+        case OP_MULTIPLY:
+            return (LE_VEC_TYPE)(ux * uy);
+        case OP_ADD_SCALAR:
+            return (LE_VEC_TYPE)(ux + uk);
+        case OP_SUBTRACT_SCALAR:
+            return (LE_VEC_TYPE)(ux - uk);
+        case OP_MULTIPLY_SCALAR:
+            return (LE_VEC_TYPE)(ux * uk);
+        case OP_AXPY:
+            return (LE_VEC_TYPE)(ux + uk * uy);
+        case OP_CLAMP:
+            return x < k ? k : x > high ? high : x;
+        case OP_ABS:
+            return x < 0 ? (LE_VEC_TYPE)(0 - ux) : x;
+    }
+
+    return x;
+}
+
+// Generic loop, `op` is a constant at every call site, so each one compiles to its own tight loop
+static LE_VEC_ALWAYS_INLINE void run_scalar(enum op op, struct operands const *o, size_t i) {
+    for (; i < o->length; i++) {
+        LE_VEC_TYPE y = reads_b(op) ? o->b[i] : 0;
+        o->dst[i] = apply_scalar(op, o->a[i], y, o->k, o->high);
+    }
+}
+
+#ifdef LE_VEC_X86
+LE_VEC_TARGET("avx2")
+static LE_VEC_ALWAYS_INLINE __m256i apply_avx2(enum op op, __m256i x, __m256i y, __m256i k, __m256i high) {
+    switch (op) {
+        case OP_ADD:
+            return _mm256_add_epi32(x, y);
+        case OP_SUBTRACT:
+            return _mm256_sub_epi32(x, y);
+        case OP_MULTIPLY:
+            return _mm256_mullo_epi32(x, y);
+        case OP_ADD_SCALAR:
+            return _mm256_add_epi32(x, k);
+        case OP_SUBTRACT_SCALAR:
+            return _mm256_sub_epi32(x, k);
+        case OP_MULTIPLY_SCALAR:
+            return _mm256_mullo_epi32(x, k);
+        case OP_AXPY:
+            return _mm256_add_epi32(x, _mm256_mullo_epi32(k, y));
+        case OP_CLAMP:
+            return _mm256_min_epi32(_mm256_max_epi32(x, k), high);
+        case OP_ABS:
+            return _mm256_abs_epi32(x);
+    }
+
+    return x;
+}
+
+LE_VEC_TARGET("avx2")
+static LE_VEC_ALWAYS_INLINE void loop_avx2(enum op op, struct operands const *o) {
+    __m256i k = _mm256_set1_epi32(o->k);
+    __m256i high = _mm256_set1_epi32(o->high);
+    __m256i y = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 8 <= o->length; i += 8) {
+        __m256i x = _mm256_loadu_si256((__m256i const *)(o->a + i));
+        if (reads_b(op)) {
+            y = _mm256_loadu_si256((__m256i const *)(o->b + i));
+        }
+        _mm256_storeu_si256((__m256i *)(o->dst + i), apply_avx2(op, x, y, k, high));
+    }
+
+    run_scalar(op, o, i);
+}
+
+LE_VEC_TARGET("avx512f")
+static LE_VEC_ALWAYS_INLINE __m512i apply_avx512(enum op op, __m512i x, __m512i y, __m512i k, __m512i high) {
+    switch (op) {
+        case OP_ADD:
+            return _mm512_add_epi32(x, y);
+        case OP_SUBTRACT:
+            return _mm512_sub_epi32(x, y);
+        case OP_MULTIPLY:
+            return _mm512_mullo_epi32(x, y);
+        case OP_ADD_SCALAR:
+            return _mm512_add_epi32(x, k);
+        case OP_SUBTRACT_SCALAR:
+            return _mm512_sub_epi32(x, k);
+        case OP_MULTIPLY_SCALAR:
+            return _mm512_mullo_epi32(x, k);
+        case OP_AXPY:
+            return _mm512_add_epi32(x, _mm512_mullo_epi32(k, y));
+        case OP_CLAMP:
+            return _mm512_min_epi32(_mm512_max_epi32(x, k), high);
+        case OP_ABS:
+            return _mm512_abs_epi32(x);
+    }
+
+    return x;
+}
+
+// Tail is done with a masked load and store instead of a scalar loop
+LE_VEC_TARGET("avx512f")
+static LE_VEC_ALWAYS_INLINE void loop_avx512(enum op op, struct operands const *o) {
+    __m512i k = _mm512_set1_epi32(o->k);
+    __m512i high = _mm512_set1_epi32(o->high);
+    __m512i y = _mm512_setzero_si512();
+
+    for (size_t i = 0; i < o->length; i += 16) {
+        size_t left = o->length - i;
+        __mmask16 mask = left >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << left) - 1);
+
+        __m512i x = _mm512_maskz_loadu_epi32(mask, o->a + i);
+        if (reads_b(op)) {
+            y = _mm512_maskz_loadu_epi32(mask, o->b + i);
+        }
+        _mm512_mask_storeu_epi32(o->dst + i, mask, apply_avx512(op, x, y, k, high));
+    }
+}
+
+LE_VEC_TARGET("avx512f")
+static void run_avx512(enum op op, struct operands const *o) {
+    switch (op) {
+        case OP_ADD: loop_avx512(OP_ADD, o); break;
+        case OP_SUBTRACT: loop_avx512(OP_SUBTRACT, o); break;
+        case OP_MULTIPLY: loop_avx512(OP_MULTIPLY, o); break;
+        case OP_ADD_SCALAR: loop_avx512(OP_ADD_SCALAR, o); break;
+        case OP_SUBTRACT_SCALAR: loop_avx512(OP_SUBTRACT_SCALAR, o); break;
+        case OP_MULTIPLY_SCALAR: loop_avx512(OP_MULTIPLY_SCALAR, o); break;
+        case OP_AXPY: loop_avx512(OP_AXPY, o); break;
+        case OP_CLAMP: loop_avx512(OP_CLAMP, o); break;
+        case OP_ABS: loop_avx512(OP_ABS, o); break;
+    }
+}
+
+LE_VEC_TARGET("avx2")
+static void run_avx2(enum op op, struct operands const *o) {
+    switch (op) {
+        case OP_ADD: loop_avx2(OP_ADD, o); break;
+        case OP_SUBTRACT: loop_avx2(OP_SUBTRACT, o); break;
+        case OP_MULTIPLY: loop_avx2(OP_MULTIPLY, o); break;
+        case OP_ADD_SCALAR: loop_avx2(OP_ADD_SCALAR, o); break;
+        case OP_SUBTRACT_SCALAR: loop_avx2(OP_SUBTRACT_SCALAR, o); break;
+        case OP_MULTIPLY_SCALAR: loop_avx2(OP_MULTIPLY_SCALAR, o); break;
+        case OP_AXPY: loop_avx2(OP_AXPY, o); break;
+        case OP_CLAMP: loop_avx2(OP_CLAMP, o); break;
+        case OP_ABS: loop_avx2(OP_ABS, o); break;
+    }
+}
+#endif
+
+static void run_generic(enum op op, struct operands const *o) {
+    switch (op) {
+        case OP_ADD: run_scalar(OP_ADD, o, 0); break;
+        case OP_SUBTRACT: run_scalar(OP_SUBTRACT, o, 0); break;
+        case OP_MULTIPLY: run_scalar(OP_MULTIPLY, o, 0); break;
+        case OP_ADD_SCALAR: run_scalar(OP_ADD_SCALAR, o, 0); break;
+        case OP_SUBTRACT_SCALAR: run_scalar(OP_SUBTRACT_SCALAR, o, 0); break;
+        case OP_MULTIPLY_SCALAR: run_scalar(OP_MULTIPLY_SCALAR, o, 0); break;
+        case OP_AXPY: run_scalar(OP_AXPY, o, 0); break;
+        case OP_CLAMP: run_scalar(OP_CLAMP, o, 0); break;
+        case OP_ABS: run_scalar(OP_ABS, o, 0); break;
+    }
+}
+
+static void run(enum op op, struct operands const *o) {
+#ifdef LE_VEC_X86
+    if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx512f")) {
+        run_avx512(op, o);
+        return;
+    }
+    if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx2")) {
+        run_avx2(op, o);
+        return;
+    }
+#endif
+    run_generic(op, o);
+}
+
+// Runs op with v as the destination and the first operand
+static void apply(enum op op, struct le_vec *v, struct le_vec const *other, LE_VEC_TYPE k, LE_VEC_TYPE high) {
+    struct operands o = {v->data, v->data, other != NULL ? other->data : NULL, le_vec_get_length(v), k, high};
+    run(op, &o);
+    LE_VEC_MARK_DIRTY(v, 0, o.length);
+}
+
+// Runs op into a new vector
+static struct le_vec *applied(enum op op, struct le_vec const *v, struct le_vec const *other, LE_VEC_TYPE k, LE_VEC_TYPE high) {
+    size_t length = le_vec_get_length(v);
+    struct le_vec *new_v = _le_vec_create(length > 0 ? length : LE_VEC_DEFAULT_CAPACITY, length);
+
+    struct operands o = {new_v->data, v->data, other != NULL ? other->data : NULL, length, k, high};
+    run(op, &o);
+
+    return new_v;
+}
+
+static bool lengths_equal(struct le_vec const *a, struct le_vec const *b) {
+    return le_vec_get_length(a) == le_vec_get_length(b);
+}
+
+bool le_vec_add(struct le_vec *v, struct le_vec const *other) {
+    if (!lengths_equal(v, other)) {
+        return false;
+    }
+
+    apply(OP_ADD, v, other, 0, 0);
+    return true;
+}
+
+struct le_vec *le_vec_added(struct le_vec const *v, struct le_vec const *other) {
+    return lengths_equal(v, other) ? applied(OP_ADD, v, other, 0, 0) : NULL;
+}
+
+bool le_vec_subtract(struct le_vec *v, struct le_vec const *other) {
+    if (!lengths_equal(v, other)) {
+        return false;
+    }
+
+    apply(OP_SUBTRACT, v, other, 0, 0);
+    return true;
+}
+
+struct le_vec *le_vec_subtracted(struct le_vec const *v, struct le_vec const *other) {
+    return lengths_equal(v, other) ? applied(OP_SUBTRACT, v, other, 0, 0) : NULL;
+}
+
+bool le_vec_multiply(struct le_vec *v, struct le_vec const *other) {
+    if (!lengths_equal(v, other)) {
+        return false;
+    }
+
+    apply(OP_MULTIPLY, v, other, 0, 0);
+    return true;
+}
+
+struct le_vec *le_vec_multiplied(struct le_vec const *v, struct le_vec const *other) {
+    return lengths_equal(v, other) ? applied(OP_MULTIPLY, v, other, 0, 0) : NULL;
+}
+
+void le_vec_add_scalar(struct le_vec *v, LE_VEC_TYPE value) {
+    apply(OP_ADD_SCALAR, v, NULL, value, 0);
+}
+
+struct le_vec *le_vec_added_scalar(struct le_vec const *v, LE_VEC_TYPE value) {
+    return applied(OP_ADD_SCALAR, v, NULL, value, 0);
+}
+
+void le_vec_subtract_scalar(struct le_vec *v, LE_VEC_TYPE value) {
+    apply(OP_SUBTRACT_SCALAR, v, NULL, value, 0);
+}
+
+struct le_vec *le_vec_subtracted_scalar(struct le_vec const *v, LE_VEC_TYPE value) {
+    return applied(OP_SUBTRACT_SCALAR, v, NULL, value, 0);
+}
+
+void le_vec_multiply_scalar(struct le_vec *v, LE_VEC_TYPE value) {
+    apply(OP_MULTIPLY_SCALAR, v, NULL, value, 0);
+}
+
+struct le_vec *le_vec_multiplied_scalar(struct le_vec const *v, LE_VEC_TYPE value) {
+    return applied(OP_MULTIPLY_SCALAR, v, NULL, value, 0);
+}
+
+bool le_vec_axpy(struct le_vec *y, LE_VEC_TYPE factor, struct le_vec const *x) {
+    if (!lengths_equal(y, x)) {
+        return false;
+    }
+
+    apply(OP_AXPY, y, x, factor, 0);
+    return true;
+}
+
+bool le_vec_clamp(struct le_vec *v, LE_VEC_TYPE low, LE_VEC_TYPE high) {
+    if (low > high) {
+        return false;
+    }
+
+    apply(OP_CLAMP, v, NULL, low, high);
+    return true;
+}
+
+struct le_vec *le_vec_clamped(struct le_vec const *v, LE_VEC_TYPE low, LE_VEC_TYPE high) {
+    return low <= high ? applied(OP_CLAMP, v, NULL, low, high) : NULL;
+}
+
+void le_vec_abs(struct le_vec *v) {
+    apply(OP_ABS, v, NULL, 0, 0);
+}
+
+struct le_vec *le_vec_absolute(struct le_vec const *v) {
+    return applied(OP_ABS, v, NULL, 0, 0);
+}
+
+static long long dot_scalar(LE_VEC_TYPE const *a, LE_VEC_TYPE const *b, size_t length, size_t i) {
+    unsigned long long sum = 0;
+    for (; i < length; i++) {
+        sum += (unsigned long long)((long long)a[i] * (long long)b[i]);
+    }
+
+    return (long long)sum;
+}
+
+#ifdef LE_VEC_X86
+// _mul_epi32 multiplies even lanes into full 64-bit products, odd lanes are shifted down to be multiplied the same way
+LE_VEC_TARGET("avx2")
+static long long dot_avx2(LE_VEC_TYPE const *a, LE_VEC_TYPE const *b, size_t length) {
+    __m256i even = _mm256_setzero_si256();
+    __m256i odd = _mm256_setzero_si256();
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        __m256i x = _mm256_loadu_si256((__m256i const *)(a + i));
+        __m256i y = _mm256_loadu_si256((__m256i const *)(b + i));
+        even = _mm256_add_epi64(even, _mm256_mul_epi32(x, y));
+        odd = _mm256_add_epi64(odd, _mm256_mul_epi32(_mm256_srli_epi64(x, 32), _mm256_srli_epi64(y, 32)));
+    }
+
+    __m256i sum = _mm256_add_epi64(even, odd);
+    __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+    unsigned long long total = (unsigned long long)_mm_cvtsi128_si64(half) + (unsigned long long)_mm_extract_epi64(half, 1);
+
+    return (long long)(total + (unsigned long long)dot_scalar(a, b, length, i));
+}
+
+LE_VEC_TARGET("avx512f")
+static long long dot_avx512(LE_VEC_TYPE const *a, LE_VEC_TYPE const *b, size_t length) {
+    __m512i even = _mm512_setzero_si512();
+    __m512i odd = _mm512_setzero_si512();
+
+    for (size_t i = 0; i < length; i += 16) {
+        size_t left = length - i;
+        __mmask16 mask = left >= 16 ? (__mmask16)0xFFFF : (__mmask16)((1u << left) - 1);
+
+        __m512i x = _mm512_maskz_loadu_epi32(mask, a + i);
+        __m512i y = _mm512_maskz_loadu_epi32(mask, b + i);
+        even = _mm512_add_epi64(even, _mm512_mul_epi32(x, y));
+        odd = _mm512_add_epi64(odd, _mm512_mul_epi32(_mm512_srli_epi64(x, 32), _mm512_srli_epi64(y, 32)));
+    }
+
+    return _mm512_reduce_add_epi64(_mm512_add_epi64(even, odd));
+}
+#endif
+
+long long le_vec_dot(struct le_vec const *a, struct le_vec const *b, bool *success) {
+    bool equal = lengths_equal(a, b);
+    if (success != NULL) {
+        *success = equal;
+    }
+    if (!equal) {
+        return 0;
+    }
+
+    size_t length = le_vec_get_length(a);
+#ifdef LE_VEC_X86
+    if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx512f")) {
+        return dot_avx512(a->data, b->data, length);
+    }
+    if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx2")) {
+        return dot_avx2(a->data, b->data, length);
+    }
+#endif
+    return dot_scalar(a->data, b->data, length, 0);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+
+// Element-wise arithmetic on vectors.
+// Operations between two vectors need equal lengths, which is checked once before any work is done.
+// Results wrap around on overflow.
+
+// Adds elements of other to corresponding elements of v
+// Returns false (v is not changed) if lengths differ
+bool le_vec_add(struct le_vec *v, struct le_vec const *other);
+// Creates a vector of sums of corresponding elements
+// Returns NULL if lengths differ
+struct le_vec *le_vec_added(struct le_vec const *v, struct le_vec const *other);
+// Subtracts elements of other from corresponding elements of v
+// Returns false (v is not changed) if lengths differ
+bool le_vec_subtract(struct le_vec *v, struct le_vec const *other);
+// Creates a vector of differences of corresponding elements
+// Returns NULL if lengths differ
+struct le_vec *le_vec_subtracted(struct le_vec const *v, struct le_vec const *other);
+// Multiplies elements of v by corresponding elements of other
+// Returns false (v is not changed) if lengths differ
+bool le_vec_multiply(struct le_vec *v, struct le_vec const *other);
+// Creates a vector of products of corresponding elements
+// Returns NULL if lengths differ
+struct le_vec *le_vec_multiplied(struct le_vec const *v, struct le_vec const *other);
+
+// Adds value to each element
+void le_vec_add_scalar(struct le_vec *v, LE_VEC_TYPE value);
+// Creates a vector of elements plus value
+struct le_vec *le_vec_added_scalar(struct le_vec const *v, LE_VEC_TYPE value);
+// Subtracts value from each element
+void le_vec_subtract_scalar(struct le_vec *v, LE_VEC_TYPE value);
+// Creates a vector of elements minus value
+struct le_vec *le_vec_subtracted_scalar(struct le_vec const *v, LE_VEC_TYPE value);
+// Multiplies each element by value
+void le_vec_multiply_scalar(struct le_vec *v, LE_VEC_TYPE value);
+// Creates a vector of elements times value
+struct le_vec *le_vec_multiplied_scalar(struct le_vec const *v, LE_VEC_TYPE value);
+
+// Adds `factor` times elements of x to corresponding elements of y (y += factor * x)
+// Returns false (y is not changed) if lengths differ
+bool le_vec_axpy(struct le_vec *y, LE_VEC_TYPE factor, struct le_vec const *x);
+
+// Limits each element to [low; high]
+// Returns false (v is not changed) if low > high
+bool le_vec_clamp(struct le_vec *v, LE_VEC_TYPE low, LE_VEC_TYPE high);
+// Creates a vector of elements limited to [low; high]
+// Returns NULL if low > high
+struct le_vec *le_vec_clamped(struct le_vec const *v, LE_VEC_TYPE low, LE_VEC_TYPE high);
+// Replaces each element with its absolute value (the smallest LE_VEC_TYPE stays as is)
+void le_vec_abs(struct le_vec *v);
+// Creates a vector of absolute values of elements
+struct le_vec *le_vec_absolute(struct le_vec const *v);
+
+// Returns sum of products of corresponding elements, accumulated in long long
+// If lengths differ - success = false and 0 is returned (success might be NULL)
+long long le_vec_dot(struct le_vec const *a, struct le_vec const *b, bool *success);
@@ -0,0 +1,226 @@
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_numa.h"
+
+// Nodes beyond this are ignored
+#define MAX_NODES 64
+#define NODEMASK_BITS CPU_SETSIZE
+#define NODEMASK_WORDS (NODEMASK_BITS / (8 * sizeof(unsigned long)))
+
+// From <linux/mempolicy.h>, which is not always installed
+#define MPOL_DEFAULT 0
+#define MPOL_PREFERRED 1
+#define MPOL_INTERLEAVE 3
+#define MPOL_MF_MOVE (1 << 1)
+
+static pthread_once_t topology_once = PTHREAD_ONCE_INIT;
+// Ids of online nodes, stays a single node 0 unless topology says otherwise
+static size_t nodes_length = 1;
+static int nodes[MAX_NODES];
+static cpu_set_t node_cpus[MAX_NODES];
+
+// Reads sysfs list like "0-3,8,10-11" into set.
+static bool read_list(const char *path, cpu_set_t *set) {
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        return false;
+    }
+
+    CPU_ZERO(set);
+
+    int first;
+    while (fscanf(f, "%d", &first) == 1) {
+        int last = first;
+        int c = fgetc(f);
+        if (c == '-') {
+            if (fscanf(f, "%d", &last) != 1) {
+                break;
+            }
+            c = fgetc(f);
+        }
+
+        for (int i = first; i <= last && i < CPU_SETSIZE; i++) {
+            CPU_SET(i, set);
+        }
+        if (c != ',') {
+            break;
+        }
+    }
+
+    fclose(f);
+    return true;
+}
+
+static void read_topology(void) {
+    cpu_set_t online;
+    if (!read_list("/sys/devices/system/node/online", &online)) {
+        return;
+    }
+
+    size_t length = 0;
+    for (int node = 0; node < CPU_SETSIZE && length < MAX_NODES; node++) {
+        if (!CPU_ISSET(node, &online)) {
+            continue;
+        }
+
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+        if (!read_list(path, &node_cpus[length])) {
+            CPU_ZERO(&node_cpus[length]);
+        }
+        nodes[length++] = node;
+    }
+
+    if (length > 1) {
+        nodes_length = length;
+    }
+}
+
+size_t le_vec_numa_node_count(void) {
+    pthread_once(&topology_once, read_topology);
+    return nodes_length;
+}
+
+// Returns index (in nodes) of node that keeps chunk `chunk` out of `chunks`
+static size_t chunk_node_index(size_t chunks, size_t chunk) {
+    return chunk * le_vec_numa_node_count() / chunks;
+}
+
+int _le_vec_chunk_node(size_t chunks, size_t chunk) {
+    return nodes[chunk_node_index(chunks, chunk)];
+}
+
+void _le_vec_numa_pin_current_thread(int node) {
+    for (size_t i = 0; i < le_vec_numa_node_count(); i++) {
+        if (nodes[i] == node && CPU_COUNT(&node_cpus[i]) > 0) {
+            sched_setaffinity(0, sizeof(cpu_set_t), &node_cpus[i]);
+            return;
+        }
+    }
+}
+
+static bool is_node_online(int node) {
+    for (size_t i = 0; i < le_vec_numa_node_count(); i++) {
+        if (nodes[i] == node) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void add_node(unsigned long *mask, int node) {
+    size_t word_bits = 8 * sizeof(unsigned long);
+    mask[node / word_bits] |= 1ul << (node % word_bits);
+}
+
+// Sets memory policy of whole pages inside [address; address + bytes).
+// Pages shared with neighbouring allocations are left alone.
+static bool bind_pages(void *address, size_t bytes, int mode, unsigned long const *mask, unsigned flags) {
+#ifdef SYS_mbind
+    uintptr_t page = (uintptr_t)sysconf(_SC_PAGESIZE);
+    uintptr_t start = ((uintptr_t)address + page - 1) & ~(page - 1);
+    uintptr_t end = ((uintptr_t)address + bytes) & ~(page - 1);
+    if (end <= start) {
+        return true;
+    }
+
+    unsigned long max_node = mask != NULL ? NODEMASK_BITS + 1 : 0;
+    return syscall(SYS_mbind, start, end - start, mode, mask, max_node, flags) == 0;
+#else
+    (void)address;
+    (void)bytes;
+    (void)mode;
+    (void)mask;
+    (void)flags;
+    return false;
+#endif
+}
+
+static bool place(LE_VEC_TYPE *data, size_t length, enum le_vec_placement placement, int node, unsigned flags) {
+    if (le_vec_numa_node_count() <= 1) {
+        return false;
+    }
+
+    unsigned long mask[NODEMASK_WORDS] = {0};
+    size_t bytes = length * sizeof(LE_VEC_TYPE);
+
+    switch (placement) {
+        case LE_VEC_PLACEMENT_DEFAULT:
+            return bind_pages(data, bytes, MPOL_DEFAULT, NULL, flags);
+        case LE_VEC_PLACEMENT_INTERLEAVED:
+            for (size_t i = 0; i < nodes_length; i++) {
+                add_node(mask, nodes[i]);
+            }
+            return bind_pages(data, bytes, MPOL_INTERLEAVE, mask, flags);
+        case LE_VEC_PLACEMENT_NODE:
+            if (!is_node_online(node)) {
+                return false;
+            }
+            add_node(mask, node);
+            return bind_pages(data, bytes, MPOL_PREFERRED, mask, flags);
+        case LE_VEC_PLACEMENT_PARTITIONED: {
+            // Same chunks as in parallel algorithms, their threads are pinned to these nodes
+            size_t chunks = _le_vec_parallel_chunks(length);
+            bool success = true;
+
+            for (size_t chunk = 0; chunk < chunks; chunk++) {
+                size_t start = _le_vec_chunk_start(length, chunks, chunk);
+                size_t end = _le_vec_chunk_start(length, chunks, chunk + 1);
+
+                memset(mask, 0, sizeof(mask));
+                add_node(mask, _le_vec_chunk_node(chunks, chunk));
+                success = bind_pages(data + start, (end - start) * sizeof(LE_VEC_TYPE), MPOL_PREFERRED, mask, flags) && success;
+            }
+            return success;
+        }
+    }
+
+    return false;
+}
+
+struct zero_fill {
+    LE_VEC_TYPE *data;
+    size_t length;
+    size_t chunks;
+};
+
+static void zero_chunk(void *arg, size_t chunk) {
+    struct zero_fill *z = arg;
+    size_t start = _le_vec_chunk_start(z->length, z->chunks, chunk);
+    size_t end = _le_vec_chunk_start(z->length, z->chunks, chunk + 1);
+
+    memset(z->data + start, 0, (end - start) * sizeof(LE_VEC_TYPE));
+}
+
+struct le_vec *le_vec_init_placed(size_t request, enum le_vec_placement placement, int node) {
+    if (request == 0) {
+        return NULL;
+    }
+
+    struct le_vec *v = _le_vec_create(request, request);
+    place(v->data, request, placement, node, 0);
+
+    // Zeroing is the first touch of fresh pages. Done by the same threads as parallel algorithms,
+    // so even with default placement every chunk lands on the node of its thread.
+    struct zero_fill z = {v->data, request, _le_vec_parallel_chunks(request)};
+    _le_vec_parallel_run(z.chunks, zero_chunk, &z);
+
+    return v;
+}
+
+bool le_vec_place(struct le_vec *v, enum le_vec_placement placement, int node) {
+    return place(v->data, le_vec_get_length(v), placement, node, MPOL_MF_MOVE);
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+
+// NUMA placement of vector data on multi-socket machines.
+// Implemented with raw mbind() syscalls, no libnuma needed. On single-node machines
+// (or without NUMA support in kernel) placement is skipped and vectors behave as usual.
+// Placement applies to the current data buffer only, reallocations (growth, shrinking) might lose it.
+
+enum le_vec_placement {
+    // Kernel default: a page lands on the node of the thread that touches it first
+    LE_VEC_PLACEMENT_DEFAULT,
+    // Pages are spread round-robin over all nodes
+    LE_VEC_PLACEMENT_INTERLEAVED,
+    // Pages are placed on a given node (or others, if it runs out of memory)
+    LE_VEC_PLACEMENT_NODE,
+    // Each chunk processed by parallel algorithms is placed on the node its thread runs on
+    LE_VEC_PLACEMENT_PARTITIONED,
+};
+
+// Returns number of NUMA nodes, 1 on non-NUMA machines
+size_t le_vec_numa_node_count(void);
+
+// Creates le_vec with requested length, zero-filled by parallel threads with pages placed as requested
+// `node` is used only with LE_VEC_PLACEMENT_NODE
+// Returns NULL if request is 0
+struct le_vec *le_vec_init_placed(size_t request, enum le_vec_placement placement, int node);
+// Migrates pages of vector according to placement
+// Returns false if nothing was done: single node, NUMA not supported or node is invalid
+bool le_vec_place(struct le_vec *v, enum le_vec_placement placement, int node);
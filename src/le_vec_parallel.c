@@ -0,0 +1,109 @@
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_numa.h"
+
+// 0 - one thread per CPU the process may run on
+static size_t thread_count = 0;
+
+struct worker {
+    pthread_t thread;
+    void (*task)(void *arg, size_t chunk);
+    void *arg;
+    size_t chunk;
+    // NUMA node to run on, -1 for any
+    int node;
+};
+
+void le_vec_set_thread_count(size_t count) {
+    thread_count = count;
+}
+
+size_t le_vec_get_thread_count(void) {
+    if (thread_count != 0) {
+        return thread_count;
+    }
+
+    // Affinity mask honours taskset and cpusets of containers, online CPUs might be way more
+    cpu_set_t allowed;
+    if (sched_getaffinity(0, sizeof(allowed), &allowed) == 0) {
+        return (size_t)CPU_COUNT(&allowed);
+    }
+
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (size_t)cpus : 1;
+}
+
+size_t _le_vec_parallel_chunks(size_t length) {
+    size_t chunks = length / _LE_VEC_PARALLEL_GRAIN;
+    if (chunks <= 1) {
+        return 1;
+    }
+
+    // Checked only now, since a syscall is way more expensive than a scan of a short vector
+    size_t threads = le_vec_get_thread_count();
+    return chunks < threads ? chunks : threads;
+}
+
+size_t _le_vec_chunk_start(size_t length, size_t chunks, size_t chunk) {
+    // Rounded to 16 elements, so that chunks don't share cache lines
+    return chunk == chunks ? length : (length / chunks * chunk) & ~(size_t)15;
+}
+
+static void *run_worker(void *arg) {
+    struct worker *w = arg;
+    if (w->node >= 0) {
+        _le_vec_numa_pin_current_thread(w->node);
+    }
+    w->task(w->arg, w->chunk);
+
+    return NULL;
+}
+
+void _le_vec_parallel_run(size_t chunks, void (*task)(void *arg, size_t chunk), void *arg) {
+    if (chunks <= 1) {
+        task(arg, 0);
+        return;
+    }
+
+    // With several NUMA nodes every chunk gets a thread pinned to the node keeping its data
+    // (see LE_VEC_PLACEMENT_PARTITIONED), otherwise the calling thread takes chunk 0
+    bool numa = le_vec_numa_node_count() > 1;
+    size_t first = numa ? 0 : 1;
+
+    struct worker *workers = malloc(chunks * sizeof(struct worker));
+    // Chunks that failed to get a thread are run by the calling thread
+    bool *started = calloc(chunks, sizeof(bool));
+
+    for (size_t chunk = first; chunk < chunks; chunk++) {
+        struct worker *w = &workers[chunk];
+        w->task = task;
+        w->arg = arg;
+        w->chunk = chunk;
+        w->node = numa ? _le_vec_chunk_node(chunks, chunk) : -1;
+        started[chunk] = pthread_create(&w->thread, NULL, run_worker, w) == 0;
+    }
+
+    if (!numa) {
+        task(arg, 0);
+    }
+
+    for (size_t chunk = first; chunk < chunks; chunk++) {
+        if (started[chunk]) {
+            pthread_join(workers[chunk].thread, NULL);
+        } else {
+            task(arg, chunk);
+        }
+    }
+
+    free(started);
+    free(workers);
+}
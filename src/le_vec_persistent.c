@@ -0,0 +1,723 @@
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_persistent.h"
+
+#define BITS 5
+#define WIDTH (1 << BITS)
+// Concatenation redistributes nodes until there are at most EXTRAS more of them than optimal,
+// nodes with more than WIDTH - INVARIANT slots used are left as they are
+#define EXTRAS 2
+#define INVARIANT 1
+
+// Height of a node is measured in shifts: leaves are at 0, their parents at BITS and so on.
+// Nodes are passed around by their common header, the height tells whether one is a leaf or a branch.
+struct node {
+    _Atomic size_t refs;
+    // Number of values in a leaf, number of children in a branch
+    size_t count;
+};
+
+struct leaf {
+    struct node header;
+    LE_VEC_TYPE values[WIDTH];
+};
+
+// Branches always have size tables (sizes[i] - number of elements in children [0; i]), for
+// balanced branches lookup still finds the child at the first guess.
+struct branch {
+    struct node header;
+    size_t sizes[WIDTH];
+    struct node *children[WIDTH];
+};
+
+struct le_vec_persistent {
+    size_t length;
+    // Height of root, >= BITS if there is a root
+    unsigned shift;
+    // Branch with all elements but the tail, NULL if there are none
+    struct node *root;
+    // Leaf with 1..WIDTH last elements, NULL only if vector is empty
+    struct node *tail;
+};
+
+struct le_vec_transient {
+    struct le_vec_persistent v;
+};
+
+static size_t node_bytes(unsigned shift) {
+    return shift == 0 ? sizeof(struct leaf) : sizeof(struct branch);
+}
+
+static struct leaf *as_leaf(struct node const *n) {
+    return (struct leaf *)n;
+}
+
+static struct branch *as_branch(struct node const *n) {
+    return (struct branch *)n;
+}
+
+static struct node *node_create(unsigned shift) {
+    struct node *n = malloc(node_bytes(shift));
+    atomic_init(&n->refs, 1);
+    n->count = 0;
+    return n;
+}
+
+static struct node *node_ref(struct node *n) {
+    atomic_fetch_add_explicit(&n->refs, 1, memory_order_relaxed);
+    return n;
+}
+
+static void node_unref(struct node *n, unsigned shift) {
+    if (n == NULL || atomic_fetch_sub_explicit(&n->refs, 1, memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    if (shift > 0) {
+        for (size_t i = 0; i < n->count; i++) {
+            node_unref(as_branch(n)->children[i], shift - BITS);
+        }
+    }
+    free(n);
+}
+
+static size_t node_size(struct node const *n, unsigned shift) {
+    return shift == 0 ? n->count : as_branch(n)->sizes[n->count - 1];
+}
+
+// Recomputes size table of branch from child `from` on.
+static void update_sizes(struct node *n, unsigned shift, size_t from) {
+    size_t total = from > 0 ? as_branch(n)->sizes[from - 1] : 0;
+    for (size_t i = from; i < n->count; i++) {
+        total += node_size(as_branch(n)->children[i], shift - BITS);
+        as_branch(n)->sizes[i] = total;
+    }
+}
+
+// Returns node the caller may modify in place: n itself if the caller's reference is the only one,
+// a copy otherwise (the caller's reference to n is given up).
+static struct node *editable(struct node *n, unsigned shift) {
+    if (atomic_load_explicit(&n->refs, memory_order_acquire) == 1) {
+        return n;
+    }
+
+    struct node *copy = malloc(node_bytes(shift));
+    memcpy(copy, n, node_bytes(shift));
+    atomic_init(&copy->refs, 1);
+    if (shift > 0) {
+        for (size_t i = 0; i < copy->count; i++) {
+            node_ref(as_branch(copy)->children[i]);
+        }
+    }
+
+    node_unref(n, shift);
+    return copy;
+}
+
+// Finds child of branch holding element at index, index becomes relative to the child.
+// No child holds more than 1 << shift elements, so the child is never left of index >> shift.
+static size_t find_child(struct node const *n, unsigned shift, size_t *index) {
+    size_t slot = *index >> shift;
+    while (as_branch(n)->sizes[slot] <= *index) {
+        slot++;
+    }
+    if (slot > 0) {
+        *index -= as_branch(n)->sizes[slot - 1];
+    }
+
+    return slot;
+}
+
+static size_t tail_offset(struct le_vec_persistent const *v) {
+    return v->length - (v->tail != NULL ? v->tail->count : 0);
+}
+
+static struct le_vec_persistent *handle_create(void) {
+    struct le_vec_persistent *v = malloc(sizeof(struct le_vec_persistent));
+    v->length = 0;
+    v->shift = 0;
+    v->root = NULL;
+    v->tail = NULL;
+    return v;
+}
+
+// Makes dst share all nodes with src, modifications of dst copy shared nodes they touch
+static void handle_share(struct le_vec_persistent *dst, struct le_vec_persistent const *src) {
+    *dst = *src;
+    if (dst->root != NULL) {
+        node_ref(dst->root);
+    }
+    if (dst->tail != NULL) {
+        node_ref(dst->tail);
+    }
+}
+
+static struct le_vec_persistent *handle_clone(struct le_vec_persistent const *v) {
+    struct le_vec_persistent *clone = malloc(sizeof(struct le_vec_persistent));
+    handle_share(clone, v);
+    return clone;
+}
+
+static void handle_release(struct le_vec_persistent *v) {
+    node_unref(v->root, v->shift);
+    node_unref(v->tail, 0);
+}
+
+static LE_VEC_TYPE get_at(struct le_vec_persistent const *v, size_t index) {
+    size_t offset = tail_offset(v);
+    if (index >= offset) {
+        return as_leaf(v->tail)->values[index - offset];
+    }
+
+    struct node const *n = v->root;
+    for (unsigned shift = v->shift; shift > 0; shift -= BITS) {
+        n = as_branch(n)->children[find_child(n, shift, &index)];
+    }
+    return as_leaf(n)->values[index];
+}
+
+static void set_at(struct le_vec_persistent *v, size_t index, LE_VEC_TYPE value) {
+    size_t offset = tail_offset(v);
+    if (index >= offset) {
+        v->tail = editable(v->tail, 0);
+        as_leaf(v->tail)->values[index - offset] = value;
+        return;
+    }
+
+    struct node **slot = &v->root;
+    for (unsigned shift = v->shift; shift > 0; shift -= BITS) {
+        struct node *n = *slot = editable(*slot, shift);
+        slot = &as_branch(n)->children[find_child(n, shift, &index)];
+    }
+    *slot = editable(*slot, 0);
+    as_leaf(*slot)->values[index] = value;
+}
+
+// Checks if a leaf can be appended under branch without growing its height
+static bool has_room(struct node const *n, unsigned shift) {
+    if (n->count < WIDTH) {
+        return true;
+    }
+    return shift > BITS && has_room(as_branch(n)->children[n->count - 1], shift - BITS);
+}
+
+// Chain of single-child branches from height shift down to leaf
+static struct node *new_path(unsigned shift, struct node *leaf) {
+    if (shift == 0) {
+        return leaf;
+    }
+
+    struct node *n = node_create(shift);
+    as_branch(n)->children[0] = new_path(shift - BITS, leaf);
+    n->count = 1;
+    update_sizes(n, shift, 0);
+    return n;
+}
+
+// Appends leaf after the last one under branch, has_room(n, shift) must hold
+static struct node *append_leaf(struct node *n, unsigned shift, struct node *leaf) {
+    n = editable(n, shift);
+    struct node **last = &as_branch(n)->children[n->count - 1];
+
+    if (shift > BITS && has_room(*last, shift - BITS)) {
+        *last = append_leaf(*last, shift - BITS, leaf);
+    } else {
+        as_branch(n)->children[n->count++] = new_path(shift - BITS, leaf);
+    }
+
+    update_sizes(n, shift, n->count - 1);
+    return n;
+}
+
+// Moves leaf (which might be partly filled) to the end of the tree
+static void push_leaf(struct le_vec_persistent *v, struct node *leaf) {
+    if (v->root == NULL) {
+        v->root = new_path(BITS, leaf);
+        v->shift = BITS;
+    } else if (has_room(v->root, v->shift)) {
+        v->root = append_leaf(v->root, v->shift, leaf);
+    } else {
+        struct node *root = node_create(v->shift + BITS);
+        as_branch(root)->children[0] = v->root;
+        as_branch(root)->children[1] = new_path(v->shift, leaf);
+        root->count = 2;
+        update_sizes(root, v->shift + BITS, 0);
+        v->root = root;
+        v->shift += BITS;
+    }
+}
+
+// Removes the last leaf under the branch at *slot and returns it, *slot becomes NULL if no leaves are left
+static struct node *pop_leaf(struct node **slot, unsigned shift) {
+    struct node *n = *slot = editable(*slot, shift);
+    struct node **last = &as_branch(n)->children[n->count - 1];
+    struct node *leaf;
+
+    if (shift == BITS) {
+        leaf = *last;
+        n->count--;
+    } else {
+        leaf = pop_leaf(last, shift - BITS);
+        if (*last == NULL) {
+            n->count--;
+        }
+    }
+
+    if (n->count == 0) {
+        free(n);
+        *slot = NULL;
+    } else {
+        update_sizes(n, shift, n->count - 1);
+    }
+    return leaf;
+}
+
+// Drops single-child branches from the top of the tree
+static void collapse_root(struct le_vec_persistent *v) {
+    while (v->root != NULL && v->shift > BITS && v->root->count == 1) {
+        struct node *child = node_ref(as_branch(v->root)->children[0]);
+        node_unref(v->root, v->shift);
+        v->root = child;
+        v->shift -= BITS;
+    }
+    if (v->root == NULL) {
+        v->shift = 0;
+    }
+}
+
+// Makes the last leaf of the tree the tail if there is no tail
+static void refill_tail(struct le_vec_persistent *v) {
+    if (v->tail == NULL && v->root != NULL) {
+        v->tail = pop_leaf(&v->root, v->shift);
+        collapse_root(v);
+    }
+}
+
+static void push_back(struct le_vec_persistent *v, LE_VEC_TYPE value) {
+    if (v->tail == NULL) {
+        v->tail = node_create(0);
+    } else if (v->tail->count == WIDTH) {
+        push_leaf(v, v->tail);
+        v->tail = node_create(0);
+    } else {
+        v->tail = editable(v->tail, 0);
+    }
+
+    as_leaf(v->tail)->values[v->tail->count++] = value;
+    v->length++;
+}
+
+static void pop_back(struct le_vec_persistent *v) {
+    v->length--;
+    if (v->tail->count > 1) {
+        v->tail = editable(v->tail, 0);
+        v->tail->count--;
+        return;
+    }
+
+    node_unref(v->tail, 0);
+    v->tail = NULL;
+    refill_tail(v);
+}
+
+static size_t min_size(size_t a, size_t b) {
+    return a < b ? a : b;
+}
+
+// Chooses new slot counts for nodes so that there are at most EXTRAS more of them than optimal
+// (the search step invariant of RRB-trees), moving as few slots as possible. Returns number of nodes.
+static size_t plan_concat(struct node *const *nodes, size_t length, size_t *counts) {
+    size_t total = 0;
+    for (size_t i = 0; i < length; i++) {
+        counts[i] = nodes[i]->count;
+        total += counts[i];
+    }
+    counts[length] = 0;
+
+    size_t optimal = (total + WIDTH - 1) / WIDTH;
+    size_t i = 0;
+    while (optimal + EXTRAS < length) {
+        while (counts[i] > WIDTH - INVARIANT) {
+            i++;
+        }
+
+        // Spreads slots of the short node over the following ones, which frees one node
+        size_t remaining = counts[i];
+        do {
+            size_t count = min_size(remaining + counts[i + 1], WIDTH);
+            remaining = remaining + counts[i + 1] - count;
+            counts[i] = count;
+            i++;
+        } while (remaining > 0);
+
+        memmove(counts + i, counts + i + 1, (length - i) * sizeof(size_t));
+        length--;
+        i--;
+    }
+
+    return length;
+}
+
+// Builds nodes of planned counts with slots of nodes in order, reusing nodes that keep their slots
+static void execute_concat(struct node *const *nodes, size_t const *counts, size_t length, unsigned shift, struct node **result) {
+    size_t index = 0;
+    size_t offset = 0;
+
+    for (size_t i = 0; i < length; i++) {
+        if (offset == 0 && nodes[index]->count == counts[i]) {
+            result[i] = node_ref(nodes[index++]);
+            continue;
+        }
+
+        struct node *n = node_create(shift);
+        while (n->count < counts[i]) {
+            struct node const *source = nodes[index];
+            size_t copied = min_size(counts[i] - n->count, source->count - offset);
+            if (shift == 0) {
+                memcpy(as_leaf(n)->values + n->count, as_leaf(source)->values + offset, copied * sizeof(LE_VEC_TYPE));
+            } else {
+                for (size_t j = 0; j < copied; j++) {
+                    as_branch(n)->children[n->count + j] = node_ref(as_branch(source)->children[offset + j]);
+                }
+            }
+
+            n->count += copied;
+            offset += copied;
+            if (offset == source->count) {
+                index++;
+                offset = 0;
+            }
+        }
+
+        if (shift > 0) {
+            update_sizes(n, shift, 0);
+        }
+        result[i] = n;
+    }
+}
+
+// Merges children of left (but the last one), middle and right (but the first one), all at height shift,
+// returns branch at height shift + BITS with one or two children. left and right might be NULL.
+static struct node *rebalance(struct node *left, struct node *middle, struct node *right, unsigned shift) {
+    // Each of left and right gives at most WIDTH - 1 children and middle at most 2
+    struct node *nodes[2 * WIDTH];
+    size_t length = 0;
+
+    if (left != NULL) {
+        memcpy(nodes, as_branch(left)->children, (left->count - 1) * sizeof(struct node *));
+        length += left->count - 1;
+    }
+    memcpy(nodes + length, as_branch(middle)->children, middle->count * sizeof(struct node *));
+    length += middle->count;
+    if (right != NULL) {
+        memcpy(nodes + length, as_branch(right)->children + 1, (right->count - 1) * sizeof(struct node *));
+        length += right->count - 1;
+    }
+
+    size_t counts[2 * WIDTH + 1];
+    struct node *merged[2 * WIDTH];
+    length = plan_concat(nodes, length, counts);
+    execute_concat(nodes, counts, length, shift - BITS, merged);
+
+    struct node *top = node_create(shift + BITS);
+    for (size_t start = 0; start < length; start += WIDTH) {
+        struct node *n = node_create(shift);
+        n->count = min_size(length - start, WIDTH);
+        memcpy(as_branch(n)->children, merged + start, n->count * sizeof(struct node *));
+        update_sizes(n, shift, 0);
+        as_branch(top)->children[top->count++] = n;
+    }
+    update_sizes(top, shift + BITS, 0);
+
+    return top;
+}
+
+// Returns branch one level above the higher of left and right with one or two children
+// holding elements of left followed by elements of right
+static struct node *concat_trees(struct node *left, unsigned left_shift, struct node *right, unsigned right_shift) {
+    struct node *middle;
+    struct node *result;
+
+    if (left_shift > right_shift) {
+        middle = concat_trees(as_branch(left)->children[left->count - 1], left_shift - BITS, right, right_shift);
+        result = rebalance(left, middle, NULL, left_shift);
+        node_unref(middle, left_shift);
+    } else if (left_shift < right_shift) {
+        middle = concat_trees(left, left_shift, as_branch(right)->children[0], right_shift - BITS);
+        result = rebalance(NULL, middle, right, right_shift);
+        node_unref(middle, right_shift);
+    } else if (left_shift == 0) {
+        result = node_create(BITS);
+        if (left->count + right->count <= WIDTH) {
+            struct node *leaf = node_create(0);
+            memcpy(as_leaf(leaf)->values, as_leaf(left)->values, left->count * sizeof(LE_VEC_TYPE));
+            memcpy(as_leaf(leaf)->values + left->count, as_leaf(right)->values, right->count * sizeof(LE_VEC_TYPE));
+            leaf->count = left->count + right->count;
+            as_branch(result)->children[result->count++] = leaf;
+        } else {
+            as_branch(result)->children[result->count++] = node_ref(left);
+            as_branch(result)->children[result->count++] = node_ref(right);
+        }
+        update_sizes(result, BITS, 0);
+    } else {
+        middle = concat_trees(as_branch(left)->children[left->count - 1], left_shift - BITS, as_branch(right)->children[0], right_shift - BITS);
+        result = rebalance(left, middle, right, left_shift);
+        node_unref(middle, left_shift);
+    }
+
+    return result;
+}
+
+// Keeps first `keep` (>= 1) elements under n
+static struct node *slice_right(struct node *n, unsigned shift, size_t keep) {
+    if (keep == node_size(n, shift)) {
+        return n;
+    }
+
+    n = editable(n, shift);
+    if (shift == 0) {
+        n->count = keep;
+        return n;
+    }
+
+    size_t index = keep - 1;
+    size_t slot = find_child(n, shift, &index);
+    for (size_t i = slot + 1; i < n->count; i++) {
+        node_unref(as_branch(n)->children[i], shift - BITS);
+    }
+    n->count = slot + 1;
+    as_branch(n)->children[slot] = slice_right(as_branch(n)->children[slot], shift - BITS, index + 1);
+    update_sizes(n, shift, slot);
+    return n;
+}
+
+// Drops first `drop` (< size) elements under n
+static struct node *slice_left(struct node *n, unsigned shift, size_t drop) {
+    if (drop == 0) {
+        return n;
+    }
+
+    n = editable(n, shift);
+    if (shift == 0) {
+        n->count -= drop;
+        memmove(as_leaf(n)->values, as_leaf(n)->values + drop, n->count * sizeof(LE_VEC_TYPE));
+        return n;
+    }
+
+    size_t slot = find_child(n, shift, &drop);
+    for (size_t i = 0; i < slot; i++) {
+        node_unref(as_branch(n)->children[i], shift - BITS);
+    }
+    n->count -= slot;
+    memmove(as_branch(n)->children, as_branch(n)->children + slot, n->count * sizeof(struct node *));
+    as_branch(n)->children[0] = slice_left(as_branch(n)->children[0], shift - BITS, drop);
+    update_sizes(n, shift, 0);
+    return n;
+}
+
+static void copy_values(struct node const *n, unsigned shift, LE_VEC_TYPE *dst) {
+    if (shift == 0) {
+        memcpy(dst, as_leaf(n)->values, n->count * sizeof(LE_VEC_TYPE));
+        return;
+    }
+
+    for (size_t i = 0; i < n->count; i++) {
+        copy_values(as_branch(n)->children[i], shift - BITS, dst + (i > 0 ? as_branch(n)->sizes[i - 1] : 0));
+    }
+}
+
+struct le_vec_persistent *le_vec_persistent_init(void) {
+    return handle_create();
+}
+
+struct le_vec_persistent *le_vec_persistent_init_from_vec(struct le_vec const *v) {
+    struct le_vec_persistent *p = handle_create();
+    size_t length = le_vec_get_length(v);
+
+    // The tail takes the last 1..WIDTH elements, everything before it goes in full leaves
+    size_t start = 0;
+    for (; length - start > WIDTH; start += WIDTH) {
+        struct node *leaf = node_create(0);
+        memcpy(as_leaf(leaf)->values, v->data + start, WIDTH * sizeof(LE_VEC_TYPE));
+        leaf->count = WIDTH;
+        push_leaf(p, leaf);
+    }
+    if (start < length) {
+        p->tail = node_create(0);
+        memcpy(as_leaf(p->tail)->values, v->data + start, (length - start) * sizeof(LE_VEC_TYPE));
+        p->tail->count = length - start;
+    }
+
+    p->length = length;
+    return p;
+}
+
+void le_vec_persistent_destroy(struct le_vec_persistent *p) {
+    handle_release(p);
+    free(p);
+}
+
+struct le_vec *le_vec_persistent_to_vec(struct le_vec_persistent const *p) {
+    struct le_vec *v = le_vec_init();
+    le_vec_resize(v, p->length);
+
+    if (p->root != NULL) {
+        copy_values(p->root, p->shift, v->data);
+    }
+    if (p->tail != NULL) {
+        memcpy(v->data + tail_offset(p), as_leaf(p->tail)->values, p->tail->count * sizeof(LE_VEC_TYPE));
+    }
+
+    return v;
+}
+
+size_t le_vec_persistent_get_length(struct le_vec_persistent const *p) {
+    return p->length;
+}
+
+bool le_vec_persistent_is_empty(struct le_vec_persistent const *p) {
+    return p->length == 0;
+}
+
+LE_VEC_TYPE le_vec_persistent_get_at(struct le_vec_persistent const *p, size_t index) {
+    return get_at(p, index);
+}
+
+struct le_vec_persistent *le_vec_persistent_set_at(struct le_vec_persistent const *p, size_t index, LE_VEC_TYPE value) {
+    if (index >= p->length) {
+        return NULL;
+    }
+
+    struct le_vec_persistent *result = handle_clone(p);
+    set_at(result, index, value);
+    return result;
+}
+
+struct le_vec_persistent *le_vec_persistent_push_back(struct le_vec_persistent const *p, LE_VEC_TYPE value) {
+    struct le_vec_persistent *result = handle_clone(p);
+    push_back(result, value);
+    return result;
+}
+
+struct le_vec_persistent *le_vec_persistent_pop_back(struct le_vec_persistent const *p) {
+    if (p->length == 0) {
+        return NULL;
+    }
+
+    struct le_vec_persistent *result = handle_clone(p);
+    pop_back(result);
+    return result;
+}
+
+struct le_vec_persistent *le_vec_persistent_concat(struct le_vec_persistent const *a, struct le_vec_persistent const *b) {
+    if (a->length == 0) {
+        return handle_clone(b);
+    }
+
+    struct le_vec_persistent *result = handle_clone(a);
+    if (b->root == NULL) {
+        // Appending at most WIDTH elements one by one keeps leaves full
+        for (size_t i = 0; b->tail != NULL && i < b->tail->count; i++) {
+            push_back(result, as_leaf(b->tail)->values[i]);
+        }
+        return result;
+    }
+
+    push_leaf(result, result->tail);
+    struct node *root = concat_trees(result->root, result->shift, b->root, b->shift);
+    node_unref(result->root, result->shift);
+
+    result->shift = (result->shift > b->shift ? result->shift : b->shift) + BITS;
+    result->root = root;
+    result->tail = node_ref(b->tail);
+    result->length += b->length;
+    collapse_root(result);
+    return result;
+}
+
+struct le_vec_persistent *le_vec_persistent_slice(struct le_vec_persistent const *p, size_t start, size_t end) {
+    if (start > end || end > p->length) {
+        return NULL;
+    }
+
+    struct le_vec_persistent *result = handle_create();
+    if (start == end) {
+        return result;
+    }
+
+    size_t offset = tail_offset(p);
+    result->length = end - start;
+    if (start < offset) {
+        size_t tree_end = end < offset ? end : offset;
+        result->root = slice_left(slice_right(node_ref(p->root), p->shift, tree_end), p->shift, start);
+        result->shift = p->shift;
+        collapse_root(result);
+    }
+
+    if (end <= offset) {
+        refill_tail(result);
+    } else if (start <= offset && end == p->length) {
+        result->tail = node_ref(p->tail);
+    } else {
+        size_t from = start > offset ? start - offset : 0;
+        result->tail = node_create(0);
+        result->tail->count = end - offset - from;
+        memcpy(as_leaf(result->tail)->values, as_leaf(p->tail)->values + from, result->tail->count * sizeof(LE_VEC_TYPE));
+    }
+
+    return result;
+}
+
+struct le_vec_transient *le_vec_persistent_transient(struct le_vec_persistent const *p) {
+    struct le_vec_transient *t = malloc(sizeof(struct le_vec_transient));
+    handle_share(&t->v, p);
+    return t;
+}
+
+struct le_vec_persistent *le_vec_transient_persistent(struct le_vec_transient *t) {
+    struct le_vec_persistent *p = malloc(sizeof(struct le_vec_persistent));
+    *p = t->v;
+    free(t);
+    return p;
+}
+
+void le_vec_transient_destroy(struct le_vec_transient *t) {
+    handle_release(&t->v);
+    free(t);
+}
+
+size_t le_vec_transient_get_length(struct le_vec_transient const *t) {
+    return t->v.length;
+}
+
+LE_VEC_TYPE le_vec_transient_get_at(struct le_vec_transient const *t, size_t index) {
+    return get_at(&t->v, index);
+}
+
+bool le_vec_transient_set_at(struct le_vec_transient *t, size_t index, LE_VEC_TYPE value) {
+    if (index >= t->v.length) {
+        return false;
+    }
+
+    set_at(&t->v, index, value);
+    return true;
+}
+
+void le_vec_transient_push_back(struct le_vec_transient *t, LE_VEC_TYPE value) {
+    push_back(&t->v, value);
+}
+
+bool le_vec_transient_pop_back(struct le_vec_transient *t) {
+    if (t->v.length == 0) {
+        return false;
+    }
+
+    pop_back(&t->v);
+    return true;
+}
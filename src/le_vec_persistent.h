@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+
+// Persistent (immutable) vector
+// A relaxed radix-balanced tree of 32-way nodes plus a tail of up to 32 last elements.
+// Every modification returns a new version and leaves the old one intact; versions share
+// all nodes except the O(log32 n) ones on the changed paths, so keeping many versions is cheap.
+// Versions are independent handles: each must be destroyed, in any order.
+// Nodes are reference counted atomically, versions may be read and derived from in different threads.
+struct le_vec_persistent;
+
+// Transient (mutable) vector for building a persistent one by many modifications
+// Works in place on nodes it owns alone and copies shared nodes once, so a batch of modifications
+// costs about the same as on le_vec, while versions it was made from stay intact.
+struct le_vec_transient;
+
+// Creates empty persistent vector
+struct le_vec_persistent *le_vec_persistent_init(void);
+// Creates persistent vector with elements of vector. O(n)
+struct le_vec_persistent *le_vec_persistent_init_from_vec(struct le_vec const *v);
+// Destroys version of persistent vector (nodes shared with other versions stay alive)
+void le_vec_persistent_destroy(struct le_vec_persistent *p);
+
+// Creates a regular le_vec with all elements of persistent vector. O(n)
+struct le_vec *le_vec_persistent_to_vec(struct le_vec_persistent const *p);
+
+// Returns number of elements
+size_t le_vec_persistent_get_length(struct le_vec_persistent const *p);
+// Checks if vector empty (does not contain any elements)
+bool le_vec_persistent_is_empty(struct le_vec_persistent const *p);
+
+// Gets element at index. O(log32 n), O(1) for the last 32 elements
+LE_VEC_TYPE le_vec_persistent_get_at(struct le_vec_persistent const *p, size_t index);
+
+// Creates version with element at index set to a new value. O(log32 n)
+// Returns NULL if index is invalid
+struct le_vec_persistent *le_vec_persistent_set_at(struct le_vec_persistent const *p, size_t index, LE_VEC_TYPE value);
+// Creates version with value pushed after the last element. O(1) amortized
+struct le_vec_persistent *le_vec_persistent_push_back(struct le_vec_persistent const *p, LE_VEC_TYPE value);
+// Creates version without the last element. O(1) amortized
+// Returns NULL if vector is empty
+struct le_vec_persistent *le_vec_persistent_pop_back(struct le_vec_persistent const *p);
+// Creates version with elements of a followed by elements of b. O(log32 n)
+struct le_vec_persistent *le_vec_persistent_concat(struct le_vec_persistent const *a, struct le_vec_persistent const *b);
+// Creates version with [start; end) elements (might be empty). O(log32 n)
+// Returns NULL if something is wrong with indexes
+struct le_vec_persistent *le_vec_persistent_slice(struct le_vec_persistent const *p, size_t start, size_t end);
+
+// Creates transient vector with elements of persistent one. O(1)
+struct le_vec_transient *le_vec_persistent_transient(struct le_vec_persistent const *p);
+// Turns transient vector into persistent one. O(1)
+// Transient vector is destroyed, later modifications of the result create new versions as usual
+struct le_vec_persistent *le_vec_transient_persistent(struct le_vec_transient *t);
+// Destroys transient vector without making a persistent one
+void le_vec_transient_destroy(struct le_vec_transient *t);
+
+// Returns number of elements
+size_t le_vec_transient_get_length(struct le_vec_transient const *t);
+// Gets element at index. O(log32 n)
+LE_VEC_TYPE le_vec_transient_get_at(struct le_vec_transient const *t, size_t index);
+// Sets element at index to a new value in place
+// Returns false if index is invalid
+bool le_vec_transient_set_at(struct le_vec_transient *t, size_t index, LE_VEC_TYPE value);
+// Pushes element after the last element in place
+void le_vec_transient_push_back(struct le_vec_transient *t, LE_VEC_TYPE value);
+// Removes the last element in place
+// Returns false if vector is empty
+bool le_vec_transient_pop_back(struct le_vec_transient *t);
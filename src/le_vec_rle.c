@@ -0,0 +1,267 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_rle.h"
+
+struct le_vec_rle {
+    size_t length;
+    size_t runs_capacity;
+    size_t runs_length;
+    LE_VEC_TYPE *values;
+    // Index right after the last element of each run (prefix sum of run lengths)
+    size_t *ends;
+};
+
+// Expands runs so that capacity is >= request.
+static void expand_runs_to_request(struct le_vec_rle *r, size_t request) {
+    size_t capacity = r->runs_capacity;
+    if (capacity >= request) {
+        return;
+    }
+
+    while (capacity < request) {
+        capacity *= 2;
+    }
+
+    r->values = realloc(r->values, capacity * sizeof(LE_VEC_TYPE));
+    r->ends = realloc(r->ends, capacity * sizeof(size_t));
+    r->runs_capacity = capacity;
+}
+
+static size_t run_start(struct le_vec_rle const *r, size_t run) {
+    return run == 0 ? 0 : r->ends[run - 1];
+}
+
+// Returns index of run containing element at index.
+static size_t find_run(struct le_vec_rle const *r, size_t index) {
+    size_t lo = 0;
+    size_t hi = r->runs_length - 1;
+
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (r->ends[mid] <= index) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    return lo;
+}
+
+// Makes room for `n` runs starting at `run`.
+static void insert_runs(struct le_vec_rle *r, size_t run, size_t n) {
+    expand_runs_to_request(r, r->runs_length + n);
+
+    size_t moved = r->runs_length - run;
+    memmove(r->values + run + n, r->values + run, moved * sizeof(LE_VEC_TYPE));
+    memmove(r->ends + run + n, r->ends + run, moved * sizeof(size_t));
+    r->runs_length += n;
+}
+
+// Merges equal neighbouring runs and drops empty ones in [from; to).
+static void merge_runs(struct le_vec_rle *r, size_t from, size_t to) {
+    if (to > r->runs_length) {
+        to = r->runs_length;
+    }
+
+    size_t out = from;
+    for (size_t i = from; i < to; i++) {
+        if (r->ends[i] == run_start(r, out)) {
+            continue;
+        }
+        if (out > 0 && r->values[out - 1] == r->values[i]) {
+            r->ends[out - 1] = r->ends[i];
+            continue;
+        }
+        r->values[out] = r->values[i];
+        r->ends[out] = r->ends[i];
+        out++;
+    }
+
+    size_t moved = r->runs_length - to;
+    memmove(r->values + out, r->values + to, moved * sizeof(LE_VEC_TYPE));
+    memmove(r->ends + out, r->ends + to, moved * sizeof(size_t));
+    r->runs_length = out + moved;
+}
+
+struct le_vec_rle *le_vec_rle_init(void) {
+    struct le_vec_rle *r = malloc(sizeof(struct le_vec_rle));
+
+    r->length = 0;
+    r->runs_capacity = LE_VEC_RLE_DEFAULT_CAPACITY;
+    r->runs_length = 0;
+    r->values = malloc(LE_VEC_RLE_DEFAULT_CAPACITY * sizeof(LE_VEC_TYPE));
+    r->ends = malloc(LE_VEC_RLE_DEFAULT_CAPACITY * sizeof(size_t));
+
+    return r;
+}
+
+struct le_vec_rle *le_vec_rle_init_from_vec(struct le_vec const *v) {
+    struct le_vec_rle *r = le_vec_rle_init();
+
+    size_t v_length = le_vec_get_length(v);
+    for (size_t i = 0; i < v_length; i++) {
+        le_vec_rle_push_back(r, v->data[i]);
+    }
+
+    return r;
+}
+
+void le_vec_rle_destroy(struct le_vec_rle *r) {
+    if (r == NULL) {
+        return;
+    }
+
+    free(r->values);
+    free(r->ends);
+    free(r);
+}
+
+struct le_vec *le_vec_rle_to_vec(struct le_vec_rle const *r) {
+    struct le_vec *v = le_vec_init();
+    le_vec_resize(v, r->length);
+
+    for (size_t run = 0; run < r->runs_length; run++) {
+        LE_VEC_TYPE value = r->values[run];
+        for (size_t i = run_start(r, run); i < r->ends[run]; i++) {
+            v->data[i] = value;
+        }
+    }
+
+    return v;
+}
+
+size_t le_vec_rle_get_length(struct le_vec_rle const *r) {
+    return r->length;
+}
+
+size_t le_vec_rle_get_runs_length(struct le_vec_rle const *r) {
+    return r->runs_length;
+}
+
+size_t le_vec_rle_get_size(struct le_vec_rle const *r) {
+    return r->runs_capacity * (sizeof(LE_VEC_TYPE) + sizeof(size_t));
+}
+
+bool le_vec_rle_is_empty(struct le_vec_rle const *r) {
+    return r->length == 0;
+}
+
+void le_vec_rle_push_back(struct le_vec_rle *r, LE_VEC_TYPE value) {
+    r->length++;
+
+    if (r->runs_length > 0 && r->values[r->runs_length - 1] == value) {
+        r->ends[r->runs_length - 1] = r->length;
+        return;
+    }
+
+    expand_runs_to_request(r, r->runs_length + 1);
+    r->values[r->runs_length] = value;
+    r->ends[r->runs_length] = r->length;
+    r->runs_length++;
+}
+
+LE_VEC_TYPE le_vec_rle_pop_back(struct le_vec_rle *r) {
+    size_t last_run = r->runs_length - 1;
+    LE_VEC_TYPE value = r->values[last_run];
+
+    r->length--;
+    r->ends[last_run] = r->length;
+    if (r->ends[last_run] == run_start(r, last_run)) {
+        r->runs_length--;
+    }
+
+    return value;
+}
+
+LE_VEC_TYPE le_vec_rle_get_at(struct le_vec_rle const *r, size_t index) {
+    return r->values[find_run(r, index)];
+}
+
+bool le_vec_rle_set_at(struct le_vec_rle *r, size_t index, LE_VEC_TYPE value) {
+    if (index >= r->length) {
+        return false;
+    }
+
+    size_t run = find_run(r, index);
+    LE_VEC_TYPE old_value = r->values[run];
+    if (old_value == value) {
+        return true;
+    }
+
+    // Split the run into [start; index) [index] [index + 1; end), then glue equal neighbours
+    size_t end = r->ends[run];
+    insert_runs(r, run + 1, 2);
+
+    r->ends[run] = index;
+    r->values[run + 1] = value;
+    r->ends[run + 1] = index + 1;
+    r->values[run + 2] = old_value;
+    r->ends[run + 2] = end;
+
+    merge_runs(r, run == 0 ? 0 : run - 1, run + 4);
+
+    return true;
+}
+
+size_t le_vec_rle_count(struct le_vec_rle const *r, LE_VEC_TYPE value) {
+    size_t cntr = 0;
+    for (size_t run = 0; run < r->runs_length; run++) {
+        if (r->values[run] == value) {
+            cntr += r->ends[run] - run_start(r, run);
+        }
+    }
+
+    return cntr;
+}
+
+size_t le_vec_rle_find(struct le_vec_rle const *r, LE_VEC_TYPE elem) {
+    return le_vec_rle_find_n(r, elem, 1);
+}
+
+size_t le_vec_rle_find_n(struct le_vec_rle const *r, LE_VEC_TYPE elem, size_t n) {
+    if (n == 0) {
+        return (size_t)-1;
+    }
+
+    size_t cntr = 0;
+    for (size_t run = 0; run < r->runs_length; run++) {
+        if (r->values[run] != elem) {
+            continue;
+        }
+
+        size_t start = run_start(r, run);
+        size_t run_length = r->ends[run] - start;
+        if (cntr + run_length >= n) {
+            return start + (n - cntr - 1);
+        }
+        cntr += run_length;
+    }
+
+    return (size_t)-1;
+}
+
+size_t le_vec_rle_replace_all(struct le_vec_rle *r, LE_VEC_TYPE old_el, LE_VEC_TYPE new_el) {
+    if (old_el == new_el) {
+        return 0;
+    }
+
+    size_t replaced = 0;
+    for (size_t run = 0; run < r->runs_length; run++) {
+        if (r->values[run] == old_el) {
+            r->values[run] = new_el;
+            replaced += r->ends[run] - run_start(r, run);
+        }
+    }
+
+    if (replaced != 0) {
+        merge_runs(r, 0, r->runs_length);
+    }
+
+    return replaced;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+
+// Default number of runs allocated for le_vec_rle
+#define LE_VEC_RLE_DEFAULT_CAPACITY 16
+
+// Run-length encoded vector
+// Stores (value, end index) pairs instead of elements, so long runs of equal values
+// take constant space and most operations cost O(number of runs) instead of O(length).
+struct le_vec_rle;
+
+// Creates and initiates empty le_vec_rle
+struct le_vec_rle *le_vec_rle_init(void);
+// Creates run-length encoded copy of vector
+struct le_vec_rle *le_vec_rle_init_from_vec(struct le_vec const *v);
+// Destroys le_vec_rle.
+void le_vec_rle_destroy(struct le_vec_rle *r);
+
+// Creates a regular le_vec with all elements of run-length encoded vector
+struct le_vec *le_vec_rle_to_vec(struct le_vec_rle const *r);
+
+// Returns number of elements
+size_t le_vec_rle_get_length(struct le_vec_rle const *r);
+// Returns number of runs
+size_t le_vec_rle_get_runs_length(struct le_vec_rle const *r);
+// Returns number of bytes used by runs
+size_t le_vec_rle_get_size(struct le_vec_rle const *r);
+// Checks if vector empty (does not contain any elements)
+bool le_vec_rle_is_empty(struct le_vec_rle const *r);
+
+// Pushes element after the last element. Free if value equals the last one.
+void le_vec_rle_push_back(struct le_vec_rle *r, LE_VEC_TYPE value);
+// Removes and returns element the last element
+LE_VEC_TYPE le_vec_rle_pop_back(struct le_vec_rle *r);
+
+// Gets element at index. O(log runs)
+LE_VEC_TYPE le_vec_rle_get_at(struct le_vec_rle const *r, size_t index);
+// Sets element at index to a new value. Might split a run in up to 3 runs.
+bool le_vec_rle_set_at(struct le_vec_rle *r, size_t index, LE_VEC_TYPE value);
+
+// Returns number of elements with specified value
+size_t le_vec_rle_count(struct le_vec_rle const *r, LE_VEC_TYPE value);
+// Returns index of first elem entry
+// Returns invalid index if not found
+size_t le_vec_rle_find(struct le_vec_rle const *r, LE_VEC_TYPE elem);
+// Returns index of `n`th elem entry
+// Returns invalid index if not found
+size_t le_vec_rle_find_n(struct le_vec_rle const *r, LE_VEC_TYPE elem, size_t n);
+
+// Replaces all `old_el`s with `new_el`, returns number of replaced elements
+size_t le_vec_rle_replace_all(struct le_vec_rle *r, LE_VEC_TYPE old_el, LE_VEC_TYPE new_el);
@@ -0,0 +1,195 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_simd.h"
+
+// Sums wrap around on overflow instead of being undefined
+static inline LE_VEC_TYPE wrapping_add(LE_VEC_TYPE a, LE_VEC_TYPE b) {
+    return (LE_VEC_TYPE)((unsigned long long)a + (unsigned long long)b);
+}
+
+static LE_VEC_TYPE sum_reduce(LE_VEC_TYPE const *src, size_t length) {
+    LE_VEC_TYPE total = 0;
+    for (size_t i = 0; i < length; i++) {
+        total = wrapping_add(total, src[i]);
+    }
+
+    return total;
+}
+
+// Writes running sums of src starting from carry to dst (which might be src).
+// Exclusive scan writes the sum before each element. Returns carry + sum of src.
+static LE_VEC_TYPE sum_scan_scalar(LE_VEC_TYPE const *src, LE_VEC_TYPE *dst, size_t length, LE_VEC_TYPE carry, bool exclusive) {
+    for (size_t i = 0; i < length; i++) {
+        LE_VEC_TYPE value = src[i];
+        LE_VEC_TYPE next = wrapping_add(carry, value);
+        dst[i] = exclusive ? carry : next;
+        carry = next;
+    }
+
+    return carry;
+}
+
+#ifdef LE_VEC_X86
+// In-register scan of 8 lanes: two shifted adds scan each 128-bit half,
+// then the total of the low half is added to the high one.
+LE_VEC_TARGET("avx2")
+static LE_VEC_TYPE sum_scan_avx2(LE_VEC_TYPE const *src, LE_VEC_TYPE *dst, size_t length, LE_VEC_TYPE carry, bool exclusive) {
+    __m256i offset = _mm256_set1_epi32(carry);
+    __m256i last = _mm256_set1_epi32(7);
+    size_t i = 0;
+
+    for (; i + 8 <= length; i += 8) {
+        __m256i x = _mm256_loadu_si256((__m256i const *)(src + i));
+
+        __m256i s = _mm256_add_epi32(x, _mm256_slli_si256(x, 4));
+        s = _mm256_add_epi32(s, _mm256_slli_si256(s, 8));
+        __m256i low_total = _mm256_shuffle_epi32(_mm256_permute2x128_si256(s, s, 0x08), 0xFF);
+        s = _mm256_add_epi32(_mm256_add_epi32(s, low_total), offset);
+
+        _mm256_storeu_si256((__m256i *)(dst + i), exclusive ? _mm256_sub_epi32(s, x) : s);
+        offset = _mm256_permutevar8x32_epi32(s, last);
+    }
+
+    return sum_scan_scalar(src + i, dst + i, length - i, _mm256_cvtsi256_si32(offset), exclusive);
+}
+#endif
+
+static LE_VEC_TYPE sum_scan(LE_VEC_TYPE const *src, LE_VEC_TYPE *dst, size_t length, LE_VEC_TYPE carry, bool exclusive) {
+#ifdef LE_VEC_X86
+    if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx2")) {
+        return sum_scan_avx2(src, dst, length, carry, exclusive);
+    }
+#endif
+    return sum_scan_scalar(src, dst, length, carry, exclusive);
+}
+
+static LE_VEC_TYPE op_reduce(LE_VEC_TYPE const *src, size_t length, LE_VEC_TYPE (*op)(LE_VEC_TYPE, LE_VEC_TYPE)) {
+    LE_VEC_TYPE total = src[0];
+    for (size_t i = 1; i < length; i++) {
+        total = op(total, src[i]);
+    }
+
+    return total;
+}
+
+// Inclusive scan with op. Without carry the first element is taken as is.
+static void op_scan(LE_VEC_TYPE const *src, LE_VEC_TYPE *dst, size_t length, LE_VEC_TYPE (*op)(LE_VEC_TYPE, LE_VEC_TYPE), bool has_carry, LE_VEC_TYPE carry) {
+    size_t i = 0;
+    if (!has_carry && length > 0) {
+        carry = src[0];
+        dst[0] = carry;
+        i = 1;
+    }
+
+    for (; i < length; i++) {
+        carry = op(carry, src[i]);
+        dst[i] = carry;
+    }
+}
+
+// Two-pass parallel scan: every chunk is reduced, totals are scanned sequentially,
+// then every chunk is scanned starting from the total of chunks before it.
+struct scan {
+    LE_VEC_TYPE const *src;
+    LE_VEC_TYPE *dst;
+    size_t length;
+    size_t chunks;
+    // NULL for sums
+    LE_VEC_TYPE (*op)(LE_VEC_TYPE, LE_VEC_TYPE);
+    bool exclusive;
+    // Total of each chunk after the first pass, carry into each chunk before the second
+    LE_VEC_TYPE *carries;
+};
+
+static void reduce_chunk(void *arg, size_t chunk) {
+    struct scan *s = arg;
+    size_t start = _le_vec_chunk_start(s->length, s->chunks, chunk);
+    size_t end = _le_vec_chunk_start(s->length, s->chunks, chunk + 1);
+
+    if (s->op == NULL) {
+        s->carries[chunk] = sum_reduce(s->src + start, end - start);
+    } else {
+        s->carries[chunk] = op_reduce(s->src + start, end - start, s->op);
+    }
+}
+
+static void scan_chunk(void *arg, size_t chunk) {
+    struct scan *s = arg;
+    size_t start = _le_vec_chunk_start(s->length, s->chunks, chunk);
+    size_t end = _le_vec_chunk_start(s->length, s->chunks, chunk + 1);
+
+    if (s->op == NULL) {
+        sum_scan(s->src + start, s->dst + start, end - start, s->carries[chunk], s->exclusive);
+    } else {
+        op_scan(s->src + start, s->dst + start, end - start, s->op, chunk != 0, s->carries[chunk]);
+    }
+}
+
+static void scan(LE_VEC_TYPE const *src, LE_VEC_TYPE *dst, size_t length, LE_VEC_TYPE (*op)(LE_VEC_TYPE, LE_VEC_TYPE), bool exclusive) {
+    size_t chunks = _le_vec_parallel_chunks(length);
+    if (chunks == 1) {
+        if (op == NULL) {
+            sum_scan(src, dst, length, 0, exclusive);
+        } else {
+            op_scan(src, dst, length, op, false, 0);
+        }
+        return;
+    }
+
+    LE_VEC_TYPE *carries = malloc(chunks * sizeof(LE_VEC_TYPE));
+    struct scan s = {src, dst, length, chunks, op, exclusive, carries};
+
+    _le_vec_parallel_run(chunks, reduce_chunk, &s);
+
+    LE_VEC_TYPE carry = carries[0];
+    carries[0] = 0;
+    for (size_t chunk = 1; chunk < chunks; chunk++) {
+        LE_VEC_TYPE total = carries[chunk];
+        carries[chunk] = carry;
+        carry = op == NULL ? wrapping_add(carry, total) : op(carry, total);
+    }
+
+    _le_vec_parallel_run(chunks, scan_chunk, &s);
+
+    free(carries);
+}
+
+static struct le_vec *scanned(struct le_vec const *v, LE_VEC_TYPE (*op)(LE_VEC_TYPE, LE_VEC_TYPE), bool exclusive) {
+    size_t length = le_vec_get_length(v);
+    struct le_vec *new_v = _le_vec_create(length > 0 ? length : LE_VEC_DEFAULT_CAPACITY, length);
+
+    scan(v->data, new_v->data, length, op, exclusive);
+
+    return new_v;
+}
+
+void le_vec_inclusive_scan(struct le_vec *v) {
+    scan(v->data, v->data, le_vec_get_length(v), NULL, false);
+    LE_VEC_MARK_DIRTY(v, 0, le_vec_get_length(v));
+}
+
+struct le_vec *le_vec_inclusive_scanned(struct le_vec const *v) {
+    return scanned(v, NULL, false);
+}
+
+void le_vec_exclusive_scan(struct le_vec *v) {
+    scan(v->data, v->data, le_vec_get_length(v), NULL, true);
+    LE_VEC_MARK_DIRTY(v, 0, le_vec_get_length(v));
+}
+
+struct le_vec *le_vec_exclusive_scanned(struct le_vec const *v) {
+    return scanned(v, NULL, true);
+}
+
+void le_vec_scan(struct le_vec *v, LE_VEC_TYPE (*op)(LE_VEC_TYPE, LE_VEC_TYPE)) {
+    scan(v->data, v->data, le_vec_get_length(v), op, false);
+    LE_VEC_MARK_DIRTY(v, 0, le_vec_get_length(v));
+}
+
+struct le_vec *le_vec_scanned(struct le_vec const *v, LE_VEC_TYPE (*op)(LE_VEC_TYPE, LE_VEC_TYPE)) {
+    return scanned(v, op, false);
+}
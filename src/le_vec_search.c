@@ -0,0 +1,217 @@
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_simd.h"
+
+// Elements are counted in blocks, threads check whether to stop between blocks
+#define BLOCK 4096
+// Serial search starts with a block this short and doubles it up to BLOCK,
+// so that a match near the start costs little more than a plain loop
+#define FIRST_BLOCK 32
+// Longer vectors are searched this far serially before looking up the thread count and spawning threads,
+// both cost more than scanning it
+#define SERIAL_HEAD (16 * BLOCK)
+// Counters of chunks are kept this many size_t apart, so that they don't share cache lines
+#define COUNTER_STRIDE 8
+
+static size_t count_scalar(LE_VEC_TYPE const *data, size_t start, size_t end, LE_VEC_TYPE value) {
+    size_t count = 0;
+    for (size_t i = start; i < end; i++) {
+        count += data[i] == value;
+    }
+
+    return count;
+}
+
+#ifdef LE_VEC_X86
+// Matches are -1 lanes of compare results, subtracting them counts up to BLOCK per lane without overflow
+LE_VEC_TARGET("avx2")
+static size_t count_avx2(LE_VEC_TYPE const *data, size_t start, size_t end, LE_VEC_TYPE value) {
+    __m256i needle = _mm256_set1_epi32(value);
+    __m256i counts = _mm256_setzero_si256();
+    size_t i = start;
+
+    for (; i + 8 <= end; i += 8) {
+        __m256i x = _mm256_loadu_si256((__m256i const *)(data + i));
+        counts = _mm256_sub_epi32(counts, _mm256_cmpeq_epi32(x, needle));
+    }
+
+    uint32_t lanes[8];
+    _mm256_storeu_si256((__m256i *)lanes, counts);
+    size_t count = 0;
+    for (size_t lane = 0; lane < 8; lane++) {
+        count += lanes[lane];
+    }
+
+    return count + count_scalar(data, i, end, value);
+}
+#endif
+
+// Counts elements of data[start; end) equal to value, end - start must be <= BLOCK.
+static size_t count_block(LE_VEC_TYPE const *data, size_t start, size_t end, LE_VEC_TYPE value) {
+#ifdef LE_VEC_X86
+    if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx2")) {
+        return count_avx2(data, start, end, value);
+    }
+#endif
+    return count_scalar(data, start, end, value);
+}
+
+// Returns index of `n`th match in data[start; end) counting from start (or from end if reverse),
+// block must have at least n matches.
+static size_t locate(LE_VEC_TYPE const *data, size_t start, size_t end, LE_VEC_TYPE value, size_t n, bool reverse) {
+    for (size_t i = 0; i < end - start; i++) {
+        size_t index = reverse ? end - 1 - i : start + i;
+        n -= data[index] == value;
+        if (n == 0) {
+            return index;
+        }
+    }
+
+    return (size_t)-1;
+}
+
+// Blocks are numbered in search order: block 0 is the first one for forward search and the last one otherwise
+static size_t block_start(size_t blocks, size_t block, bool reverse) {
+    size_t physical = reverse ? blocks - 1 - block : block;
+    return physical * BLOCK;
+}
+
+static size_t block_end(size_t length, size_t blocks, size_t block, bool reverse) {
+    size_t end = block_start(blocks, block, reverse) + BLOCK;
+    return end < length ? end : length;
+}
+
+// Returns index of `n`th match, or (size_t)-1 with *found set to the number of matches if there are fewer.
+static size_t search_serial(LE_VEC_TYPE const *data, size_t length, LE_VEC_TYPE value, size_t n, bool reverse, size_t *found) {
+    size_t done = 0;
+    size_t size = FIRST_BLOCK;
+    *found = 0;
+
+    while (done < length) {
+        size_t taken = length - done < size ? length - done : size;
+        size_t start = reverse ? length - done - taken : done;
+        size_t count = count_block(data, start, start + taken, value);
+        if (*found + count >= n) {
+            return locate(data, start, start + taken, value, n - *found, reverse);
+        }
+
+        *found += count;
+        done += taken;
+        size = size < BLOCK ? 2 * size : BLOCK;
+    }
+
+    return (size_t)-1;
+}
+
+// Chunks are numbered in search order too. Every chunk publishes how many matches it has counted so far
+// and gives up as soon as earlier chunks together have counted n: the match is certainly before it then.
+struct search {
+    LE_VEC_TYPE const *data;
+    size_t length;
+    LE_VEC_TYPE value;
+    size_t n;
+    bool reverse;
+    size_t blocks;
+    size_t chunks;
+    // counted[chunk * COUNTER_STRIDE] - matches in the blocks chunk has scanned so far
+    _Atomic size_t *counted;
+    // Matches in each scanned block
+    uint32_t *block_counts;
+};
+
+static size_t counted_before(struct search *s, size_t chunk) {
+    size_t total = 0;
+    for (size_t earlier = 0; earlier < chunk; earlier++) {
+        total += atomic_load_explicit(&s->counted[earlier * COUNTER_STRIDE], memory_order_relaxed);
+    }
+
+    return total;
+}
+
+static void search_chunk(void *arg, size_t chunk) {
+    struct search *s = arg;
+    size_t first = _le_vec_chunk_start(s->blocks, s->chunks, chunk);
+    size_t last = _le_vec_chunk_start(s->blocks, s->chunks, chunk + 1);
+    size_t found = 0;
+
+    for (size_t block = first; block < last && found < s->n; block++) {
+        if (counted_before(s, chunk) >= s->n) {
+            return;
+        }
+
+        size_t start = block_start(s->blocks, block, s->reverse);
+        size_t end = block_end(s->length, s->blocks, block, s->reverse);
+        size_t count = count_block(s->data, start, end, s->value);
+        s->block_counts[block] = (uint32_t)count;
+        found += count;
+        atomic_store_explicit(&s->counted[chunk * COUNTER_STRIDE], found, memory_order_relaxed);
+    }
+}
+
+// Chunks before the one holding the match were all scanned to the end: a chunk only stops early
+// when it has n matches itself or earlier chunks have, so walking stops at it or before it.
+static size_t search_parallel(LE_VEC_TYPE const *data, size_t length, LE_VEC_TYPE value, size_t n, bool reverse, size_t chunks) {
+    struct search s = {data, length, value, n, reverse, (length + BLOCK - 1) / BLOCK, chunks, NULL, NULL};
+    s.counted = calloc(chunks * COUNTER_STRIDE, sizeof(_Atomic size_t));
+    s.block_counts = malloc(s.blocks * sizeof(uint32_t));
+
+    _le_vec_parallel_run(chunks, search_chunk, &s);
+
+    size_t found = 0;
+    size_t result = (size_t)-1;
+    for (size_t chunk = 0; chunk < chunks; chunk++) {
+        size_t count = atomic_load_explicit(&s.counted[chunk * COUNTER_STRIDE], memory_order_relaxed);
+        if (found + count < n) {
+            found += count;
+            continue;
+        }
+
+        size_t block = _le_vec_chunk_start(s.blocks, chunks, chunk);
+        while (found + s.block_counts[block] < n) {
+            found += s.block_counts[block];
+            block++;
+        }
+        size_t start = block_start(s.blocks, block, reverse);
+        result = locate(data, start, block_end(length, s.blocks, block, reverse), value, n - found, reverse);
+        break;
+    }
+
+    free(s.counted);
+    free(s.block_counts);
+    return result;
+}
+
+size_t _le_vec_search(LE_VEC_TYPE const *data, size_t length, LE_VEC_TYPE value, size_t n, bool reverse) {
+    if (n == 0) {
+        return (size_t)-1;
+    }
+
+    size_t found;
+    if (length <= SERIAL_HEAD) {
+        return search_serial(data, length, value, n, reverse, &found);
+    }
+
+    // Parallel search covers the rest, which is the part before the head for reverse search
+    size_t rest = length - SERIAL_HEAD;
+    size_t head_start = reverse ? rest : 0;
+    size_t rest_start = reverse ? 0 : SERIAL_HEAD;
+
+    size_t index = search_serial(data + head_start, SERIAL_HEAD, value, n, reverse, &found);
+    if (index != (size_t)-1) {
+        return head_start + index;
+    }
+
+    size_t chunks = _le_vec_parallel_chunks(rest);
+    if (chunks <= 1) {
+        index = search_serial(data + rest_start, rest, value, n - found, reverse, &found);
+    } else {
+        index = search_parallel(data + rest_start, rest, value, n - found, reverse, chunks);
+    }
+    return index != (size_t)-1 ? rest_start + index : index;
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+// Helpers for ISA-specific code paths picked at runtime.
+// Internal, don't include it from outside src/.
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LE_VEC_X86 1
+
+#include <immintrin.h>
+#include <stdint.h>
+
+// Compiles function for given instruction set regardless of global flags
+#define LE_VEC_TARGET(isa) __attribute__((target(isa)))
+// Checks whether running CPU supports given instruction set
+#define LE_VEC_CPU_SUPPORTS(isa) __builtin_cpu_supports(isa)
+
+// Returns permutation for _mm256_permutevar8x32_epi32() that moves 32-bit lanes
+// selected by `mask` (bit per lane) to the front, keeping their order ("left packing").
+// pext picks indices of selected lanes out of 0x0706050403020100, so no lookup table is needed.
+LE_VEC_TARGET("avx2,bmi,bmi2")
+static inline __m256i le_vec_left_pack_permutation(unsigned mask) {
+    uint64_t expanded = _pdep_u64(mask, 0x0101010101010101ull) * 0xFF;
+    uint64_t indexes = _pext_u64(0x0706050403020100ull, expanded);
+    return _mm256_cvtepu8_epi32(_mm_cvtsi64_si128((long long)indexes));
+}
+#endif
+
+// Forces inlining, so that generic body picks up target ISA of the caller
+#define LE_VEC_ALWAYS_INLINE inline __attribute__((always_inline))
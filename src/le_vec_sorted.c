@@ -0,0 +1,742 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_simd.h"
+#include "le_vec_sorted.h"
+
+// Ranges at most this long are sorted with insertion sort
+#define INSERTION_SORT_THRESHOLD 16
+// Set operations switch to galloping once one input is this many times longer
+#define GALLOP_RATIO 32
+// Block kernels write whole SIMD registers, output needs this many spare elements
+#define OUTPUT_SLACK 8
+// Pivots of parallel selection are picked from this many elements
+#define PIVOT_SAMPLE 255
+// Parallel selection gives up on narrowing the range after this many rounds
+#define PARALLEL_SELECT_ROUNDS 8
+// Top-k keeps a heap when k is at most this many times shorter than vector, otherwise selects on a copy
+#define TOP_K_HEAP_RATIO 64
+
+static void swap(LE_VEC_TYPE *a, LE_VEC_TYPE *b) {
+    LE_VEC_TYPE tmp = *a;
+    *a = *b;
+    *b = tmp;
+}
+
+static void insertion_sort(LE_VEC_TYPE *data, size_t length) {
+    for (size_t i = 1; i < length; i++) {
+        LE_VEC_TYPE value = data[i];
+        size_t j = i;
+        for (; j > 0 && data[j - 1] > value; j--) {
+            data[j] = data[j - 1];
+        }
+        data[j] = value;
+    }
+}
+
+static void sift_down(LE_VEC_TYPE *data, size_t root, size_t length) {
+    while (2 * root + 1 < length) {
+        size_t child = 2 * root + 1;
+        if (child + 1 < length && data[child] < data[child + 1]) {
+            child++;
+        }
+        if (data[root] >= data[child]) {
+            return;
+        }
+        swap(&data[root], &data[child]);
+        root = child;
+    }
+}
+
+static void heap_sort(LE_VEC_TYPE *data, size_t length) {
+    for (size_t i = length / 2; i > 0; i--) {
+        sift_down(data, i - 1, length);
+    }
+    for (size_t end = length - 1; end > 0; end--) {
+        swap(&data[0], &data[end]);
+        sift_down(data, 0, end);
+    }
+}
+
+// Hoare partition around median of three, length must be >= 2.
+// Returns split, so that [0; split) <= pivot <= [split; length), both parts are non-empty.
+static size_t partition(LE_VEC_TYPE *data, size_t length) {
+    size_t mid = length / 2;
+    size_t last = length - 1;
+
+    if (data[mid] < data[0]) {
+        swap(&data[mid], &data[0]);
+    }
+    if (data[last] < data[mid]) {
+        swap(&data[last], &data[mid]);
+        if (data[mid] < data[0]) {
+            swap(&data[mid], &data[0]);
+        }
+    }
+    // Median goes first, which keeps the split away from both ends
+    swap(&data[0], &data[mid]);
+
+    LE_VEC_TYPE pivot = data[0];
+    size_t i = 0;
+    size_t j = length;
+
+    while (true) {
+        while (data[i] < pivot) {
+            i++;
+        }
+        do {
+            j--;
+        } while (data[j] > pivot);
+
+        if (i >= j) {
+            return j + 1;
+        }
+        swap(&data[i], &data[j]);
+        i++;
+    }
+}
+
+static void introsort(LE_VEC_TYPE *data, size_t length, size_t depth_limit) {
+    while (length > INSERTION_SORT_THRESHOLD) {
+        if (depth_limit == 0) {
+            heap_sort(data, length);
+            return;
+        }
+        depth_limit--;
+
+        size_t split = partition(data, length);
+
+        // Recursing into the smaller part bounds stack depth by log(length)
+        if (split < length - split) {
+            introsort(data, split, depth_limit);
+            data += split;
+            length -= split;
+        } else {
+            introsort(data + split, length - split, depth_limit);
+            length = split;
+        }
+    }
+
+    insertion_sort(data, length);
+}
+
+static size_t depth_limit_of(size_t length) {
+    size_t depth_limit = 0;
+    for (size_t l = length; l > 1; l /= 2) {
+        depth_limit += 2;
+    }
+    return depth_limit;
+}
+
+void le_vec_sort(struct le_vec *v) {
+    size_t length = le_vec_get_length(v);
+
+    introsort(v->data, length, depth_limit_of(length));
+    LE_VEC_MARK_DIRTY(v, 0, length);
+}
+
+bool le_vec_is_sorted(struct le_vec const *v) {
+    for (size_t i = 1; i < le_vec_get_length(v); i++) {
+        if (v->data[i - 1] > v->data[i]) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Keeps the n + 1 smallest elements in a max-heap at the front, then moves its top to n.
+static void heap_select(LE_VEC_TYPE *data, size_t length, size_t n) {
+    size_t heap_length = n + 1;
+    for (size_t i = heap_length / 2; i > 0; i--) {
+        sift_down(data, i - 1, heap_length);
+    }
+    for (size_t i = heap_length; i < length; i++) {
+        if (data[i] < data[0]) {
+            swap(&data[0], &data[i]);
+            sift_down(data, 0, heap_length);
+        }
+    }
+
+    swap(&data[0], &data[n]);
+}
+
+// Puts the element that belongs at n in sorted order there, so that [0; n) <= data[n] <= (n; length).
+// Quickselect that falls back to heap_select() when partitions keep going badly.
+static void introselect(LE_VEC_TYPE *data, size_t length, size_t n, size_t depth_limit) {
+    while (length > INSERTION_SORT_THRESHOLD) {
+        if (depth_limit == 0) {
+            heap_select(data, length, n);
+            return;
+        }
+        depth_limit--;
+
+        size_t split = partition(data, length);
+        if (n < split) {
+            length = split;
+        } else {
+            data += split;
+            length -= split;
+            n -= split;
+        }
+    }
+
+    insertion_sort(data, length);
+}
+
+// Three-way partition of a range by several threads, out of place: every chunk counts its
+// less and equal elements, then copies each element to its part of buffer, then buffer is copied back
+struct three_way {
+    LE_VEC_TYPE *data;
+    LE_VEC_TYPE *buffer;
+    size_t length;
+    size_t chunks;
+    LE_VEC_TYPE pivot;
+    // Per chunk: numbers of less and equal elements, then offsets of its elements in buffer by part
+    size_t *less;
+    size_t *equal;
+    size_t *greater;
+};
+
+static void count_chunk(void *arg, size_t chunk) {
+    struct three_way *t = arg;
+    size_t start = _le_vec_chunk_start(t->length, t->chunks, chunk);
+    size_t end = _le_vec_chunk_start(t->length, t->chunks, chunk + 1);
+    size_t less = 0;
+    size_t equal = 0;
+
+    for (size_t i = start; i < end; i++) {
+        less += t->data[i] < t->pivot;
+        equal += t->data[i] == t->pivot;
+    }
+
+    t->less[chunk] = less;
+    t->equal[chunk] = equal;
+}
+
+static void distribute_chunk(void *arg, size_t chunk) {
+    struct three_way *t = arg;
+    size_t start = _le_vec_chunk_start(t->length, t->chunks, chunk);
+    size_t end = _le_vec_chunk_start(t->length, t->chunks, chunk + 1);
+    size_t less = t->less[chunk];
+    size_t equal = t->equal[chunk];
+    size_t greater = t->greater[chunk];
+
+    for (size_t i = start; i < end; i++) {
+        LE_VEC_TYPE value = t->data[i];
+        if (value < t->pivot) {
+            t->buffer[less++] = value;
+        } else if (value == t->pivot) {
+            t->buffer[equal++] = value;
+        } else {
+            t->buffer[greater++] = value;
+        }
+    }
+}
+
+static void copy_back_chunk(void *arg, size_t chunk) {
+    struct three_way *t = arg;
+    size_t start = _le_vec_chunk_start(t->length, t->chunks, chunk);
+    size_t end = _le_vec_chunk_start(t->length, t->chunks, chunk + 1);
+
+    memcpy(t->data + start, t->buffer + start, (end - start) * sizeof(LE_VEC_TYPE));
+}
+
+// Pivot close to the n-th element: the matching quantile of an evenly spaced sample,
+// so that one round usually leaves a small fraction of the range
+static LE_VEC_TYPE sample_pivot(LE_VEC_TYPE const *data, size_t length, size_t n) {
+    LE_VEC_TYPE sample[PIVOT_SAMPLE];
+    size_t step = length / PIVOT_SAMPLE;
+    for (size_t i = 0; i < PIVOT_SAMPLE; i++) {
+        sample[i] = data[i * step];
+    }
+
+    introsort(sample, PIVOT_SAMPLE, depth_limit_of(PIVOT_SAMPLE));
+    return sample[n / step < PIVOT_SAMPLE ? n / step : PIVOT_SAMPLE - 1];
+}
+
+// introselect() that narrows ranges long enough to go parallel with three-way partitions first
+static void select_nth(LE_VEC_TYPE *data, size_t length, size_t n) {
+    // Ranges only get shorter, so they never need more chunks than the first one
+    size_t chunks = _le_vec_parallel_chunks(length);
+    LE_VEC_TYPE *buffer = chunks > 1 ? malloc(length * sizeof(LE_VEC_TYPE)) : NULL;
+    size_t *counts = chunks > 1 ? malloc(3 * chunks * sizeof(size_t)) : NULL;
+
+    // Unlucky pivots can't loop for long, the rest is left to introselect() which has a worst case bound
+    for (size_t round = 0; buffer != NULL && counts != NULL && chunks > 1 && round < PARALLEL_SELECT_ROUNDS; round++) {
+        struct three_way t = {data, buffer, length, chunks, sample_pivot(data, length, n), counts, counts + chunks, counts + 2 * chunks};
+        _le_vec_parallel_run(chunks, count_chunk, &t);
+
+        size_t less = 0;
+        size_t equal = 0;
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            less += t.less[chunk];
+            equal += t.equal[chunk];
+        }
+
+        size_t offsets[3] = {0, less, less + equal};
+        for (size_t chunk = 0; chunk < chunks; chunk++) {
+            size_t chunk_length = _le_vec_chunk_start(length, chunks, chunk + 1) - _le_vec_chunk_start(length, chunks, chunk);
+            size_t chunk_less = t.less[chunk];
+            size_t chunk_equal = t.equal[chunk];
+
+            t.less[chunk] = offsets[0];
+            t.equal[chunk] = offsets[1];
+            t.greater[chunk] = offsets[2];
+            offsets[0] += chunk_less;
+            offsets[1] += chunk_equal;
+            offsets[2] += chunk_length - chunk_less - chunk_equal;
+        }
+
+        _le_vec_parallel_run(chunks, distribute_chunk, &t);
+        _le_vec_parallel_run(chunks, copy_back_chunk, &t);
+
+        if (n < less) {
+            length = less;
+        } else if (n < less + equal) {
+            length = 0;
+            break;
+        } else {
+            data += less + equal;
+            length -= less + equal;
+            n -= less + equal;
+        }
+        chunks = _le_vec_parallel_chunks(length);
+    }
+
+    free(counts);
+    free(buffer);
+    if (length > 0) {
+        introselect(data, length, n, depth_limit_of(length));
+    }
+}
+
+bool le_vec_nth_element(struct le_vec *v, size_t n) {
+    size_t length = le_vec_get_length(v);
+    if (n >= length) {
+        return false;
+    }
+
+    select_nth(v->data, length, n);
+    LE_VEC_MARK_DIRTY(v, 0, length);
+    return true;
+}
+
+void le_vec_partial_sort(struct le_vec *v, size_t k) {
+    size_t length = le_vec_get_length(v);
+    if (k == 0) {
+        return;
+    }
+
+    if (k < length) {
+        select_nth(v->data, length, k - 1);
+        // The k-th smallest is in place already
+        k--;
+    } else {
+        k = length;
+    }
+
+    introsort(v->data, k, depth_limit_of(k));
+    LE_VEC_MARK_DIRTY(v, 0, length);
+}
+
+size_t le_vec_unique(struct le_vec *v) {
+    size_t length = le_vec_get_length(v);
+    if (length == 0) {
+        return 0;
+    }
+
+    size_t out = 1;
+    for (size_t i = 1; i < length; i++) {
+        // Branchless: always write, advance only if differs from the last kept
+        LE_VEC_TYPE value = v->data[i];
+        v->data[out] = value;
+        out += value != v->data[out - 1];
+    }
+
+    _le_vec_set_length(v, out);
+    if (out < length) {
+        LE_VEC_MARK_DIRTY(v, 0, out);
+    }
+
+    return length - out;
+}
+
+// Returns first index in [start; length) with data[index] >= value, length if there is none
+static size_t lower_bound(LE_VEC_TYPE const *data, size_t start, size_t length, LE_VEC_TYPE value) {
+    size_t lo = start;
+    size_t count = length - start;
+
+    // Branchless: the loop always runs log(count) times
+    while (count > 0) {
+        size_t half = count / 2;
+        bool less = data[lo + half] < value;
+        lo = less ? lo + half + 1 : lo;
+        count = less ? count - half - 1 : half;
+    }
+
+    return lo;
+}
+
+// Same as lower_bound(), but probes start + 1, + 3, + 7, ... first,
+// so finding an index d elements away costs O(log d) instead of O(log length).
+static size_t gallop(LE_VEC_TYPE const *data, size_t start, size_t length, LE_VEC_TYPE value) {
+    size_t lo = start;
+    size_t step = 1;
+
+    while (lo + step <= length && data[lo + step - 1] < value) {
+        lo += step;
+        step *= 2;
+    }
+
+    size_t hi = lo + step <= length ? lo + step : length;
+    return lower_bound(data, lo, hi, value);
+}
+
+size_t le_vec_lower_bound(struct le_vec const *v, LE_VEC_TYPE value) {
+    return lower_bound(v->data, 0, le_vec_get_length(v), value);
+}
+
+// Prepares out for at most `request` elements and returns its data
+static LE_VEC_TYPE *prepare_output(struct le_vec *out, size_t request) {
+    __le_vec_expand_to_request(out, request + OUTPUT_SLACK);
+    return out->data;
+}
+
+static void sift_down_min(LE_VEC_TYPE *data, size_t root, size_t length) {
+    while (2 * root + 1 < length) {
+        size_t child = 2 * root + 1;
+        if (child + 1 < length && data[child + 1] < data[child]) {
+            child++;
+        }
+        if (data[root] <= data[child]) {
+            return;
+        }
+        swap(&data[root], &data[child]);
+        root = child;
+    }
+}
+
+// Offers value to min-heap of the k largest elements seen so far
+static void heap_offer(LE_VEC_TYPE *heap, size_t k, LE_VEC_TYPE value) {
+    if (value > heap[0]) {
+        heap[0] = value;
+        sift_down_min(heap, 0, k);
+    }
+}
+
+static void offer_scalar(LE_VEC_TYPE *heap, size_t k, LE_VEC_TYPE const *data, size_t length) {
+    for (size_t i = 0; i < length; i++) {
+        heap_offer(heap, k, data[i]);
+    }
+}
+
+#ifdef LE_VEC_X86
+// Once the heap has filled up with large values almost every block of 8 is below its minimum,
+// and is skipped after a single compare
+LE_VEC_TARGET("avx2")
+static void offer_avx2(LE_VEC_TYPE *heap, size_t k, LE_VEC_TYPE const *data, size_t length) {
+    size_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m256i x = _mm256_loadu_si256((__m256i const *)(data + i));
+        __m256i above = _mm256_cmpgt_epi32(x, _mm256_set1_epi32(heap[0]));
+        unsigned mask = (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(above));
+
+        for (; mask != 0; mask &= mask - 1) {
+            heap_offer(heap, k, data[i + (size_t)__builtin_ctz(mask)]);
+        }
+    }
+
+    offer_scalar(heap, k, data + i, length - i);
+}
+#endif
+
+// Fills heap (k elements) with the k largest of data (at least k elements) as a min-heap
+static void heap_top_k(LE_VEC_TYPE *heap, size_t k, LE_VEC_TYPE const *data, size_t length) {
+    memcpy(heap, data, k * sizeof(LE_VEC_TYPE));
+    for (size_t i = k / 2; i > 0; i--) {
+        sift_down_min(heap, i - 1, k);
+    }
+
+#ifdef LE_VEC_X86
+    if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx2")) {
+        offer_avx2(heap, k, data + k, length - k);
+        return;
+    }
+#endif
+    offer_scalar(heap, k, data + k, length - k);
+}
+
+struct top_k {
+    LE_VEC_TYPE const *data;
+    size_t length;
+    size_t chunks;
+    size_t k;
+    // k candidates per chunk
+    LE_VEC_TYPE *candidates;
+};
+
+static void top_k_chunk(void *arg, size_t chunk) {
+    struct top_k *t = arg;
+    size_t start = _le_vec_chunk_start(t->length, t->chunks, chunk);
+    size_t end = _le_vec_chunk_start(t->length, t->chunks, chunk + 1);
+
+    heap_top_k(t->candidates + chunk * t->k, t->k, t->data + start, end - start);
+}
+
+size_t le_vec_top_k(struct le_vec const *v, size_t k, struct le_vec *out) {
+    size_t length = le_vec_get_length(v);
+    k = k < length ? k : length;
+    bool use_heap = k <= length / TOP_K_HEAP_RATIO;
+    LE_VEC_TYPE *dest = prepare_output(out, use_heap ? k : length);
+
+    if (k == 0) {
+        _le_vec_set_length(out, 0);
+        return 0;
+    }
+
+    if (use_heap) {
+        // Every thread keeps a heap of its chunk, then the heap of all their candidates is the answer
+        size_t chunks = _le_vec_parallel_chunks(length);
+        if (chunks > 1 && 2 * k * chunks <= length) {
+            struct top_k t = {v->data, length, chunks, k, malloc(chunks * k * sizeof(LE_VEC_TYPE))};
+            _le_vec_parallel_run(chunks, top_k_chunk, &t);
+            heap_top_k(dest, k, t.candidates, chunks * k);
+            free(t.candidates);
+        } else {
+            heap_top_k(dest, k, v->data, length);
+        }
+
+        // Taking minimums off the heap to its end leaves it in descending order
+        for (size_t end = k - 1; end > 0; end--) {
+            swap(&dest[0], &dest[end]);
+            sift_down_min(dest, 0, end);
+        }
+    } else {
+        memcpy(dest, v->data, length * sizeof(LE_VEC_TYPE));
+        select_nth(dest, length, length - k);
+        memmove(dest, dest + length - k, k * sizeof(LE_VEC_TYPE));
+        introsort(dest, k, depth_limit_of(k));
+        for (size_t i = 0; i < k / 2; i++) {
+            swap(&dest[i], &dest[k - 1 - i]);
+        }
+    }
+
+    _le_vec_set_length(out, k);
+    LE_VEC_MARK_DIRTY(out, 0, k);
+    return k;
+}
+
+static size_t union_merge(LE_VEC_TYPE const *a, size_t a_length, LE_VEC_TYPE const *b, size_t b_length, LE_VEC_TYPE *out) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+
+    // Branchless merge: equal heads advance both inputs, producing a single element
+    while (i < a_length && j < b_length) {
+        LE_VEC_TYPE x = a[i];
+        LE_VEC_TYPE y = b[j];
+        out[k++] = x <= y ? x : y;
+        i += x <= y;
+        j += y <= x;
+    }
+
+    memcpy(out + k, a + i, (a_length - i) * sizeof(LE_VEC_TYPE));
+    k += a_length - i;
+    memcpy(out + k, b + j, (b_length - j) * sizeof(LE_VEC_TYPE));
+    k += b_length - j;
+
+    return k;
+}
+
+// Union of short `small` and much longer `large`: runs of large between small elements are copied as a whole
+static size_t union_gallop(LE_VEC_TYPE const *small, size_t small_length, LE_VEC_TYPE const *large, size_t large_length, LE_VEC_TYPE *out) {
+    size_t j = 0;
+    size_t k = 0;
+
+    for (size_t i = 0; i < small_length; i++) {
+        LE_VEC_TYPE value = small[i];
+        size_t found = gallop(large, j, large_length, value);
+
+        memcpy(out + k, large + j, (found - j) * sizeof(LE_VEC_TYPE));
+        k += found - j;
+        out[k++] = value;
+        j = found + (found < large_length && large[found] == value);
+    }
+
+    memcpy(out + k, large + j, (large_length - j) * sizeof(LE_VEC_TYPE));
+    return k + large_length - j;
+}
+
+size_t le_vec_set_union(struct le_vec const *a, struct le_vec const *b, struct le_vec *out) {
+    size_t a_length = le_vec_get_length(a);
+    size_t b_length = le_vec_get_length(b);
+    LE_VEC_TYPE *dest = prepare_output(out, a_length + b_length);
+    size_t length;
+
+    if (a_length / GALLOP_RATIO > b_length) {
+        length = union_gallop(b->data, b_length, a->data, a_length, dest);
+    } else if (b_length / GALLOP_RATIO > a_length) {
+        length = union_gallop(a->data, a_length, b->data, b_length, dest);
+    } else {
+        length = union_merge(a->data, a_length, b->data, b_length, dest);
+    }
+
+    _le_vec_set_length(out, length);
+    LE_VEC_MARK_DIRTY(out, 0, length);
+    return length;
+}
+
+static size_t intersection_merge(LE_VEC_TYPE const *a, size_t a_length, LE_VEC_TYPE const *b, size_t b_length, LE_VEC_TYPE *out) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+
+    while (i < a_length && j < b_length) {
+        LE_VEC_TYPE x = a[i];
+        LE_VEC_TYPE y = b[j];
+        out[k] = x;
+        k += x == y;
+        i += x <= y;
+        j += y <= x;
+    }
+
+    return k;
+}
+
+#ifdef LE_VEC_X86
+// Compares blocks of 8 elements of a and b all-against-all (b is rotated 8 times),
+// left-packs matching elements of a and advances the block with the smaller maximum.
+// Inputs have no duplicates, so every element matches at most once.
+LE_VEC_TARGET("avx2,bmi,bmi2,popcnt")
+static size_t intersection_avx2(LE_VEC_TYPE const *a, size_t a_length, LE_VEC_TYPE const *b, size_t b_length, LE_VEC_TYPE *out) {
+    __m256i rotate = _mm256_set_epi32(0, 7, 6, 5, 4, 3, 2, 1);
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+
+    while (i + 8 <= a_length && j + 8 <= b_length) {
+        __m256i x = _mm256_loadu_si256((__m256i const *)(a + i));
+        __m256i y = _mm256_loadu_si256((__m256i const *)(b + j));
+
+        __m256i matches = _mm256_cmpeq_epi32(x, y);
+        for (int r = 1; r < 8; r++) {
+            y = _mm256_permutevar8x32_epi32(y, rotate);
+            matches = _mm256_or_si256(matches, _mm256_cmpeq_epi32(x, y));
+        }
+
+        unsigned mask = _mm256_movemask_ps(_mm256_castsi256_ps(matches));
+        __m256i packed = _mm256_permutevar8x32_epi32(x, le_vec_left_pack_permutation(mask));
+        _mm256_storeu_si256((__m256i *)(out + k), packed);
+        k += _mm_popcnt_u32(mask);
+
+        LE_VEC_TYPE a_max = a[i + 7];
+        LE_VEC_TYPE b_max = b[j + 7];
+        i += (a_max <= b_max) * 8;
+        j += (b_max <= a_max) * 8;
+    }
+
+    return k + intersection_merge(a + i, a_length - i, b + j, b_length - j, out + k);
+}
+#endif
+
+static size_t intersection_gallop(LE_VEC_TYPE const *small, size_t small_length, LE_VEC_TYPE const *large, size_t large_length, LE_VEC_TYPE *out) {
+    size_t j = 0;
+    size_t k = 0;
+
+    for (size_t i = 0; i < small_length && j < large_length; i++) {
+        LE_VEC_TYPE value = small[i];
+        j = gallop(large, j, large_length, value);
+
+        out[k] = value;
+        k += j < large_length && large[j] == value;
+    }
+
+    return k;
+}
+
+size_t le_vec_set_intersection(struct le_vec const *a, struct le_vec const *b, struct le_vec *out) {
+    size_t a_length = le_vec_get_length(a);
+    size_t b_length = le_vec_get_length(b);
+    LE_VEC_TYPE *dest = prepare_output(out, a_length < b_length ? a_length : b_length);
+    size_t length;
+
+    if (a_length / GALLOP_RATIO > b_length) {
+        length = intersection_gallop(b->data, b_length, a->data, a_length, dest);
+    } else if (b_length / GALLOP_RATIO > a_length) {
+        length = intersection_gallop(a->data, a_length, b->data, b_length, dest);
+    } else {
+#ifdef LE_VEC_X86
+        if (sizeof(LE_VEC_TYPE) == 4 && LE_VEC_CPU_SUPPORTS("avx2") && LE_VEC_CPU_SUPPORTS("bmi2")) {
+            length = intersection_avx2(a->data, a_length, b->data, b_length, dest);
+        } else {
+            length = intersection_merge(a->data, a_length, b->data, b_length, dest);
+        }
+#else
+        length = intersection_merge(a->data, a_length, b->data, b_length, dest);
+#endif
+    }
+
+    _le_vec_set_length(out, length);
+    LE_VEC_MARK_DIRTY(out, 0, length);
+    return length;
+}
+
+static size_t difference_merge(LE_VEC_TYPE const *a, size_t a_length, LE_VEC_TYPE const *b, size_t b_length, LE_VEC_TYPE *out) {
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+
+    while (i < a_length && j < b_length) {
+        LE_VEC_TYPE x = a[i];
+        LE_VEC_TYPE y = b[j];
+        out[k] = x;
+        k += x < y;
+        i += x <= y;
+        j += y <= x;
+    }
+
+    memcpy(out + k, a + i, (a_length - i) * sizeof(LE_VEC_TYPE));
+    return k + a_length - i;
+}
+
+size_t le_vec_set_difference(struct le_vec const *a, struct le_vec const *b, struct le_vec *out) {
+    LE_VEC_TYPE const *a_data = a->data;
+    LE_VEC_TYPE const *b_data = b->data;
+    size_t a_length = le_vec_get_length(a);
+    size_t b_length = le_vec_get_length(b);
+    LE_VEC_TYPE *dest = prepare_output(out, a_length);
+    size_t i = 0;
+    size_t j = 0;
+    size_t k = 0;
+
+    if (a_length / GALLOP_RATIO > b_length) {
+        // Few elements to remove: copy runs of a between them
+        for (; j < b_length; j++) {
+            size_t found = gallop(a_data, i, a_length, b_data[j]);
+            memcpy(dest + k, a_data + i, (found - i) * sizeof(LE_VEC_TYPE));
+            k += found - i;
+            i = found + (found < a_length && a_data[found] == b_data[j]);
+        }
+        memcpy(dest + k, a_data + i, (a_length - i) * sizeof(LE_VEC_TYPE));
+        k += a_length - i;
+    } else if (b_length / GALLOP_RATIO > a_length) {
+        // Few elements to keep: look each of them up in b
+        for (; i < a_length; i++) {
+            LE_VEC_TYPE value = a_data[i];
+            j = gallop(b_data, j, b_length, value);
+            dest[k] = value;
+            k += !(j < b_length && b_data[j] == value);
+        }
+    } else {
+        k = difference_merge(a_data, a_length, b_data, b_length, dest);
+    }
+
+    _le_vec_set_length(out, k);
+    LE_VEC_MARK_DIRTY(out, 0, k);
+    return k;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+
+// Algorithms on sorted vectors.
+// Set operations expect ascending vectors without duplicates (as produced by
+// le_vec_sort() + le_vec_unique()) and produce the same.
+
+// Sorts vector in ascending order (introsort, not stable)
+void le_vec_sort(struct le_vec *v);
+// Checks if vector is sorted in ascending order
+bool le_vec_is_sorted(struct le_vec const *v);
+
+// Puts the element that would be at n in sorted vector there, elements before it are not greater
+// and elements after it are not less (introselect, O(n), large vectors are split between threads)
+// Returns false (v is not changed) if n is invalid
+bool le_vec_nth_element(struct le_vec *v, size_t n);
+// Sorts the k smallest elements into [0; k), the rest are left in unspecified order. O(n + k log k)
+// k larger than length sorts the whole vector
+void le_vec_partial_sort(struct le_vec *v, size_t k);
+// Writes the k largest elements of v in descending order to out, replacing its contents
+// k larger than length takes all elements, out must not be v
+// Returns new length of out
+size_t le_vec_top_k(struct le_vec const *v, size_t k, struct le_vec *out);
+
+// Removes consecutive duplicates in-place, keeping the first of each group
+// On a sorted vector leaves only distinct values
+// Returns number of removed elements
+size_t le_vec_unique(struct le_vec *v);
+
+// Index of first element not less than value, length if there is none
+size_t le_vec_lower_bound(struct le_vec const *v, LE_VEC_TYPE value);
+
+// Writes elements present in a or b to out, replacing its contents
+// out must not be a or b
+// Returns new length of out
+size_t le_vec_set_union(struct le_vec const *a, struct le_vec const *b, struct le_vec *out);
+// Writes elements present both in a and b to out, replacing its contents
+// out must not be a or b
+// Returns new length of out
+size_t le_vec_set_intersection(struct le_vec const *a, struct le_vec const *b, struct le_vec *out);
+// Writes elements of a not present in b to out, replacing its contents
+// out must not be a or b
+// Returns new length of out
+size_t le_vec_set_difference(struct le_vec const *a, struct le_vec const *b, struct le_vec *out);
@@ -0,0 +1,214 @@
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_stats.h"
+
+static const char *OP_NAMES[LE_VEC_OPS_LENGTH] = {
+    [LE_VEC_OP_INIT] = "init",
+    [LE_VEC_OP_DESTROY] = "destroy",
+    [LE_VEC_OP_PUSH_BACK] = "push_back",
+    [LE_VEC_OP_POP_BACK] = "pop_back",
+    [LE_VEC_OP_GET_AT] = "get_at",
+    [LE_VEC_OP_SET_AT] = "set_at",
+    [LE_VEC_OP_RESIZE] = "resize",
+    [LE_VEC_OP_EXTEND] = "extend",
+    [LE_VEC_OP_MAP] = "map",
+    [LE_VEC_OP_REVERSE] = "reverse",
+    [LE_VEC_OP_SLICE] = "slice",
+    [LE_VEC_OP_COUNT] = "count",
+    [LE_VEC_OP_FIND] = "find",
+    [LE_VEC_OP_REPLACE] = "replace",
+    [LE_VEC_OP_INSERT] = "insert",
+    [LE_VEC_OP_ERASE] = "erase",
+    [LE_VEC_OP_REMOVE] = "remove",
+};
+
+const char *le_vec_stats_op_name(enum le_vec_op op) {
+    return op < LE_VEC_OPS_LENGTH ? OP_NAMES[op] : "unknown";
+}
+
+void le_vec_stats_dump_json(struct le_vec_stats const *stats, FILE *out) {
+    fprintf(out, "{\"allocs\": %zu, ", stats->allocs);
+    fprintf(out, "\"reallocs\": %zu, ", stats->reallocs);
+    fprintf(out, "\"frees\": %zu, ", stats->frees);
+    fprintf(out, "\"bytes_moved\": %zu, ", stats->bytes_moved);
+    fprintf(out, "\"capacity_bytes\": %zu, ", stats->capacity_bytes);
+    fprintf(out, "\"peak_capacity_bytes\": %zu, ", stats->peak_capacity_bytes);
+    fprintf(out, "\"slack_bytes\": %zu, ", stats->slack_bytes);
+
+    fprintf(out, "\"calls\": {");
+    for (size_t op = 0; op < LE_VEC_OPS_LENGTH; op++) {
+        fprintf(out, "%s\"%s\": %zu", op == 0 ? "" : ", ", OP_NAMES[op], stats->calls[op]);
+    }
+    fprintf(out, "}, ");
+
+    fprintf(out, "\"cycles\": {");
+    for (size_t op = 0; op < LE_VEC_OPS_LENGTH; op++) {
+        fprintf(out, "%s\"%s\": %llu", op == 0 ? "" : ", ", OP_NAMES[op], stats->cycles[op]);
+    }
+    fprintf(out, "}}\n");
+}
+
+#ifdef LE_VEC_STATS
+
+#include <stdatomic.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+static struct _le_vec_counters global;
+
+#define ADD(counter, value) atomic_fetch_add_explicit(&(counter), (value), memory_order_relaxed)
+#define SUB(counter, value) atomic_fetch_sub_explicit(&(counter), (value), memory_order_relaxed)
+#define LOAD(counter) atomic_load_explicit(&(counter), memory_order_relaxed)
+#define STORE(counter, value) atomic_store_explicit(&(counter), (value), memory_order_relaxed)
+
+static unsigned long long now_cycles(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000u + (unsigned long long)ts.tv_nsec;
+#endif
+}
+
+static void update_peak(_Atomic size_t *peak, size_t value) {
+    size_t current = atomic_load_explicit(peak, memory_order_relaxed);
+    while (value > current) {
+        if (atomic_compare_exchange_weak_explicit(peak, &current, value, memory_order_relaxed, memory_order_relaxed)) {
+            return;
+        }
+    }
+}
+
+// Counters are mutable even for const vectors
+static struct _le_vec_counters *counters_of(struct le_vec const *v) {
+    return (struct _le_vec_counters *)&v->counters;
+}
+
+static void read_counters(struct _le_vec_counters *c, struct le_vec_stats *stats) {
+    stats->allocs = LOAD(c->allocs);
+    stats->reallocs = LOAD(c->reallocs);
+    stats->frees = LOAD(c->frees);
+    stats->bytes_moved = LOAD(c->bytes_moved);
+    stats->capacity_bytes = LOAD(c->capacity_bytes);
+    stats->peak_capacity_bytes = LOAD(c->peak_capacity_bytes);
+    stats->slack_bytes = 0;
+
+    for (size_t op = 0; op < LE_VEC_OPS_LENGTH; op++) {
+        stats->calls[op] = LOAD(c->calls[op]);
+        stats->cycles[op] = LOAD(c->cycles[op]);
+    }
+}
+
+void _le_vec_stats_init(struct le_vec *v) {
+    memset(&v->counters, 0, sizeof(v->counters));
+}
+
+void _le_vec_stats_on_alloc(struct le_vec *v, size_t bytes) {
+    ADD(v->counters.allocs, 1);
+    STORE(v->counters.capacity_bytes, bytes);
+    update_peak(&v->counters.peak_capacity_bytes, bytes);
+
+    ADD(global.allocs, 1);
+    size_t live = ADD(global.capacity_bytes, bytes) + bytes;
+    update_peak(&global.peak_capacity_bytes, live);
+}
+
+void _le_vec_stats_on_realloc(struct le_vec *v, size_t old_bytes, size_t new_bytes, bool moved) {
+    size_t moved_bytes = moved ? (old_bytes < new_bytes ? old_bytes : new_bytes) : 0;
+
+    ADD(v->counters.reallocs, 1);
+    ADD(v->counters.bytes_moved, moved_bytes);
+    STORE(v->counters.capacity_bytes, new_bytes);
+    update_peak(&v->counters.peak_capacity_bytes, new_bytes);
+
+    ADD(global.reallocs, 1);
+    ADD(global.bytes_moved, moved_bytes);
+    if (new_bytes >= old_bytes) {
+        size_t live = ADD(global.capacity_bytes, new_bytes - old_bytes) + (new_bytes - old_bytes);
+        update_peak(&global.peak_capacity_bytes, live);
+    } else {
+        SUB(global.capacity_bytes, old_bytes - new_bytes);
+    }
+}
+
+void _le_vec_stats_on_free(struct le_vec *v, size_t bytes) {
+    ADD(v->counters.frees, 1);
+    STORE(v->counters.capacity_bytes, 0);
+
+    ADD(global.frees, 1);
+    SUB(global.capacity_bytes, bytes);
+}
+
+void _le_vec_stats_count(struct le_vec const *v, enum le_vec_op op) {
+    if (v != NULL) {
+        ADD(counters_of(v)->calls[op], 1);
+    }
+    ADD(global.calls[op], 1);
+}
+
+struct _le_vec_stats_timer _le_vec_stats_begin(struct le_vec const *v, enum le_vec_op op) {
+    _le_vec_stats_count(v, op);
+
+    struct _le_vec_stats_timer timer = {v, op, now_cycles()};
+    return timer;
+}
+
+void _le_vec_stats_end(struct _le_vec_stats_timer *timer) {
+    unsigned long long cycles = now_cycles() - timer->start;
+
+    if (timer->v != NULL) {
+        ADD(counters_of(timer->v)->cycles[timer->op], cycles);
+    }
+    ADD(global.cycles[timer->op], cycles);
+}
+
+bool le_vec_stats_get(struct le_vec const *v, struct le_vec_stats *stats) {
+    if (v == NULL) {
+        read_counters(&global, stats);
+        return true;
+    }
+
+    read_counters(counters_of(v), stats);
+    stats->slack_bytes = (v->capacity - v->length) * sizeof(LE_VEC_TYPE);
+
+    return true;
+}
+
+void le_vec_stats_reset(void) {
+    size_t live = LOAD(global.capacity_bytes);
+
+    STORE(global.allocs, 0);
+    STORE(global.reallocs, 0);
+    STORE(global.frees, 0);
+    STORE(global.bytes_moved, 0);
+    STORE(global.peak_capacity_bytes, live);
+
+    for (size_t op = 0; op < LE_VEC_OPS_LENGTH; op++) {
+        STORE(global.calls[op], 0);
+        STORE(global.cycles[op], 0);
+    }
+}
+
+#else
+
+bool le_vec_stats_get(struct le_vec const *v, struct le_vec_stats *stats) {
+    (void)v;
+
+    memset(stats, 0, sizeof(struct le_vec_stats));
+    return false;
+}
+
+void le_vec_stats_reset(void) {
+}
+
+#endif
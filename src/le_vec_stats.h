@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "le_vec.h"
+
+// Allocation and operation statistics.
+// Collected only when the library is built with LE_VEC_STATS defined (`make STATS=1`),
+// cycle totals additionally need LE_VEC_STATS_CYCLES (`make STATS=cycles`).
+// Otherwise instrumentation compiles to nothing and le_vec_stats_get() returns false.
+
+// Operations counted by statistics
+enum le_vec_op {
+    LE_VEC_OP_INIT,
+    LE_VEC_OP_DESTROY,
+    LE_VEC_OP_PUSH_BACK,
+    LE_VEC_OP_POP_BACK,
+    LE_VEC_OP_GET_AT,
+    LE_VEC_OP_SET_AT,
+    LE_VEC_OP_RESIZE,
+    LE_VEC_OP_EXTEND,
+    LE_VEC_OP_MAP,
+    LE_VEC_OP_REVERSE,
+    LE_VEC_OP_SLICE,
+    LE_VEC_OP_COUNT,
+    LE_VEC_OP_FIND,
+    LE_VEC_OP_REPLACE,
+    LE_VEC_OP_INSERT,
+    LE_VEC_OP_ERASE,
+    LE_VEC_OP_REMOVE,
+    // Number of operations, not an operation
+    LE_VEC_OPS_LENGTH,
+};
+
+struct le_vec_stats {
+    // Data buffer allocations
+    size_t allocs;
+    // Data buffer reallocations (growth and shrinking)
+    size_t reallocs;
+    // Data buffer frees
+    size_t frees;
+    // Bytes copied by reallocations that moved the buffer
+    size_t bytes_moved;
+    // Bytes currently allocated for data (sum over live vectors for global stats)
+    size_t capacity_bytes;
+    // Maximum of capacity_bytes ever seen
+    size_t peak_capacity_bytes;
+    // Allocated but unused bytes (capacity - length). Always 0 for global stats
+    size_t slack_bytes;
+    // Calls of each operation, nested calls included
+    size_t calls[LE_VEC_OPS_LENGTH];
+    // Cycles spent in each operation, nested calls included. Zero without LE_VEC_STATS_CYCLES
+    unsigned long long cycles[LE_VEC_OPS_LENGTH];
+};
+
+// Reads statistics of vector, or global statistics if v is NULL
+// Returns false if the library is built without statistics
+bool le_vec_stats_get(struct le_vec const *v, struct le_vec_stats *stats);
+// Resets global statistics (live capacity is kept)
+void le_vec_stats_reset(void);
+
+// Returns name of operation
+const char *le_vec_stats_op_name(enum le_vec_op op);
+// Writes statistics as a single JSON object
+void le_vec_stats_dump_json(struct le_vec_stats const *stats, FILE *out);
@@ -0,0 +1,225 @@
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_table.h"
+
+// Every column starts on its own cache line
+#define COLUMN_ALIGNMENT 64
+// Capacity is kept a multiple of this, so that columns following each other stay aligned
+#define ROW_ALIGNMENT (COLUMN_ALIGNMENT / sizeof(LE_VEC_TYPE) > 0 ? COLUMN_ALIGNMENT / sizeof(LE_VEC_TYPE) : 1)
+
+struct le_vec_table {
+    size_t columns_length;
+    size_t capacity;
+    size_t length;
+    // Column `c` takes [c * capacity; c * capacity + length)
+    LE_VEC_TYPE *data;
+    // Read-only views of columns, refreshed on request
+    struct le_vec *views;
+};
+
+static size_t align_capacity(size_t capacity) {
+    size_t aligned = (capacity + ROW_ALIGNMENT - 1) / ROW_ALIGNMENT * ROW_ALIGNMENT;
+    return aligned > 0 ? aligned : ROW_ALIGNMENT;
+}
+
+static LE_VEC_TYPE *column_data(struct le_vec_table const *t, size_t column) {
+    return t->data + column * t->capacity;
+}
+
+// Moves all columns to a single new buffer, fitting `capacity` rows.
+static void realloc_columns(struct le_vec_table *t, size_t capacity) {
+    capacity = align_capacity(capacity);
+    if (capacity == t->capacity) {
+        return;
+    }
+
+    LE_VEC_TYPE *data = aligned_alloc(COLUMN_ALIGNMENT, t->columns_length * capacity * sizeof(LE_VEC_TYPE));
+    for (size_t column = 0; column < t->columns_length; column++) {
+        memcpy(data + column * capacity, column_data(t, column), t->length * sizeof(LE_VEC_TYPE));
+    }
+
+    free(t->data);
+    t->data = data;
+    t->capacity = capacity;
+}
+
+// Expands all columns at once so that capacity is >= request.
+static void expand_to_request(struct le_vec_table *t, size_t request) {
+    size_t capacity = t->capacity;
+    if (capacity >= request) {
+        return;
+    }
+
+    while (capacity < request) {
+        capacity *= 2;
+    }
+
+    realloc_columns(t, capacity);
+}
+
+struct le_vec_table *le_vec_table_init(size_t columns) {
+    if (columns == 0) {
+        return NULL;
+    }
+
+    struct le_vec_table *t = malloc(sizeof(struct le_vec_table));
+    size_t capacity = align_capacity(LE_VEC_DEFAULT_CAPACITY);
+
+    t->columns_length = columns;
+    t->capacity = capacity;
+    t->length = 0;
+    t->data = aligned_alloc(COLUMN_ALIGNMENT, columns * capacity * sizeof(LE_VEC_TYPE));
+    t->views = malloc(columns * sizeof(struct le_vec));
+
+    for (size_t column = 0; column < columns; column++) {
+        t->views[column].dirty = NULL;
+        t->views[column].aggregates = NULL;
+        LE_VEC_STATS_INIT(&t->views[column]);
+    }
+
+    return t;
+}
+
+void le_vec_table_destroy(struct le_vec_table *t) {
+    if (t == NULL) {
+        return;
+    }
+
+    free(t->data);
+    free(t->views);
+    free(t);
+}
+
+size_t le_vec_table_get_length(struct le_vec_table const *t) {
+    return t->length;
+}
+
+size_t le_vec_table_get_capacity(struct le_vec_table const *t) {
+    return t->capacity;
+}
+
+size_t le_vec_table_get_columns_length(struct le_vec_table const *t) {
+    return t->columns_length;
+}
+
+bool le_vec_table_is_empty(struct le_vec_table const *t) {
+    return t->length == 0;
+}
+
+void le_vec_table_push_back(struct le_vec_table *t, LE_VEC_TYPE const *row) {
+    if (t->length >= t->capacity) {
+        expand_to_request(t, t->length + 1);
+    }
+
+    LE_VEC_TYPE *data = t->data + t->length;
+    for (size_t column = 0; column < t->columns_length; column++) {
+        data[column * t->capacity] = row[column];
+    }
+    t->length++;
+}
+
+bool le_vec_table_pop_back(struct le_vec_table *t, LE_VEC_TYPE *row) {
+    if (le_vec_table_is_empty(t)) {
+        return false;
+    }
+
+    if (row != NULL) {
+        le_vec_table_get_row(t, t->length - 1, row);
+    }
+    t->length--;
+
+    return true;
+}
+
+void le_vec_table_resize(struct le_vec_table *t, size_t new_length) {
+    if (new_length > t->capacity) {
+        expand_to_request(t, new_length);
+        t->length = new_length;
+        return;
+    }
+
+    t->length = new_length;
+
+    if (new_length < t->capacity / 2) {
+        realloc_columns(t, new_length);
+    }
+}
+
+LE_VEC_TYPE le_vec_table_get_at(struct le_vec_table const *t, size_t row, size_t column) {
+    return column_data(t, column)[row];
+}
+
+bool le_vec_table_set_at(struct le_vec_table *t, size_t row, size_t column, LE_VEC_TYPE value) {
+    if (row >= t->length || column >= t->columns_length) {
+        return false;
+    }
+
+    column_data(t, column)[row] = value;
+    return true;
+}
+
+bool le_vec_table_get_row(struct le_vec_table const *t, size_t row, LE_VEC_TYPE *out) {
+    if (row >= t->length) {
+        return false;
+    }
+
+    LE_VEC_TYPE const *data = t->data + row;
+    for (size_t column = 0; column < t->columns_length; column++) {
+        out[column] = data[column * t->capacity];
+    }
+
+    return true;
+}
+
+static struct le_vec *view(struct le_vec_table *t, size_t column) {
+    struct le_vec *v = &t->views[column];
+    v->capacity = t->capacity;
+    v->length = t->length;
+    v->data = column_data(t, column);
+
+    return v;
+}
+
+struct le_vec const *le_vec_table_column(struct le_vec_table *t, size_t column) {
+    if (column >= t->columns_length) {
+        return NULL;
+    }
+
+    return view(t, column);
+}
+
+bool le_vec_table_for_each(struct le_vec_table *t, size_t column, LE_VEC_TYPE (*f)(LE_VEC_TYPE)) {
+    if (column >= t->columns_length) {
+        return false;
+    }
+
+    le_vec_for_each(view(t, column), f);
+    return true;
+}
+
+struct le_vec_table *le_vec_table_gather(struct le_vec_table const *t, struct le_vec const *rows) {
+    size_t length = le_vec_get_length(rows);
+    LE_VEC_TYPE const *indexes = rows->data;
+
+    for (size_t i = 0; i < length; i++) {
+        if (indexes[i] < 0 || (size_t)indexes[i] >= t->length) {
+            return NULL;
+        }
+    }
+
+    struct le_vec_table *new_t = le_vec_table_init(t->columns_length);
+    expand_to_request(new_t, length);
+    new_t->length = length;
+
+    // Column by column, so that only one source column is in cache at a time
+    for (size_t column = 0; column < t->columns_length; column++) {
+        _le_vec_gather_data(column_data(new_t, column), column_data(t, column), t->length, indexes, length);
+    }
+
+    return new_t;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+
+// Columnar table: several columns of elements sharing one length and capacity.
+// All columns live in a single allocation, each one contiguous and 64-byte aligned,
+// so growing the table is one realloc for all of them and a scan over one column
+// reads only that column from memory.
+struct le_vec_table;
+
+// Creates and initiates empty table with given number of columns
+// Returns NULL if columns is 0
+struct le_vec_table *le_vec_table_init(size_t columns);
+// Destroys le_vec_table.
+void le_vec_table_destroy(struct le_vec_table *t);
+
+// Returns number of rows
+size_t le_vec_table_get_length(struct le_vec_table const *t);
+// Returns number of rows that fit without reallocation
+size_t le_vec_table_get_capacity(struct le_vec_table const *t);
+// Returns number of columns
+size_t le_vec_table_get_columns_length(struct le_vec_table const *t);
+// Checks if table empty (does not contain any rows)
+bool le_vec_table_is_empty(struct le_vec_table const *t);
+
+// Pushes row after the last row, `row` has a value for each column
+void le_vec_table_push_back(struct le_vec_table *t, LE_VEC_TYPE const *row);
+// Removes the last row and stores its values in `row` (might be NULL)
+// Returns false if table is empty
+bool le_vec_table_pop_back(struct le_vec_table *t, LE_VEC_TYPE *row);
+// Changes the number of rows. New rows are not initialized, if table is shrank, rows get lost
+void le_vec_table_resize(struct le_vec_table *t, size_t new_length);
+
+// Gets element of column at row.
+LE_VEC_TYPE le_vec_table_get_at(struct le_vec_table const *t, size_t row, size_t column);
+// Sets element of column at row to a new value.
+// Returns false if row or column is out of range
+bool le_vec_table_set_at(struct le_vec_table *t, size_t row, size_t column, LE_VEC_TYPE value);
+// Stores values of all columns at row in `out`
+// Returns false if row is out of range
+bool le_vec_table_get_row(struct le_vec_table const *t, size_t row, LE_VEC_TYPE *out);
+
+// Returns column as a read-only vector, to be used with any le_vec function that does not modify it
+// (count, find, scanned, ...). View is owned by the table and is valid until the next change of table length.
+// Returns NULL if column is out of range
+struct le_vec const *le_vec_table_column(struct le_vec_table *t, size_t column);
+// Applies f to each element of column in-place
+// Returns false if column is out of range
+bool le_vec_table_for_each(struct le_vec_table *t, size_t column, LE_VEC_TYPE (*f)(LE_VEC_TYPE));
+
+// Creates a new table from rows at given indexes (in that order, repeats allowed)
+// Returns NULL if some index is out of range
+struct le_vec_table *le_vec_table_gather(struct le_vec_table const *t, struct le_vec const *rows);
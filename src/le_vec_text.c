@@ -0,0 +1,416 @@
+#include <errno.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "le_vec.h"
+#include "le_vec_internal.h"
+#include "le_vec_simd.h"
+#include "le_vec_text.h"
+
+// Limits of LE_VEC_TYPE
+#define VALUE_MAX INT_MAX
+// Capacity is estimated from separators in this many first bytes
+#define ESTIMATE_SAMPLE 4096
+// Streaming parser reads at least this many bytes at once
+#define READ_CHUNK (64 * 1024)
+// Longest formatted value ("-2147483648") plus separator
+#define MAX_FIELD 12
+// Text is written to file descriptors in pieces of this size
+#define WRITE_BUFFER (1024 * 1024)
+
+// "00", "01", ..., "99": two digits per division instead of one
+static const char DIGIT_PAIRS[201] =
+    "0001020304050607080910111213141516171819"
+    "2021222324252627282930313233343536373839"
+    "4041424344454647484950515253545556575859"
+    "6061626364656667686970717273747576777879"
+    "8081828384858687888990919293949596979899";
+
+static bool is_separator(char c, char sep) {
+    return c == sep || c == '\n';
+}
+
+static bool is_blank(char c, char sep) {
+    return (c == ' ' || c == '\t') && c != sep;
+}
+
+static bool is_digit(char c) {
+    return (unsigned char)(c - '0') <= 9;
+}
+
+// Returns expected number of values in text, judging by the first bytes
+static size_t estimate_count(const char *buf, size_t length, char sep) {
+    size_t sample = length < ESTIMATE_SAMPLE ? length : ESTIMATE_SAMPLE;
+    if (sample == 0) {
+        return 0;
+    }
+
+    size_t separators = 0;
+    for (size_t i = 0; i < sample; i++) {
+        separators += is_separator(buf[i], sep);
+    }
+
+    // +1 for the last value, which might have no separator after it
+    return (length * (separators + 1) + sample - 1) / sample;
+}
+
+// Returns mask with bit i set if p[i] is a separator, n <= 64
+static uint64_t separator_mask(const char *p, size_t n, char sep) {
+#if defined(__SSE2__)
+    if (n == 64) {
+        __m128i separator = _mm_set1_epi8(sep);
+        __m128i newline = _mm_set1_epi8('\n');
+        uint64_t mask = 0;
+
+        for (size_t i = 0; i < 4; i++) {
+            __m128i chunk = _mm_loadu_si128((__m128i const *)(p + 16 * i));
+            __m128i matches = _mm_or_si128(_mm_cmpeq_epi8(chunk, separator), _mm_cmpeq_epi8(chunk, newline));
+            mask |= (uint64_t)(unsigned)_mm_movemask_epi8(matches) << (16 * i);
+        }
+
+        return mask;
+    }
+#endif
+    uint64_t mask = 0;
+    for (size_t i = 0; i < n; i++) {
+        mask |= (uint64_t)is_separator(p[i], sep) << i;
+    }
+
+    return mask;
+}
+
+// Converts 8 ASCII digits at once (SWAR), first byte is the most significant digit.
+static uint32_t parse_eight_digits(uint64_t chunk) {
+    chunk = (chunk & 0x0F0F0F0F0F0F0F0Full) * 2561 >> 8;
+    chunk = (chunk & 0x00FF00FF00FF00FFull) * 6553601 >> 16;
+    return (uint32_t)((chunk & 0x0000FFFF0000FFFFull) * 42949672960001ull >> 32);
+}
+
+static bool is_eight_digits(uint64_t chunk) {
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ull) | (((chunk + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) >> 4))
+        == 0x3333333333333333ull;
+}
+
+// Loads `n` (1 <= n <= 8) digits at p with a single 8-byte load, with leading '0's in place of the rest.
+// Returns false if any of them is not a digit.
+static bool load_digits(const char *p, size_t n, uint64_t *chunk) {
+    memcpy(chunk, p, sizeof(*chunk));
+    // Little endian: shifting left drops bytes past the digits, the freed low bytes become leading '0's
+    if (n < 8) {
+        *chunk = (*chunk << (8 * (8 - n))) | (0x3030303030303030ull >> (8 * n));
+    }
+
+    return is_eight_digits(*chunk);
+}
+
+// Parses field [start; end) made of optional '-' and 1 to 16 digits with at most two 8-byte loads.
+// Returns false if the field is anything else, out of range, or too close to the end of buffer.
+static LE_VEC_ALWAYS_INLINE bool parse_plain_field(const char *buf, size_t length, size_t start, size_t end, LE_VEC_TYPE *value) {
+    bool negative = start < end && buf[start] == '-';
+    size_t i = start + negative;
+    size_t n = end - i;
+    if (n == 0 || n > 16 || i + 8 > length) {
+        return false;
+    }
+
+    uint64_t high = 0;
+    uint64_t low;
+    if (n <= 8) {
+        if (!load_digits(buf + i, n, &low)) {
+            return false;
+        }
+    } else if (!load_digits(buf + i, n - 8, &high) || !load_digits(buf + end - 8, 8, &low)) {
+        return false;
+    }
+
+    unsigned long long magnitude = (unsigned long long)parse_eight_digits(high) * 100000000ull + parse_eight_digits(low);
+    unsigned long long limit = negative ? (unsigned long long)VALUE_MAX + 1 : VALUE_MAX;
+    if (magnitude > limit) {
+        return false;
+    }
+
+    *value = negative ? (LE_VEC_TYPE)(-(long long)magnitude) : (LE_VEC_TYPE)magnitude;
+    return true;
+}
+
+// Parses any field [start; end): blanks, sign, digits, "\r" before "\n".
+// Returns offset of the offending byte or invalid index if everything is fine.
+static size_t parse_field(const char *buf, size_t length, size_t start, size_t end, char sep, LE_VEC_TYPE *value) {
+    size_t i = start;
+    while (i < end && is_blank(buf[i], sep)) {
+        i++;
+    }
+
+    bool negative = false;
+    if (i < end && (buf[i] == '-' || buf[i] == '+')) {
+        negative = buf[i] == '-';
+        i++;
+    }
+
+    unsigned long long limit = negative ? (unsigned long long)VALUE_MAX + 1 : VALUE_MAX;
+    unsigned long long magnitude = 0;
+    size_t digits_start = i;
+    for (; i < end && is_digit(buf[i]); i++) {
+        magnitude = magnitude * 10 + (unsigned long long)(buf[i] - '0');
+        if (magnitude > limit) {
+            return i;
+        }
+    }
+    if (i == digits_start) {
+        return i;
+    }
+
+    while (i < end && is_blank(buf[i], sep)) {
+        i++;
+    }
+    if (i + 1 == end && buf[i] == '\r' && end < length && buf[end] == '\n') {
+        i++;
+    }
+    if (i != end) {
+        return i;
+    }
+
+    *value = negative ? (LE_VEC_TYPE)(-(long long)magnitude) : (LE_VEC_TYPE)magnitude;
+    return (size_t)-1;
+}
+
+// Parses field [start; end) and writes it at v->data[*out], growing v if needed.
+// Returns offset of the offending byte or invalid index if everything is fine.
+static LE_VEC_ALWAYS_INLINE size_t append_field(struct le_vec *v, size_t *out, const char *buf, size_t length, size_t start, size_t end, char sep) {
+    LE_VEC_TYPE value;
+    if (!parse_plain_field(buf, length, start, end, &value)) {
+        size_t error = parse_field(buf, length, start, end, sep, &value);
+        if (error != (size_t)-1) {
+            return error;
+        }
+    }
+
+    if (*out == v->capacity) {
+        __le_vec_expand_to_request(v, *out + 1);
+    }
+    v->data[(*out)++] = value;
+
+    return (size_t)-1;
+}
+
+// Appends values of buf to v.
+// Returns offset of the offending byte or invalid index if everything is fine.
+//
+// Separators of every 64 bytes are found at once, so field boundaries don't wait for
+// conversion of previous values. Plain fields take the SWAR path, the rest goes
+// through parse_field(), which also finds the exact offending byte.
+static size_t parse(struct le_vec *v, const char *buf, size_t length, char sep) {
+    __le_vec_expand_to_request(v, le_vec_get_length(v) + estimate_count(buf, length, sep));
+
+    size_t out = le_vec_get_length(v);
+    size_t error = (size_t)-1;
+    // Start of the current field
+    size_t start = 0;
+
+    for (size_t block = 0; block < length && error == (size_t)-1; block += 64) {
+        size_t n = length - block < 64 ? length - block : 64;
+        uint64_t mask = separator_mask(buf + block, n, sep);
+
+        while (mask != 0) {
+            size_t end = block + (size_t)__builtin_ctzll(mask);
+            mask &= mask - 1;
+
+            error = append_field(v, &out, buf, length, start, end, sep);
+            if (error != (size_t)-1) {
+                break;
+            }
+            start = end + 1;
+        }
+    }
+
+    // The last field might have no separator after it
+    if (error == (size_t)-1 && start < length) {
+        error = append_field(v, &out, buf, length, start, length, sep);
+    }
+
+    LE_VEC_MARK_DIRTY(v, le_vec_get_length(v), out);
+    _le_vec_set_length(v, out);
+    return error;
+}
+
+bool le_vec_parse_ints(struct le_vec *v, const char *buf, size_t length, char sep, size_t *error_offset) {
+    size_t error = parse(v, buf, length, sep);
+
+    if (error != (size_t)-1 && error_offset != NULL) {
+        *error_offset = error;
+    }
+
+    return error == (size_t)-1;
+}
+
+bool le_vec_parse_ints_fd(struct le_vec *v, int fd, char sep, size_t *error_offset) {
+    size_t capacity = 2 * READ_CHUNK;
+    char *buf = malloc(capacity);
+    // Bytes of input before buf[0]
+    size_t consumed = 0;
+    // Bytes in buf: tail of the previous read that has no separator yet, then new input
+    size_t buffered = 0;
+    size_t error = (size_t)-1;
+
+    while (error == (size_t)-1) {
+        // A very long field might need more room
+        if (capacity - buffered < READ_CHUNK) {
+            capacity *= 2;
+            buf = realloc(buf, capacity);
+        }
+
+        ssize_t r = read(fd, buf + buffered, capacity - buffered);
+        if (r < 0 && errno == EINTR) {
+            continue;
+        }
+        if (r < 0) {
+            error = buffered;
+            break;
+        }
+        if (r == 0) {
+            error = parse(v, buf, buffered, sep);
+            break;
+        }
+        buffered += (size_t)r;
+
+        // Only complete fields are parsed, the rest waits for the next read
+        size_t end = buffered;
+        while (end > 0 && !is_separator(buf[end - 1], sep)) {
+            end--;
+        }
+        if (end == 0) {
+            continue;
+        }
+
+        error = parse(v, buf, end, sep);
+        if (error == (size_t)-1) {
+            memmove(buf, buf + end, buffered - end);
+            consumed += end;
+            buffered -= end;
+        }
+    }
+
+    free(buf);
+
+    if (error != (size_t)-1 && error_offset != NULL) {
+        *error_offset = consumed + error;
+    }
+
+    return error == (size_t)-1;
+}
+
+// Returns number of decimal digits in n
+static size_t count_digits(unsigned n) {
+    return 1 + (n >= 10) + (n >= 100) + (n >= 1000) + (n >= 10000) + (n >= 100000) + (n >= 1000000)
+        + (n >= 10000000) + (n >= 100000000) + (n >= 1000000000);
+}
+
+// Writes value in decimal to out, which must have room for MAX_FIELD bytes.
+// Returns number of written bytes.
+static size_t format_value(LE_VEC_TYPE value, char *out) {
+    unsigned magnitude = value < 0 ? 0u - (unsigned)value : (unsigned)value;
+    size_t length = (value < 0) + count_digits(magnitude);
+    char *p = out + length;
+
+    // Overwritten by the first digit of non-negative values
+    out[0] = '-';
+
+    while (magnitude >= 100) {
+        p -= 2;
+        memcpy(p, DIGIT_PAIRS + magnitude % 100 * 2, 2);
+        magnitude /= 100;
+    }
+    if (magnitude >= 10) {
+        p -= 2;
+        memcpy(p, DIGIT_PAIRS + magnitude * 2, 2);
+    } else {
+        p[-1] = (char)('0' + magnitude);
+    }
+
+    return length;
+}
+
+size_t le_vec_format(struct le_vec const *v, char *out, size_t capacity, char sep) {
+    size_t length = le_vec_get_length(v);
+    size_t written = 0;
+    size_t i = 0;
+
+    // While a whole field (and terminating zero) surely fits, values are formatted right into out
+    for (; i < length && written + MAX_FIELD < capacity; i++) {
+        written += format_value(v->data[i], out + written);
+        out[written] = sep;
+        written += i + 1 < length;
+    }
+
+    // Near the end fields are formatted aside and cut, but still counted
+    for (; i < length; i++) {
+        char field[MAX_FIELD];
+        size_t n = format_value(v->data[i], field);
+        if (i + 1 < length) {
+            field[n++] = sep;
+        }
+
+        if (written + 1 < capacity) {
+            size_t room = capacity - 1 - written;
+            memcpy(out + written, field, n < room ? n : room);
+        }
+        written += n;
+    }
+
+    if (capacity > 0) {
+        out[written < capacity ? written : capacity - 1] = '\0';
+    }
+
+    return written;
+}
+
+static bool write_all(int fd, const char *buf, size_t length) {
+    while (length > 0) {
+        ssize_t w = write(fd, buf, length);
+        if (w < 0 && errno == EINTR) {
+            continue;
+        }
+        if (w <= 0) {
+            return false;
+        }
+
+        buf += w;
+        length -= (size_t)w;
+    }
+
+    return true;
+}
+
+bool le_vec_write_text_fd(struct le_vec const *v, int fd, char sep) {
+    size_t length = le_vec_get_length(v);
+    char *buf = malloc(WRITE_BUFFER);
+    size_t buffered = 0;
+    bool success = true;
+
+    for (size_t i = 0; i < length && success; i++) {
+        if (buffered + MAX_FIELD > WRITE_BUFFER) {
+            success = write_all(fd, buf, buffered);
+            buffered = 0;
+        }
+
+        buffered += format_value(v->data[i], buf + buffered);
+        buf[buffered++] = i + 1 < length ? sep : '\n';
+    }
+
+    // Empty vector is still a (blank) line
+    if (length == 0) {
+        buf[buffered++] = '\n';
+    }
+
+    if (success) {
+        success = write_all(fd, buf, buffered);
+    }
+
+    free(buf);
+    return success;
+}
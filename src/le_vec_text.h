@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "le_vec.h"
+
+// Text input and output of vectors.
+// Text is a list of decimal integers separated by `sep` or newlines ("\n" or "\r\n"),
+// e.g. "1,-2,3\n4,5". Spaces and tabs around numbers are skipped, a single trailing
+// separator is allowed, empty fields are not.
+
+// Parses `length` bytes of text and appends numbers to v
+// Returns false on malformed input (bad character, empty field, number out of range of LE_VEC_TYPE),
+// then numbers before the error are kept and offset of the offending byte is stored in `error_offset` (might be NULL)
+bool le_vec_parse_ints(struct le_vec *v, const char *buf, size_t length, char sep, size_t *error_offset);
+// Same as `parse_ints()`, but reads text from file descriptor until EOF
+// Read errors are reported as malformed input at offset where reading stopped
+bool le_vec_parse_ints_fd(struct le_vec *v, int fd, char sep, size_t *error_offset);
+
+// Writes elements as text separated by `sep` to out, which has room for `capacity` bytes
+// Like snprintf(), text is cut to fit and always terminated by zero (if capacity > 0)
+// Returns length of the whole text, cut or not
+size_t le_vec_format(struct le_vec const *v, char *out, size_t capacity, char sep);
+// Writes elements as text separated by `sep` and followed by a newline to file descriptor
+// Empty vector is written as a lone newline
+// Returns false if writing fails
+bool le_vec_write_text_fd(struct le_vec const *v, int fd, char sep);
@@ -0,0 +1,28 @@
+#pragma once
+
+// Static user-space tracepoints (USDT) of provider `le_vec`, see tools/bpftrace/.
+// Probes are single nops unless a tracer is attached. Without <sys/sdt.h>
+// (systemtap-sdt-dev on Debian) they compile to nothing.
+// Internal, don't include it from outside src/.
+
+#if defined(__has_include)
+#if __has_include(<sys/sdt.h>)
+#include <sys/sdt.h>
+#define LE_VEC_TRACE_ENABLED 1
+#endif
+#endif
+
+// Fires probe `name` with the vector, its capacity before and after the operation and its length
+#ifdef LE_VEC_TRACE_ENABLED
+#define LE_VEC_TRACE(name, v, old_capacity, new_capacity, length) \
+    DTRACE_PROBE4(le_vec, name, (v), (old_capacity), (new_capacity), (length))
+#else
+// Arguments are still evaluated as void, so that variables kept only for probes don't warn
+#define LE_VEC_TRACE(name, v, old_capacity, new_capacity, length) \
+    do {                                                          \
+        (void)(v);                                                \
+        (void)(old_capacity);                                     \
+        (void)(new_capacity);                                     \
+        (void)(length);                                           \
+    } while (0)
+#endif
@@ -1,8 +1,30 @@
+#define _GNU_SOURCE
+
+#include <limits.h>
+#include <sched.h>
 #include <stdio.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
 #include "le_vec.h"
+#include "le_vec_compressed.h"
+#include "le_vec_rle.h"
+#include "le_vec_bool.h"
+#include "le_vec_stats.h"
+#include "le_vec_sorted.h"
+#include "le_vec_numa.h"
+#include "le_vec_aggregates.h"
+#include "le_vec_dirty.h"
+#include "le_vec_hash.h"
+#include "le_vec_histogram.h"
+#include "le_vec_jagged.h"
+#include "le_vec_math.h"
+#include "le_vec_persistent.h"
+#include "le_vec_text.h"
+#include "le_vec_table.h"
 #include "util.h"
 #include "tests/common.h"
 
@@ -32,6 +54,19 @@ void test_init_with_invalid_length(void) {
     ASSERT_EQUAL(v, NULL)
 }
 
+void test_init_with_capacity(void) {
+    struct le_vec *v = le_vec_init_with_capacity(1000);
+
+    ASSERT_NOT_EQUAL(v, NULL)
+    ASSERT_EQUAL(le_vec_get_capacity(v), 1000)
+    ASSERT_EQUAL(le_vec_get_length(v), 0)
+    le_vec_destroy(v);
+
+    v = le_vec_init_with_capacity(0);
+    ASSERT_EQUAL(le_vec_get_capacity(v), LE_VEC_DEFAULT_CAPACITY)
+    le_vec_destroy(v);
+}
+
 void test_destroy_null(void) {
     struct le_vec *v = NULL;
 
@@ -177,6 +212,121 @@ void test_resize(void) {
     le_vec_destroy(v);
 }
 
+void test_push_after_resize_to_zero(void) {
+    struct le_vec *v = le_vec_init();
+
+    le_vec_resize(v, 0);
+    for (int i = 0; i < 100; i++) {
+        le_vec_push_back(v, i);
+    }
+    ASSERT_EQUAL(le_vec_get_length(v), 100)
+    ASSERT_BGE(le_vec_get_capacity(v), 100)
+    ASSERT_EQUAL(le_vec_get_at(v, 99), 99)
+
+    le_vec_destroy(v);
+}
+
+void test_resize_uninit(void) {
+    struct le_vec *v = le_vec_init();
+    le_vec_push_back(v, 5);
+
+    le_vec_resize_uninit(v, 1000);
+    ASSERT_EQUAL(le_vec_get_length(v), 1000)
+    ASSERT_BGE(le_vec_get_capacity(v), 1000)
+    ASSERT_EQUAL(le_vec_get_at(v, 0), 5)
+
+    // Capacity is kept when shrinking
+    size_t capacity = le_vec_get_capacity(v);
+    le_vec_resize_uninit(v, 1);
+    ASSERT_EQUAL(le_vec_get_length(v), 1)
+    ASSERT_EQUAL(le_vec_get_capacity(v), capacity)
+    ASSERT_EQUAL(le_vec_get_at(v, 0), 5)
+
+    le_vec_destroy(v);
+}
+
+void test_resize_fill(void) {
+    struct le_vec *v = le_vec_init();
+    le_vec_push_back(v, 1);
+    le_vec_push_back(v, 2);
+
+    // Odd length leaves tails around full vector registers
+    le_vec_resize_fill(v, 103, -7);
+    ASSERT_EQUAL(le_vec_get_length(v), 103)
+    ASSERT_EQUAL(le_vec_get_at(v, 1), 2)
+    ASSERT_EQUAL(le_vec_count(v, -7), 101)
+
+    le_vec_resize_fill(v, 50, 9);
+    ASSERT_EQUAL(le_vec_get_length(v), 50)
+    ASSERT_EQUAL(le_vec_count(v, 9), 0)
+
+    // Big growth by 0 takes a zeroed buffer, elements before it stay
+    le_vec_resize_fill(v, 1000000, 0);
+    ASSERT_EQUAL(le_vec_get_length(v), 1000000)
+    ASSERT_EQUAL(le_vec_get_at(v, 0), 1)
+    ASSERT_EQUAL(le_vec_get_at(v, 49), -7)
+    ASSERT_EQUAL(le_vec_count(v, 0), 1000000 - 50)
+
+    // Capacity is already there, so zeros are stored
+    le_vec_resize(v, 600000);
+    le_vec_set_at(v, 599999, 3);
+    le_vec_resize_uninit(v, 500000);
+    le_vec_resize_fill(v, 600000, 0);
+    ASSERT_EQUAL(le_vec_get_at(v, 599999), 0)
+    ASSERT_EQUAL(le_vec_count(v, 0), 600000 - 50)
+
+    le_vec_destroy(v);
+}
+
+void test_iota(void) {
+    struct le_vec *v = le_vec_init();
+    le_vec_iota(v, 1, 1);
+    ASSERT_EQUAL(le_vec_get_length(v), 0)
+
+    size_t lengths[] = {1, 7, 8, 9, 100, 1001};
+    bool all_match = true;
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        le_vec_resize_uninit(v, lengths[l]);
+        le_vec_iota(v, 10, -3);
+        for (size_t i = 0; i < lengths[l]; i++) {
+            all_match = all_match && le_vec_get_at(v, i) == 10 - 3 * (int)i;
+        }
+    }
+    ASSERT(all_match, "iota differs")
+
+    // Values wrap around
+    le_vec_resize_uninit(v, 3);
+    le_vec_iota(v, INT_MAX, 1);
+    ASSERT_EQUAL(le_vec_get_at(v, 0), INT_MAX)
+    ASSERT_EQUAL(le_vec_get_at(v, 1), INT_MIN)
+    ASSERT_EQUAL(le_vec_get_at(v, 2), INT_MIN + 1)
+
+    le_vec_destroy(v);
+}
+
+void test_fill_parallel(void) {
+    le_vec_set_thread_count(4);
+
+    // Big enough for several threads and for streaming stores
+    size_t length = 5 * 1024 * 1024 + 3;
+    struct le_vec *v = le_vec_init_with_capacity(length);
+    le_vec_resize_uninit(v, length);
+    le_vec_iota(v, -1000, 2);
+
+    bool all_match = true;
+    for (size_t i = 0; i < length; i++) {
+        all_match = all_match && le_vec_get_at(v, i) == -1000 + 2 * (int)i;
+    }
+    ASSERT(all_match, "parallel iota differs")
+
+    le_vec_resize(v, 0);
+    le_vec_resize_fill(v, length, 42);
+    ASSERT_EQUAL(le_vec_count(v, 42), length)
+
+    le_vec_destroy(v);
+    le_vec_set_thread_count(0);
+}
+
 void test_extend(void) {
     struct le_vec *v1 = le_vec_init();
     le_vec_push_back(v1, 1);
@@ -604,6 +754,78 @@ void test_rfind_n(void) {
     le_vec_destroy(v);
 }
 
+// Returns index of `n`th value from start (or from end if reverse) found by plain scan
+size_t find_n_naive(struct le_vec const *v, int value, size_t n, bool reverse) {
+    size_t length = le_vec_get_length(v);
+    for (size_t i = 0; i < length; i++) {
+        size_t index = reverse ? length - 1 - i : i;
+        if (le_vec_get_at(v, index) == value && --n == 0) {
+            return index;
+        }
+    }
+
+    return (size_t)-1;
+}
+
+void test_find_block_edges(void) {
+    // Blocks grow 32, 64, 128, ... elements from the start of the search, matches straddle their edges
+    struct le_vec *v = le_vec_init();
+    for (size_t i = 0; i < 20000; i++) {
+        le_vec_push_back(v, i % 31 == 30 || i % 97 == 0 ? 4 : 0);
+    }
+
+    size_t ns[] = {1, 2, 3, 10, 64, 300, 500, 800, 1000};
+    bool all_match = true;
+    for (size_t length = 1; length <= 20000; length = length * 3 / 2 + 1) {
+        le_vec_resize(v, length);
+        for (size_t j = 0; j < sizeof(ns) / sizeof(ns[0]); j++) {
+            all_match = all_match && le_vec_find_n(v, 4, ns[j]) == find_n_naive(v, 4, ns[j], false);
+            all_match = all_match && le_vec_rfind_n(v, 4, ns[j]) == find_n_naive(v, 4, ns[j], true);
+        }
+    }
+    ASSERT(all_match, "search differs from plain scan")
+
+    le_vec_destroy(v);
+}
+
+void test_find_parallel(void) {
+    le_vec_set_thread_count(4);
+
+    // Sparse 7s in the first and the last quarters, dense 5s in the middle, 3s in the middle of every quarter
+    size_t length = 4 * 256 * 1024 + 123;
+    struct le_vec *v = le_vec_init();
+    for (size_t i = 0; i < length; i++) {
+        int value = 0;
+        if ((i < length / 4 || i > length / 4 * 3) && i % 1000 == 0) {
+            value = 7;
+        } else if (i > length / 3 && i < length / 3 * 2 && i % 3 == 0) {
+            value = 5;
+        } else if (i % (length / 4) == length / 8) {
+            value = 3;
+        }
+        le_vec_push_back(v, value);
+    }
+
+    int values[] = {7, 5, 3, 1};
+    size_t ns[] = {1, 2, 3, 4, 5, 262, 263, 300, 1000, 50000, 100000, 1000000};
+    bool all_match = true;
+    for (size_t i = 0; i < sizeof(values) / sizeof(values[0]); i++) {
+        for (size_t j = 0; j < sizeof(ns) / sizeof(ns[0]); j++) {
+            all_match = all_match && le_vec_find_n(v, values[i], ns[j]) == find_n_naive(v, values[i], ns[j], false);
+            all_match = all_match && le_vec_rfind_n(v, values[i], ns[j]) == find_n_naive(v, values[i], ns[j], true);
+        }
+    }
+    ASSERT(all_match, "parallel search differs from plain scan")
+
+    ASSERT_EQUAL(le_vec_find(v, 7), 0)
+    ASSERT_EQUAL(le_vec_rfind(v, 3), length / 8 + length / 4 * 3)
+    ASSERT_EQUAL(le_vec_find(v, 1), (size_t)-1)
+    ASSERT_EQUAL(le_vec_find_n(v, 7, 0), (size_t)-1)
+
+    le_vec_destroy(v);
+    le_vec_set_thread_count(0);
+}
+
 void test_replace_all(void) {
     struct le_vec *v = le_vec_init();
     le_vec_push_back(v, 1);
@@ -700,10 +922,2308 @@ void test_rreplace_n(void) {
     le_vec_destroy(v);
 }
 
+void test_compressed_sorted(void) {
+    struct le_vec *v = le_vec_init();
+    int value = -1000;
+    for (int i = 0; i < 1000; i++) {
+        value += (i * 7) % 13;
+        le_vec_push_back(v, value);
+    }
+
+    struct le_vec_compressed *c = le_vec_compressed_init(v);
+    ASSERT_NOT_EQUAL(c, NULL)
+    ASSERT_EQUAL(le_vec_compressed_get_length(c), 1000)
+    ASSERT(le_vec_compressed_get_ratio(c) > 4.0, "sorted data should compress well")
+
+    bool all_equal = true;
+    for (size_t i = 0; i < le_vec_get_length(v); i++) {
+        all_equal = all_equal && le_vec_compressed_get_at(c, i) == le_vec_get_at(v, i);
+    }
+    ASSERT(all_equal, "compressed elements differ")
+
+    le_vec_compressed_destroy(c);
+    le_vec_destroy(v);
+}
+
+void test_compressed_round_trip(void) {
+    struct le_vec *v = le_vec_init();
+    unsigned int state = 12345;
+    for (int i = 0; i < 300; i++) {
+        state = state * 1103515245 + 12345;
+        le_vec_push_back(v, (int)state);
+    }
+    le_vec_push_back(v, 2147483647);
+    le_vec_push_back(v, -2147483647 - 1);
+
+    struct le_vec_compressed *c = le_vec_compressed_init(v);
+    struct le_vec *decompressed = le_vec_compressed_to_vec(c);
+
+    ASSERT_EQUAL(le_vec_get_length(decompressed), 302)
+    bool all_equal = true;
+    for (size_t i = 0; i < le_vec_get_length(v); i++) {
+        all_equal = all_equal && le_vec_get_at(decompressed, i) == le_vec_get_at(v, i);
+        all_equal = all_equal && le_vec_compressed_get_at(c, i) == le_vec_get_at(v, i);
+    }
+    ASSERT(all_equal, "decompressed elements differ")
+
+    le_vec_destroy(decompressed);
+    le_vec_compressed_destroy(c);
+    le_vec_destroy(v);
+}
+
+void test_compressed_count_find_sum(void) {
+    struct le_vec *v = le_vec_init();
+    for (int i = 0; i < 500; i++) {
+        le_vec_push_back(v, i % 10 == 0 ? 77 : i);
+    }
+
+    struct le_vec_compressed *c = le_vec_compressed_init(v);
+
+    ASSERT_EQUAL(le_vec_compressed_count(c, 77), le_vec_count(v, 77))
+    ASSERT_EQUAL(le_vec_compressed_count(c, 499), 1)
+    ASSERT_EQUAL(le_vec_compressed_count(c, -5), 0)
+    ASSERT_EQUAL(le_vec_compressed_find(c, 77), 0)
+    ASSERT_EQUAL(le_vec_compressed_find(c, 321), 321)
+    ASSERT_EQUAL(le_vec_compressed_find(c, 100000), (size_t)-1)
+
+    long long sum = 0;
+    for (size_t i = 0; i < le_vec_get_length(v); i++) {
+        sum += le_vec_get_at(v, i);
+    }
+    ASSERT_EQUAL(le_vec_compressed_sum(c), sum)
+
+    le_vec_compressed_destroy(c);
+    le_vec_destroy(v);
+}
+
+void test_compressed_empty(void) {
+    struct le_vec *v = le_vec_init();
+
+    struct le_vec_compressed *c = le_vec_compressed_init(v);
+    ASSERT_EQUAL(le_vec_compressed_get_length(c), 0)
+    ASSERT_EQUAL(le_vec_compressed_count(c, 0), 0)
+    ASSERT_EQUAL(le_vec_compressed_sum(c), 0)
+
+    struct le_vec *decompressed = le_vec_compressed_to_vec(c);
+    ASSERT_EQUAL(le_vec_get_length(decompressed), 0)
+
+    le_vec_destroy(decompressed);
+    le_vec_compressed_destroy(c);
+    le_vec_destroy(v);
+}
+
+void test_rle_push_pop(void) {
+    struct le_vec_rle *r = le_vec_rle_init();
+
+    le_vec_rle_push_back(r, 5);
+    le_vec_rle_push_back(r, 5);
+    le_vec_rle_push_back(r, 5);
+    le_vec_rle_push_back(r, 7);
+    ASSERT_EQUAL(le_vec_rle_get_length(r), 4)
+    ASSERT_EQUAL(le_vec_rle_get_runs_length(r), 2)
+    ASSERT_EQUAL(le_vec_rle_get_at(r, 0), 5)
+    ASSERT_EQUAL(le_vec_rle_get_at(r, 2), 5)
+    ASSERT_EQUAL(le_vec_rle_get_at(r, 3), 7)
+
+    ASSERT_EQUAL(le_vec_rle_pop_back(r), 7)
+    ASSERT_EQUAL(le_vec_rle_get_runs_length(r), 1)
+    ASSERT_EQUAL(le_vec_rle_pop_back(r), 5)
+    ASSERT_EQUAL(le_vec_rle_get_length(r), 2)
+
+    le_vec_rle_destroy(r);
+}
+
+void test_rle_set_at(void) {
+    struct le_vec_rle *r = le_vec_rle_init();
+    for (int i = 0; i < 10; i++) {
+        le_vec_rle_push_back(r, 1);
+    }
+
+    ASSERT_EQUAL(le_vec_rle_set_at(r, 4, 2), true)
+    ASSERT_EQUAL(le_vec_rle_get_runs_length(r), 3)
+    ASSERT_EQUAL(le_vec_rle_get_at(r, 3), 1)
+    ASSERT_EQUAL(le_vec_rle_get_at(r, 4), 2)
+    ASSERT_EQUAL(le_vec_rle_get_at(r, 5), 1)
+
+    ASSERT_EQUAL(le_vec_rle_set_at(r, 5, 2), true)
+    ASSERT_EQUAL(le_vec_rle_get_runs_length(r), 3)
+
+    ASSERT_EQUAL(le_vec_rle_set_at(r, 4, 1), true)
+    ASSERT_EQUAL(le_vec_rle_set_at(r, 5, 1), true)
+    ASSERT_EQUAL(le_vec_rle_get_runs_length(r), 1)
+
+    ASSERT_EQUAL(le_vec_rle_set_at(r, 0, 3), true)
+    ASSERT_EQUAL(le_vec_rle_set_at(r, 9, 3), true)
+    ASSERT_EQUAL(le_vec_rle_get_runs_length(r), 3)
+    ASSERT_EQUAL(le_vec_rle_get_at(r, 0), 3)
+    ASSERT_EQUAL(le_vec_rle_get_at(r, 9), 3)
+
+    ASSERT_EQUAL(le_vec_rle_set_at(r, 10, 3), false)
+
+    le_vec_rle_destroy(r);
+}
+
+void test_rle_count_find_replace(void) {
+    struct le_vec *v = le_vec_init();
+    int pattern[] = {4, 4, 4, 0, 0, 4, 9, 9, 0, 4};
+    for (size_t i = 0; i < array_length(pattern); i++) {
+        le_vec_push_back(v, pattern[i]);
+    }
+
+    struct le_vec_rle *r = le_vec_rle_init_from_vec(v);
+    ASSERT_EQUAL(le_vec_rle_get_runs_length(r), 6)
+    ASSERT_EQUAL(le_vec_rle_count(r, 4), 5)
+    ASSERT_EQUAL(le_vec_rle_count(r, 0), 3)
+    ASSERT_EQUAL(le_vec_rle_count(r, 1), 0)
+    ASSERT_EQUAL(le_vec_rle_find(r, 0), 3)
+    ASSERT_EQUAL(le_vec_rle_find_n(r, 4, 4), 5)
+    ASSERT_EQUAL(le_vec_rle_find_n(r, 4, 5), 9)
+    ASSERT_EQUAL(le_vec_rle_find_n(r, 4, 6), (size_t)-1)
+
+    ASSERT_EQUAL(le_vec_rle_replace_all(r, 0, 4), 3)
+    ASSERT_EQUAL(le_vec_rle_get_runs_length(r), 3)
+    ASSERT_EQUAL(le_vec_rle_count(r, 4), 8)
+
+    struct le_vec *decoded = le_vec_rle_to_vec(r);
+    ASSERT_EQUAL(le_vec_get_length(decoded), 10)
+    ASSERT_EQUAL(le_vec_get_at(decoded, 3), 4)
+    ASSERT_EQUAL(le_vec_get_at(decoded, 6), 9)
+    ASSERT_EQUAL(le_vec_get_at(decoded, 9), 4)
+
+    le_vec_destroy(decoded);
+    le_vec_rle_destroy(r);
+    le_vec_destroy(v);
+}
+
+void test_bool_push_get_set(void) {
+    struct le_vec_bool *b = le_vec_bool_init();
+    for (size_t i = 0; i < 200; i++) {
+        le_vec_bool_push_back(b, i % 3 == 0);
+    }
+
+    ASSERT_EQUAL(le_vec_bool_get_length(b), 200)
+    ASSERT_EQUAL(le_vec_bool_get_at(b, 0), true)
+    ASSERT_EQUAL(le_vec_bool_get_at(b, 1), false)
+    ASSERT_EQUAL(le_vec_bool_get_at(b, 198), true)
+
+    ASSERT_EQUAL(le_vec_bool_set_at(b, 1, true), true)
+    ASSERT_EQUAL(le_vec_bool_get_at(b, 1), true)
+    ASSERT_EQUAL(le_vec_bool_set_at(b, 200, true), false)
+
+    ASSERT_EQUAL(le_vec_bool_pop_back(b), false)
+    ASSERT_EQUAL(le_vec_bool_pop_back(b), true)
+    ASSERT_EQUAL(le_vec_bool_get_length(b), 198)
+
+    le_vec_bool_destroy(b);
+}
+
+void test_bool_count_find(void) {
+    struct le_vec_bool *b = le_vec_bool_init_with_length(130);
+
+    ASSERT_EQUAL(le_vec_bool_count(b, true), 0)
+    ASSERT_EQUAL(le_vec_bool_count(b, false), 130)
+    ASSERT_EQUAL(le_vec_bool_find(b, true), (size_t)-1)
+
+    le_vec_bool_set_at(b, 3, true);
+    le_vec_bool_set_at(b, 64, true);
+    le_vec_bool_set_at(b, 129, true);
+
+    ASSERT_EQUAL(le_vec_bool_count(b, true), 3)
+    ASSERT_EQUAL(le_vec_bool_count(b, false), 127)
+    ASSERT_EQUAL(le_vec_bool_find(b, true), 3)
+    ASSERT_EQUAL(le_vec_bool_find(b, false), 0)
+    ASSERT_EQUAL(le_vec_bool_find_n(b, true, 2), 64)
+    ASSERT_EQUAL(le_vec_bool_find_n(b, true, 3), 129)
+    ASSERT_EQUAL(le_vec_bool_find_n(b, true, 4), (size_t)-1)
+    ASSERT_EQUAL(le_vec_bool_find_n(b, false, 4), 4)
+    ASSERT_EQUAL(le_vec_bool_rfind(b, true), 129)
+    ASSERT_EQUAL(le_vec_bool_rfind(b, false), 128)
+
+    le_vec_bool_resize(b, 100);
+    ASSERT_EQUAL(le_vec_bool_count(b, true), 2)
+    le_vec_bool_resize(b, 200);
+    ASSERT_EQUAL(le_vec_bool_count(b, true), 2)
+    ASSERT_EQUAL(le_vec_bool_get_at(b, 129), false)
+
+    le_vec_bool_destroy(b);
+}
+
+void test_bool_reverse(void) {
+    struct le_vec_bool *b = le_vec_bool_init();
+    for (size_t i = 0; i < 150; i++) {
+        le_vec_bool_push_back(b, i % 7 == 0 || i == 149);
+    }
+
+    le_vec_bool_reverse(b);
+
+    bool all_equal = true;
+    for (size_t i = 0; i < 150; i++) {
+        size_t original = 149 - i;
+        all_equal = all_equal && le_vec_bool_get_at(b, i) == (original % 7 == 0 || original == 149);
+    }
+    ASSERT(all_equal, "reversed elements differ")
+    ASSERT_EQUAL(le_vec_bool_get_length(b), 150)
+    ASSERT_EQUAL(le_vec_bool_count(b, true), 23)
+
+    le_vec_bool_destroy(b);
+}
+
+void test_bool_bitwise(void) {
+    struct le_vec_bool *a = le_vec_bool_init();
+    struct le_vec_bool *b = le_vec_bool_init();
+    bool a_values[] = {true, true, false, false};
+    bool b_values[] = {true, false, true, false};
+    for (size_t i = 0; i < array_length(a_values); i++) {
+        le_vec_bool_push_back(a, a_values[i]);
+        le_vec_bool_push_back(b, b_values[i]);
+    }
+
+    struct le_vec_bool *short_vec = le_vec_bool_init_with_length(3);
+    ASSERT_EQUAL(le_vec_bool_and(a, short_vec), false)
+
+    ASSERT_EQUAL(le_vec_bool_xor(a, b), true)
+    ASSERT_EQUAL(le_vec_bool_get_at(a, 0), false)
+    ASSERT_EQUAL(le_vec_bool_get_at(a, 1), true)
+    ASSERT_EQUAL(le_vec_bool_get_at(a, 2), true)
+    ASSERT_EQUAL(le_vec_bool_get_at(a, 3), false)
+
+    ASSERT_EQUAL(le_vec_bool_andnot(a, b), true)
+    ASSERT_EQUAL(le_vec_bool_count(a, true), 1)
+    ASSERT_EQUAL(le_vec_bool_get_at(a, 1), true)
+
+    ASSERT_EQUAL(le_vec_bool_or(a, b), true)
+    ASSERT_EQUAL(le_vec_bool_count(a, true), 3)
+
+    ASSERT_EQUAL(le_vec_bool_and(a, b), true)
+    ASSERT_EQUAL(le_vec_bool_count(a, true), 2)
+    ASSERT_EQUAL(le_vec_bool_get_at(a, 0), true)
+    ASSERT_EQUAL(le_vec_bool_get_at(a, 2), true)
+
+    le_vec_bool_destroy(short_vec);
+    le_vec_bool_destroy(b);
+    le_vec_bool_destroy(a);
+}
+
+void test_table_push_pop(void) {
+    ASSERT_EQUAL(le_vec_table_init(0), NULL)
+
+    struct le_vec_table *t = le_vec_table_init(3);
+    ASSERT_EQUAL(le_vec_table_get_columns_length(t), 3)
+    ASSERT_EQUAL(le_vec_table_is_empty(t), true)
+
+    // Several growths of all columns at once
+    for (int i = 0; i < 1000; i++) {
+        LE_VEC_TYPE row[] = {i, i * 2, -i};
+        le_vec_table_push_back(t, row);
+    }
+    ASSERT_EQUAL(le_vec_table_get_length(t), 1000)
+    ASSERT_EQUAL(le_vec_table_get_capacity(t) >= 1000, true)
+    ASSERT_EQUAL(le_vec_table_get_at(t, 0, 0), 0)
+    ASSERT_EQUAL(le_vec_table_get_at(t, 999, 1), 1998)
+    ASSERT_EQUAL(le_vec_table_get_at(t, 500, 2), -500)
+
+    LE_VEC_TYPE row[3];
+    ASSERT_EQUAL(le_vec_table_get_row(t, 7, row), true)
+    ASSERT_EQUAL(row[0], 7)
+    ASSERT_EQUAL(row[1], 14)
+    ASSERT_EQUAL(row[2], -7)
+    ASSERT_EQUAL(le_vec_table_get_row(t, 1000, row), false)
+
+    ASSERT_EQUAL(le_vec_table_pop_back(t, row), true)
+    ASSERT_EQUAL(row[0], 999)
+    ASSERT_EQUAL(row[2], -999)
+    ASSERT_EQUAL(le_vec_table_pop_back(t, NULL), true)
+    ASSERT_EQUAL(le_vec_table_get_length(t), 998)
+
+    ASSERT_EQUAL(le_vec_table_set_at(t, 3, 1, 42), true)
+    ASSERT_EQUAL(le_vec_table_get_at(t, 3, 1), 42)
+    ASSERT_EQUAL(le_vec_table_set_at(t, 998, 1, 42), false)
+    ASSERT_EQUAL(le_vec_table_set_at(t, 3, 3, 42), false)
+
+    // Shrinking keeps the rest of rows
+    le_vec_table_resize(t, 10);
+    ASSERT_EQUAL(le_vec_table_get_length(t), 10)
+    ASSERT_EQUAL(le_vec_table_get_capacity(t) < 1000, true)
+    ASSERT_EQUAL(le_vec_table_get_at(t, 9, 0), 9)
+    ASSERT_EQUAL(le_vec_table_get_at(t, 9, 2), -9)
+
+    while (le_vec_table_pop_back(t, NULL)) {
+    }
+    ASSERT_EQUAL(le_vec_table_is_empty(t), true)
+    le_vec_table_resize(t, 0);
+    LE_VEC_TYPE last[] = {1, 2, 3};
+    le_vec_table_push_back(t, last);
+    ASSERT_EQUAL(le_vec_table_get_at(t, 0, 2), 3)
+
+    le_vec_table_destroy(t);
+    le_vec_table_destroy(NULL);
+}
+
+LE_VEC_TYPE double_value(LE_VEC_TYPE value) {
+    return value * 2;
+}
+
+void test_table_columns(void) {
+    struct le_vec_table *t = le_vec_table_init(2);
+    for (int i = 0; i < 100; i++) {
+        LE_VEC_TYPE row[] = {i, i % 10};
+        le_vec_table_push_back(t, row);
+    }
+
+    ASSERT_EQUAL(le_vec_table_column(t, 2), NULL)
+
+    struct le_vec const *ids = le_vec_table_column(t, 0);
+    ASSERT_EQUAL(le_vec_get_length(ids), 100)
+    ASSERT_EQUAL(le_vec_find(ids, 57), 57)
+    ASSERT_EQUAL(le_vec_count(le_vec_table_column(t, 1), 3), 10)
+
+    struct le_vec *sums = le_vec_inclusive_scanned(le_vec_table_column(t, 0));
+    ASSERT_EQUAL(le_vec_get_at(sums, 99), 4950)
+    le_vec_destroy(sums);
+
+    ASSERT_EQUAL(le_vec_table_for_each(t, 1, double_value), true)
+    ASSERT_EQUAL(le_vec_table_for_each(t, 2, double_value), false)
+    ASSERT_EQUAL(le_vec_table_get_at(t, 13, 1), 6)
+    ASSERT_EQUAL(le_vec_table_get_at(t, 13, 0), 13)
+
+    le_vec_table_destroy(t);
+}
+
+void test_table_gather(void) {
+    struct le_vec_table *t = le_vec_table_init(2);
+    for (int i = 0; i < 50; i++) {
+        LE_VEC_TYPE row[] = {i, 100 + i};
+        le_vec_table_push_back(t, row);
+    }
+
+    struct le_vec *rows = le_vec_init();
+    le_vec_push_back(rows, 49);
+    le_vec_push_back(rows, 0);
+    le_vec_push_back(rows, 49);
+
+    struct le_vec_table *gathered = le_vec_table_gather(t, rows);
+    ASSERT_EQUAL(le_vec_table_get_length(gathered), 3)
+    ASSERT_EQUAL(le_vec_table_get_columns_length(gathered), 2)
+    ASSERT_EQUAL(le_vec_table_get_at(gathered, 0, 0), 49)
+    ASSERT_EQUAL(le_vec_table_get_at(gathered, 1, 1), 100)
+    ASSERT_EQUAL(le_vec_table_get_at(gathered, 2, 1), 149)
+    le_vec_table_destroy(gathered);
+
+    le_vec_push_back(rows, 50);
+    ASSERT_EQUAL(le_vec_table_gather(t, rows), NULL)
+    le_vec_set_at(rows, 3, -1);
+    ASSERT_EQUAL(le_vec_table_gather(t, rows), NULL)
+
+    le_vec_destroy(rows);
+    le_vec_table_destroy(t);
+}
+
+// Checks that persistent vector holds exactly the expected elements, both by index and when converted
+bool persistent_equals(struct le_vec_persistent const *p, int const *expected, size_t length) {
+    if (le_vec_persistent_get_length(p) != length) {
+        return false;
+    }
+
+    bool equal = true;
+    for (size_t i = 0; equal && i < length; i++) {
+        equal = le_vec_persistent_get_at(p, i) == expected[i];
+    }
+
+    struct le_vec *v = le_vec_persistent_to_vec(p);
+    equal = equal && le_vec_get_length(v) == length;
+    for (size_t i = 0; equal && i < length; i++) {
+        equal = le_vec_get_at(v, i) == expected[i];
+    }
+    le_vec_destroy(v);
+
+    return equal;
+}
+
+void test_persistent_push_set_pop(void) {
+    int expected[3000];
+    struct le_vec_persistent *versions[4];
+    versions[0] = le_vec_persistent_init();
+    ASSERT_EQUAL(le_vec_persistent_is_empty(versions[0]), true)
+    ASSERT_EQUAL(le_vec_persistent_pop_back(versions[0]), NULL)
+
+    // Pushes enough to grow the tree to three levels, keeping every version alive
+    struct le_vec_persistent *p = le_vec_persistent_push_back(versions[0], 0);
+    expected[0] = 0;
+    for (int i = 1; i < 3000; i++) {
+        struct le_vec_persistent *next = le_vec_persistent_push_back(p, i);
+        if (i == 31 || i == 1056) {
+            versions[i == 31 ? 1 : 2] = p;
+        } else {
+            le_vec_persistent_destroy(p);
+        }
+        p = next;
+        expected[i] = i;
+    }
+    ASSERT(persistent_equals(p, expected, 3000), "pushed elements differ")
+    ASSERT(persistent_equals(versions[1], expected, 31), "old version changed")
+    ASSERT(persistent_equals(versions[2], expected, 1056), "old version changed")
+
+    struct le_vec_persistent *changed = le_vec_persistent_set_at(p, 5, -5);
+    ASSERT_EQUAL(le_vec_persistent_set_at(p, 3000, 1), NULL)
+    ASSERT_EQUAL(le_vec_persistent_get_at(changed, 5), -5)
+    ASSERT_EQUAL(le_vec_persistent_get_at(p, 5), 5)
+    versions[3] = le_vec_persistent_set_at(changed, 2999, -1);
+    ASSERT_EQUAL(le_vec_persistent_get_at(changed, 2999), 2999)
+    ASSERT_EQUAL(le_vec_persistent_get_at(versions[3], 2999), -1)
+    le_vec_persistent_destroy(changed);
+
+    // Pops everything, crossing from the tail into the tree many times
+    size_t length = 3000;
+    while (length > 0) {
+        struct le_vec_persistent *next = le_vec_persistent_pop_back(p);
+        le_vec_persistent_destroy(p);
+        p = next;
+        length--;
+        if (length % 97 == 0 && !persistent_equals(p, expected, length)) {
+            break;
+        }
+    }
+    ASSERT_EQUAL(length, 0)
+    ASSERT_EQUAL(le_vec_persistent_is_empty(p), true)
+    ASSERT(persistent_equals(versions[2], expected, 1056), "old version changed")
+
+    le_vec_persistent_destroy(p);
+    for (size_t i = 0; i < 4; i++) {
+        le_vec_persistent_destroy(versions[i]);
+    }
+}
+
+void test_persistent_concat_slice(void) {
+    // Versions are built from pieces of very different sizes, so concatenation has to rebalance
+    enum { VERSIONS = 40, MAX_LENGTH = 20000 };
+    struct le_vec_persistent *versions[VERSIONS];
+    int *expected[VERSIONS];
+    size_t lengths[VERSIONS];
+
+    unsigned seed = 7;
+    for (size_t i = 0; i < VERSIONS; i++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned r = seed >> 8;
+        expected[i] = malloc(MAX_LENGTH * sizeof(int));
+
+        if (i < 8 || r % 3 == 0) {
+            size_t length = i % 4 == 0 ? r % 40 : r % 3000;
+            struct le_vec *v = le_vec_init();
+            for (size_t j = 0; j < length; j++) {
+                le_vec_push_back(v, (int)(i * MAX_LENGTH + j));
+                expected[i][j] = (int)(i * MAX_LENGTH + j);
+            }
+            versions[i] = le_vec_persistent_init_from_vec(v);
+            lengths[i] = length;
+            le_vec_destroy(v);
+        } else if (r % 3 == 1) {
+            size_t a = (r / 3) % i;
+            size_t b = (r / 97) % i;
+            if (lengths[a] + lengths[b] > MAX_LENGTH) {
+                b = a = 0;
+            }
+            versions[i] = le_vec_persistent_concat(versions[a], versions[b]);
+            memcpy(expected[i], expected[a], lengths[a] * sizeof(int));
+            memcpy(expected[i] + lengths[a], expected[b], lengths[b] * sizeof(int));
+            lengths[i] = lengths[a] + lengths[b];
+        } else {
+            size_t a = (r / 3) % i;
+            size_t start = lengths[a] > 0 ? (r / 7) % lengths[a] : 0;
+            size_t end = start + (r / 13) % (lengths[a] - start + 1);
+            versions[i] = le_vec_persistent_slice(versions[a], start, end);
+            memcpy(expected[i], expected[a] + start, (end - start) * sizeof(int));
+            lengths[i] = end - start;
+        }
+    }
+
+    bool ok = true;
+    for (size_t i = 0; i < VERSIONS; i++) {
+        ok = ok && persistent_equals(versions[i], expected[i], lengths[i]);
+    }
+    ASSERT(ok, "concatenated or sliced elements differ")
+
+    // Modifications of a concatenated version stay in it
+    struct le_vec_persistent *both = le_vec_persistent_concat(versions[1], versions[2]);
+    struct le_vec_persistent *twice = le_vec_persistent_concat(both, both);
+    size_t length = le_vec_persistent_get_length(both);
+    struct le_vec_persistent *changed = le_vec_persistent_set_at(twice, length, -1);
+    ASSERT_EQUAL(le_vec_persistent_get_at(changed, length), -1)
+    ASSERT_EQUAL(le_vec_persistent_get_at(twice, length), le_vec_persistent_get_at(both, 0))
+    ASSERT_EQUAL(le_vec_persistent_slice(both, 1, 0), NULL)
+    ASSERT_EQUAL(le_vec_persistent_slice(both, 0, length + 1), NULL)
+    le_vec_persistent_destroy(changed);
+    le_vec_persistent_destroy(twice);
+    le_vec_persistent_destroy(both);
+
+    for (size_t i = 0; i < VERSIONS; i++) {
+        le_vec_persistent_destroy(versions[i]);
+        free(expected[i]);
+    }
+}
+
+void test_persistent_transient(void) {
+    struct le_vec_persistent *p = le_vec_persistent_init();
+    struct le_vec_transient *t = le_vec_persistent_transient(p);
+    int expected[5000];
+    for (int i = 0; i < 5000; i++) {
+        le_vec_transient_push_back(t, i);
+        expected[i] = i;
+    }
+    struct le_vec_persistent *built = le_vec_transient_persistent(t);
+    ASSERT(persistent_equals(built, expected, 5000), "transient pushes differ")
+    ASSERT_EQUAL(le_vec_persistent_is_empty(p), true)
+
+    // Edits of a transient don't show through the version it was made from
+    t = le_vec_persistent_transient(built);
+    for (size_t i = 0; i < 5000; i += 7) {
+        le_vec_transient_set_at(t, i, -1);
+    }
+    ASSERT_EQUAL(le_vec_transient_set_at(t, 5000, 1), false)
+    ASSERT_EQUAL(le_vec_transient_pop_back(t), true)
+    ASSERT_EQUAL(le_vec_transient_get_length(t), 4999)
+    ASSERT_EQUAL(le_vec_transient_get_at(t, 4997), 4997)
+    ASSERT_EQUAL(le_vec_transient_get_at(t, 4991), -1)
+    ASSERT(persistent_equals(built, expected, 5000), "version changed by transient")
+
+    struct le_vec_persistent *edited = le_vec_transient_persistent(t);
+    ASSERT_EQUAL(le_vec_persistent_get_at(edited, 0), -1)
+    ASSERT_EQUAL(le_vec_persistent_get_at(edited, 1), 1)
+
+    t = le_vec_persistent_transient(edited);
+    while (le_vec_transient_pop_back(t)) {
+    }
+    ASSERT_EQUAL(le_vec_transient_get_length(t), 0)
+    le_vec_transient_destroy(t);
+    ASSERT_EQUAL(le_vec_persistent_get_length(edited), 4999)
+
+    le_vec_persistent_destroy(edited);
+    le_vec_persistent_destroy(built);
+    le_vec_persistent_destroy(p);
+}
+
+// Checks that jagged array row has elements first, first + step, ...
+bool jagged_row_is(struct le_vec_jagged *j, size_t row, int first, int step, size_t length) {
+    struct le_vec const *v = le_vec_jagged_row(j, row);
+    bool same = v != NULL && le_vec_get_length(v) == length && le_vec_jagged_get_row_length(j, row) == length;
+    for (size_t i = 0; same && i < length; i++) {
+        int expected = first + step * (int)i;
+        same = le_vec_get_at(v, i) == expected && le_vec_jagged_get_at(j, row, i) == expected;
+    }
+
+    return same;
+}
+
+void test_jagged_build(void) {
+    struct le_vec_jagged *j = le_vec_jagged_init();
+    ASSERT_EQUAL(le_vec_jagged_get_rows_length(j), 0)
+    ASSERT_EQUAL(le_vec_jagged_pop_row(j), false)
+    ASSERT(le_vec_jagged_row(j, 0) == NULL, "row view of missing row")
+
+    // Row i holds i, i + 1, ..., 2i - 1
+    bool all_match = true;
+    for (int row = 0; row < 1000; row++) {
+        le_vec_jagged_push_row(j, NULL, 0);
+        for (int i = 0; i < row; i++) {
+            le_vec_jagged_push_back(j, row + i);
+        }
+    }
+    for (size_t row = 0; row < 1000; row++) {
+        all_match = all_match && jagged_row_is(j, row, (int)row, 1, row);
+    }
+    ASSERT(all_match, "built rows differ")
+    ASSERT_EQUAL(le_vec_jagged_get_rows_length(j), 1000)
+    ASSERT_EQUAL(le_vec_jagged_get_values_length(j), 999 * 1000 / 2)
+
+    // Rows are laid out one after another
+    struct le_vec const *values = le_vec_jagged_values(j);
+    ASSERT_EQUAL(le_vec_get_length(values), 999 * 1000 / 2)
+    ASSERT_EQUAL(le_vec_get_at(values, 0), 1)
+    ASSERT_EQUAL(le_vec_get_at(values, 1), 2)
+    ASSERT_EQUAL(le_vec_get_at(values, 2), 3)
+    ASSERT_EQUAL(le_vec_get_at(values, 3), 3)
+
+    int row[] = {7, 8, 9};
+    le_vec_jagged_push_row(j, row, 3);
+    ASSERT(jagged_row_is(j, 1000, 7, 1, 3), "pushed row differs")
+    ASSERT_EQUAL(le_vec_find(le_vec_jagged_row(j, 1000), 9), 2)
+    ASSERT_EQUAL(le_vec_jagged_pop_row(j), true)
+    ASSERT_EQUAL(le_vec_jagged_pop_row(j), true)
+    ASSERT_EQUAL(le_vec_jagged_get_rows_length(j), 999)
+    ASSERT_EQUAL(le_vec_jagged_get_values_length(j), 998 * 999 / 2)
+
+    le_vec_jagged_destroy(j);
+}
+
+void test_jagged_edit_compact(void) {
+    struct le_vec_jagged *j = le_vec_jagged_init();
+    for (int row = 0; row < 100; row++) {
+        for (int i = 0; i < 5; i++) {
+            le_vec_jagged_push_back(j, row * 10 + i);
+        }
+        le_vec_jagged_push_row(j, NULL, 0);
+    }
+    le_vec_jagged_pop_row(j);
+    ASSERT_EQUAL(le_vec_jagged_get_rows_length(j), 100)
+
+    ASSERT_EQUAL(le_vec_jagged_set_at(j, 3, 4, -1), true)
+    ASSERT_EQUAL(le_vec_jagged_get_at(j, 3, 4), -1)
+    ASSERT_EQUAL(le_vec_jagged_set_at(j, 3, 5, -1), false)
+    ASSERT_EQUAL(le_vec_jagged_set_at(j, 100, 0, -1), false)
+    le_vec_jagged_set_at(j, 3, 4, 34);
+
+    // Rows growing in the middle move to the end, often enough to trigger compaction by themselves
+    bool all_match = true;
+    for (int round = 0; round < 20; round++) {
+        for (size_t row = 0; row < 100; row += 2) {
+            le_vec_jagged_row_push_back(j, row, (int)row * 10 + 5 + round);
+        }
+        for (size_t row = 0; row < 100; row++) {
+            all_match = all_match && jagged_row_is(j, row, (int)row * 10, 1, row % 2 == 0 ? 6 + (size_t)round : 5);
+        }
+    }
+    ASSERT(all_match, "rows differ after growing")
+    ASSERT_EQUAL(le_vec_jagged_row_push_back(j, 100, 0), false)
+
+    // Shorter rows are rewritten in place, longer ones move
+    int shorter[] = {-1, -2};
+    int longer[] = {5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30};
+    ASSERT_EQUAL(le_vec_jagged_set_row(j, 1, shorter, 2), true)
+    ASSERT_EQUAL(le_vec_jagged_set_row(j, 2, longer, 26), true)
+    ASSERT_EQUAL(le_vec_jagged_set_row(j, 5, NULL, 0), true)
+    ASSERT_EQUAL(le_vec_jagged_set_row(j, 100, NULL, 0), false)
+    ASSERT(jagged_row_is(j, 1, -1, -1, 2), "shortened row differs")
+    ASSERT(jagged_row_is(j, 2, 5, 1, 26), "lengthened row differs")
+    ASSERT(jagged_row_is(j, 5, 0, 0, 0), "emptied row differs")
+
+    // Values come out in row order after compaction
+    size_t expected_length = 50 * 25 + 50 * 5 - 3 + 1 - 5;
+    ASSERT_EQUAL(le_vec_jagged_get_values_length(j), expected_length)
+    struct le_vec const *values = le_vec_jagged_values(j);
+    ASSERT_EQUAL(le_vec_get_length(values), expected_length)
+    ASSERT_EQUAL(le_vec_get_at(values, 25), -1)
+    ASSERT_EQUAL(le_vec_get_at(values, 27), 5)
+    ASSERT_EQUAL(le_vec_get_at(values, 27 + 25), 30)
+
+    le_vec_jagged_compact(j);
+    all_match = jagged_row_is(j, 0, 0, 1, 25) && jagged_row_is(j, 2, 5, 1, 26) && jagged_row_is(j, 99, 990, 1, 5);
+    ASSERT(all_match, "rows differ after compaction")
+
+    le_vec_jagged_destroy(j);
+}
+
+void test_jagged_from_vecs(void) {
+    struct le_vec *vecs[4];
+    for (int i = 0; i < 4; i++) {
+        vecs[i] = le_vec_init();
+        for (int k = 0; k < i * 3; k++) {
+            le_vec_push_back(vecs[i], i * 100 + k);
+        }
+    }
+
+    struct le_vec_jagged *j = le_vec_jagged_init_from_vecs((struct le_vec const *const *)vecs, 4);
+    ASSERT_EQUAL(le_vec_jagged_get_rows_length(j), 4)
+    ASSERT_EQUAL(le_vec_jagged_get_values_length(j), 18)
+    bool all_match = true;
+    for (size_t i = 0; i < 4; i++) {
+        all_match = all_match && le_vec_equal(le_vec_jagged_row(j, i), vecs[i]);
+    }
+    ASSERT(all_match, "rows differ from source vectors")
+
+    // Building continues after conversion
+    le_vec_jagged_push_back(j, 310);
+    ASSERT_EQUAL(le_vec_jagged_get_row_length(j, 3), 10)
+    ASSERT_EQUAL(le_vec_jagged_get_at(j, 3, 9), 310)
+
+    le_vec_jagged_destroy(j);
+    struct le_vec_jagged *empty = le_vec_jagged_init_from_vecs(NULL, 0);
+    ASSERT_EQUAL(le_vec_jagged_get_rows_length(empty), 0)
+    ASSERT_EQUAL(le_vec_get_length(le_vec_jagged_values(empty)), 0)
+    le_vec_jagged_destroy(empty);
+
+    for (int i = 0; i < 4; i++) {
+        le_vec_destroy(vecs[i]);
+    }
+}
+
+// Checks that ranges taken from v are exactly the expected [start; end) pairs
+bool take_ranges_equal(struct le_vec *v, size_t const *expected, size_t expected_length) {
+    struct le_vec_range *ranges;
+    size_t length = le_vec_take_dirty_ranges(v, &ranges);
+
+    bool equal = length == expected_length;
+    for (size_t i = 0; equal && i < length; i++) {
+        equal = ranges[i].start == expected[2 * i] && ranges[i].end == expected[2 * i + 1];
+    }
+
+    free(ranges);
+    return equal;
+}
+
+void test_track_changes(void) {
+    struct le_vec *v = le_vec_init();
+    struct le_vec_range *ranges;
+
+    ASSERT_EQUAL(le_vec_is_tracking_changes(v), false)
+    le_vec_push_back(v, 1);
+    ASSERT_EQUAL(le_vec_take_dirty_ranges(v, &ranges), 0)
+    ASSERT_EQUAL(ranges, NULL)
+
+    le_vec_track_changes(v, true);
+    ASSERT_EQUAL(le_vec_is_tracking_changes(v), true)
+    for (int i = 1; i < 200; i++) {
+        le_vec_push_back(v, i);
+    }
+    size_t pushed[] = {0, 200};
+    ASSERT(take_ranges_equal(v, pushed, 1), "pushed elements are not reported")
+    ASSERT(take_ranges_equal(v, NULL, 0), "taken ranges are not forgotten")
+
+    // Whole blocks of LE_VEC_DIRTY_BLOCK elements are reported
+    le_vec_set_at(v, 130, 0);
+    le_vec_set_at(v, 5, 0);
+    le_vec_set_at(v, 190, 0);
+    le_vec_replace_all(v, 150, 0);
+    size_t set[] = {0, 64, 128, 192};
+    ASSERT(take_ranges_equal(v, set, 2), "set elements are not reported")
+
+    // Neighbouring blocks are merged, ranges are cut to length
+    le_vec_set_at(v, 100, 0);
+    le_vec_set_at(v, 140, 0);
+    le_vec_resize(v, 150);
+    size_t merged[] = {64, 150};
+    ASSERT(take_ranges_equal(v, merged, 1), "ranges are not merged or cut")
+
+    // Moved elements are reported too
+    le_vec_erase_range(v, 10, 20);
+    size_t erased[] = {0, 140};
+    ASSERT(take_ranges_equal(v, erased, 1), "moved elements are not reported")
+
+    le_vec_sort(v);
+    le_vec_add_scalar(v, 1);
+    ASSERT(take_ranges_equal(v, erased, 1), "sorted elements are not reported")
+
+    le_vec_set_at(v, 1, 0);
+    le_vec_track_changes(v, false);
+    ASSERT_EQUAL(le_vec_take_dirty_ranges(v, &ranges), 0)
+
+    le_vec_destroy(v);
+}
+
+void test_track_changes_sparse(void) {
+    size_t length = 1000 * 1000;
+    struct le_vec *v = le_vec_init_with_length(length);
+    struct le_vec *indexes = le_vec_init();
+    struct le_vec *values = le_vec_init();
+    le_vec_push_back(indexes, 999999);
+    le_vec_push_back(values, 1);
+    le_vec_push_back(indexes, 4096);
+    le_vec_push_back(values, 2);
+
+    le_vec_track_changes(v, true);
+    le_vec_set_at(v, 500000, 3);
+    le_vec_scatter(v, indexes, values);
+    le_vec_push_back(v, 4);
+
+    size_t expected[] = {4096, 4160, 499968, 500032, 999936, 1000001};
+    ASSERT(take_ranges_equal(v, expected, 3), "sparse changes are not reported")
+
+    le_vec_destroy(values);
+    le_vec_destroy(indexes);
+    le_vec_destroy(v);
+}
+
+void test_stats(void) {
+    struct le_vec *v = le_vec_init();
+    for (int i = 0; i < 100; i++) {
+        le_vec_push_back(v, i);
+    }
+
+    struct le_vec_stats stats;
+    if (!le_vec_stats_get(v, &stats)) {
+        // Built without LE_VEC_STATS
+        ASSERT_EQUAL(stats.allocs, 0)
+        ASSERT_EQUAL(stats.calls[LE_VEC_OP_PUSH_BACK], 0)
+        le_vec_destroy(v);
+        return;
+    }
+
+    ASSERT_EQUAL(stats.allocs, 1)
+    ASSERT_EQUAL(stats.reallocs, 2)
+    ASSERT_EQUAL(stats.calls[LE_VEC_OP_PUSH_BACK], 100)
+    ASSERT_EQUAL(stats.capacity_bytes, 128 * sizeof(int))
+    ASSERT_EQUAL(stats.slack_bytes, 28 * sizeof(int))
+
+    le_vec_resize(v, 10);
+    le_vec_stats_get(v, &stats);
+    ASSERT_EQUAL(stats.reallocs, 3)
+    ASSERT_EQUAL(stats.capacity_bytes, 10 * sizeof(int))
+    ASSERT_EQUAL(stats.peak_capacity_bytes, 128 * sizeof(int))
+    ASSERT_EQUAL(stats.calls[LE_VEC_OP_RESIZE], 1)
+
+    le_vec_insert_at(v, 0, 7);
+    le_vec_erase_range(v, 0, 2);
+    le_vec_remove_value(v, 7);
+    le_vec_stats_get(v, &stats);
+    ASSERT_EQUAL(stats.calls[LE_VEC_OP_INSERT], 1)
+    ASSERT_EQUAL(stats.calls[LE_VEC_OP_ERASE], 1)
+    ASSERT_EQUAL(stats.calls[LE_VEC_OP_REMOVE], 1)
+
+    struct le_vec_stats global;
+    ASSERT_EQUAL(le_vec_stats_get(NULL, &global), true)
+    ASSERT_BGE(global.calls[LE_VEC_OP_INIT], 1)
+    ASSERT_BGE(global.calls[LE_VEC_OP_PUSH_BACK], 100)
+    ASSERT_BGE(global.capacity_bytes, 10 * sizeof(int))
+
+    le_vec_destroy(v);
+}
+
+void test_insert_at(void) {
+    struct le_vec *v = le_vec_init();
+    le_vec_push_back(v, 1);
+    le_vec_push_back(v, 3);
+
+    ASSERT_EQUAL(le_vec_insert_at(v, 1, 2), true)
+    ASSERT_EQUAL(le_vec_insert_at(v, 0, 0), true)
+    ASSERT_EQUAL(le_vec_insert_at(v, 4, 4), true)
+    ASSERT_EQUAL(le_vec_insert_at(v, 6, 6), false)
+
+    ASSERT_EQUAL(le_vec_get_length(v), 5)
+    for (size_t i = 0; i < 5; i++) {
+        ASSERT_EQUAL(le_vec_get_at(v, i), (int)i)
+    }
+
+    le_vec_destroy(v);
+}
+
+void test_insert_n_at(void) {
+    struct le_vec *v = le_vec_init();
+    le_vec_push_back(v, 1);
+    le_vec_push_back(v, 2);
+
+    ASSERT_EQUAL(le_vec_insert_n_at(v, 1, 7, 40), true)
+    ASSERT_EQUAL(le_vec_get_length(v), 42)
+    ASSERT_EQUAL(le_vec_get_at(v, 0), 1)
+    ASSERT_EQUAL(le_vec_get_at(v, 1), 7)
+    ASSERT_EQUAL(le_vec_get_at(v, 40), 7)
+    ASSERT_EQUAL(le_vec_get_at(v, 41), 2)
+    ASSERT_EQUAL(le_vec_count(v, 7), 40)
+
+    le_vec_destroy(v);
+}
+
+void test_erase_range(void) {
+    struct le_vec *v = le_vec_init();
+    for (int i = 0; i < 10; i++) {
+        le_vec_push_back(v, i);
+    }
+
+    ASSERT_EQUAL(le_vec_erase_range(v, 2, 5), true)
+    ASSERT_EQUAL(le_vec_get_length(v), 7)
+    ASSERT_EQUAL(le_vec_get_at(v, 1), 1)
+    ASSERT_EQUAL(le_vec_get_at(v, 2), 5)
+    ASSERT_EQUAL(le_vec_get_at(v, 6), 9)
+
+    ASSERT_EQUAL(le_vec_erase_range(v, 3, 3), true)
+    ASSERT_EQUAL(le_vec_get_length(v), 7)
+    ASSERT_EQUAL(le_vec_erase_range(v, 4, 3), false)
+    ASSERT_EQUAL(le_vec_erase_range(v, 5, 8), false)
+
+    ASSERT_EQUAL(le_vec_erase_range(v, 5, 7), true)
+    ASSERT_EQUAL(le_vec_get_length(v), 5)
+    ASSERT_EQUAL(le_vec_get_at(v, 4), 7)
+
+    le_vec_destroy(v);
+}
+
+void test_remove_value(void) {
+    struct le_vec *v = le_vec_init();
+    for (int i = 0; i < 1000; i++) {
+        le_vec_push_back(v, i % 3 == 0 || i % 7 == 0 ? -1 : i);
+    }
+    size_t expected_removed = le_vec_count(v, -1);
+
+    ASSERT_EQUAL(le_vec_remove_value(v, -1), expected_removed)
+    ASSERT_EQUAL(le_vec_get_length(v), 1000 - expected_removed)
+    ASSERT_EQUAL(le_vec_count(v, -1), 0)
+
+    bool in_order = true;
+    int expected = 0;
+    for (size_t i = 0; i < le_vec_get_length(v); i++) {
+        do {
+            expected++;
+        } while (expected % 3 == 0 || expected % 7 == 0);
+        in_order = in_order && le_vec_get_at(v, i) == expected;
+    }
+    ASSERT(in_order, "kept elements are out of order")
+
+    ASSERT_EQUAL(le_vec_remove_value(v, 12345), 0)
+
+    le_vec_destroy(v);
+}
+
+bool is_odd(int n) {
+    return n % 2 != 0;
+}
+
+void test_remove_if(void) {
+    struct le_vec *v = le_vec_init();
+    for (int i = 0; i < 21; i++) {
+        le_vec_push_back(v, i);
+    }
+
+    ASSERT_EQUAL(le_vec_remove_if(v, is_odd), 10)
+    ASSERT_EQUAL(le_vec_get_length(v), 11)
+    ASSERT_EQUAL(le_vec_get_at(v, 0), 0)
+    ASSERT_EQUAL(le_vec_get_at(v, 1), 2)
+    ASSERT_EQUAL(le_vec_get_at(v, 10), 20)
+
+    le_vec_destroy(v);
+}
+
+void test_find_all(void) {
+    struct le_vec *v = le_vec_init();
+    struct le_vec *out = le_vec_init();
+    // Odd lengths leave tails after full vector registers, long ones span several blocks
+    size_t lengths[] = {0, 1, 7, 17, 100, 4099, 20000};
+
+    for (size_t l = 0; l < sizeof(lengths) / sizeof(lengths[0]); l++) {
+        le_vec_resize(v, 0);
+        for (size_t i = 0; i < lengths[l]; i++) {
+            le_vec_push_back(v, i % 3 == 0 || i % 7 == 0 ? -1 : (int)i);
+        }
+
+        size_t found = le_vec_find_all(v, -1, out);
+        ASSERT_EQUAL(found, le_vec_count(v, -1))
+        ASSERT_EQUAL(le_vec_get_length(out), found)
+
+        bool all_match = true;
+        for (size_t i = 0; i < found; i++) {
+            size_t index = (size_t)le_vec_get_at(out, i);
+            all_match = all_match && le_vec_get_at(v, index) == -1 && (i == 0 || index > (size_t)le_vec_get_at(out, i - 1));
+        }
+        ASSERT(all_match, "found indexes are wrong or out of order")
+    }
+
+    // Every element matches
+    le_vec_resize(v, 0);
+    for (int i = 0; i < 50; i++) {
+        le_vec_push_back(v, 5);
+    }
+    ASSERT_EQUAL(le_vec_find_all(v, 5, out), 50)
+    ASSERT_EQUAL(le_vec_get_at(out, 49), 49)
+
+    // Contents of out are replaced
+    ASSERT_EQUAL(le_vec_find_all(v, 6, out), 0)
+    ASSERT_EQUAL(le_vec_get_length(out), 0)
+
+    le_vec_destroy(v);
+    le_vec_destroy(out);
+}
+
+void test_find_all_if(void) {
+    struct le_vec *v = le_vec_init();
+    struct le_vec *out = le_vec_init();
+    for (int i = 0; i < 5000; i++) {
+        le_vec_push_back(v, i * 3);
+    }
+
+    ASSERT_EQUAL(le_vec_find_all_if(v, is_odd, out), 2500)
+    ASSERT_EQUAL(le_vec_get_at(out, 0), 1)
+    ASSERT_EQUAL(le_vec_get_at(out, 1), 3)
+    ASSERT_EQUAL(le_vec_get_at(out, 2499), 4999)
+
+    le_vec_resize(v, 0);
+    ASSERT_EQUAL(le_vec_find_all_if(v, is_odd, out), 0)
+    ASSERT_EQUAL(le_vec_get_length(out), 0)
+
+    le_vec_destroy(v);
+    le_vec_destroy(out);
+}
+
+void test_equal(void) {
+    struct le_vec *a = le_vec_init();
+    struct le_vec *b = le_vec_init();
+    ASSERT_EQUAL(le_vec_equal(a, b), true)
+
+    for (int i = 0; i < 300; i++) {
+        le_vec_push_back(a, i);
+        le_vec_push_back(b, i);
+    }
+    ASSERT_EQUAL(le_vec_equal(a, b), true)
+
+    le_vec_set_at(b, 299, -1);
+    ASSERT_EQUAL(le_vec_equal(a, b), false)
+    le_vec_pop_back(a);
+    le_vec_pop_back(b);
+    ASSERT_EQUAL(le_vec_equal(a, b), true)
+    le_vec_pop_back(b);
+    ASSERT_EQUAL(le_vec_equal(a, b), false)
+
+    le_vec_destroy(a);
+    le_vec_destroy(b);
+}
+
+void test_compare(void) {
+    struct le_vec *a = le_vec_init();
+    struct le_vec *b = le_vec_init();
+    ASSERT_EQUAL(le_vec_compare(a, b), 0)
+
+    for (int i = 0; i < 200; i++) {
+        le_vec_push_back(a, i);
+        le_vec_push_back(b, i);
+    }
+    ASSERT_EQUAL(le_vec_compare(a, b), 0)
+
+    // Difference past several whole blocks, negative values order before positive ones
+    le_vec_set_at(b, 150, -150);
+    ASSERT_EQUAL(le_vec_compare(a, b), 1)
+    ASSERT_EQUAL(le_vec_compare(b, a), -1)
+
+    // Earlier difference decides, regardless of later ones
+    le_vec_set_at(a, 3, -5);
+    ASSERT_EQUAL(le_vec_compare(a, b), -1)
+
+    // Prefix is less than its extensions
+    le_vec_set_at(a, 3, 3);
+    le_vec_set_at(b, 150, 150);
+    le_vec_push_back(b, -7);
+    ASSERT_EQUAL(le_vec_compare(a, b), -1)
+    ASSERT_EQUAL(le_vec_compare(b, a), 1)
+
+    le_vec_destroy(a);
+    le_vec_destroy(b);
+}
+
+void test_hash(void) {
+    struct le_vec *a = le_vec_init();
+    struct le_vec *b = le_vec_init();
+    // Reference digests come from the xxHash implementation of XXH64, seed 0, little-endian ints.
+    // No bytes
+    ASSERT_EQUAL(le_vec_hash(a), 0xEF46DB3751D8E999ull)
+
+    // 20 bytes, shorter than a stripe: two 8-byte rounds and a 4-byte tail
+    for (int i = 1; i <= 5; i++) {
+        le_vec_push_back(a, i);
+    }
+    ASSERT_EQUAL(le_vec_hash(a), 0x1EE2A9EC71A1A54Aull)
+
+    // 44 bytes: a stripe, an 8-byte round and a 4-byte tail
+    le_vec_resize(a, 0);
+    for (int i = 0; i < 11; i++) {
+        le_vec_push_back(a, i * -7919);
+    }
+    ASSERT_EQUAL(le_vec_hash(a), 0x284860B86A4AC98Eull)
+
+    // 45 bytes add a 1-byte tail, 3 bytes are a 1-byte tail only
+    unsigned char bytes[45];
+    for (int i = 0; i < 45; i++) {
+        bytes[i] = (unsigned char)i;
+    }
+    ASSERT_EQUAL(le_vec_hash_bytes(bytes, 45), 0x10FDD84D6409ABDFull)
+    ASSERT_EQUAL(le_vec_hash_bytes("abc", 3), 0x44BC2CF5AD770999ull)
+
+    le_vec_resize(a, 0);
+    for (int i = 0; i < 1000; i++) {
+        le_vec_push_back(a, i * 7);
+        le_vec_push_back(b, i * 7);
+    }
+    // 4000 bytes, whole stripes only
+    ASSERT_EQUAL(le_vec_hash(a), 0x924DC0784343500Eull)
+    ASSERT_EQUAL(le_vec_hash(a), le_vec_hash(b))
+
+    le_vec_set_at(b, 500, 0);
+    ASSERT(le_vec_hash(a) != le_vec_hash(b), "different vectors have equal hashes")
+    le_vec_pop_back(a);
+    ASSERT(le_vec_hash(a) != le_vec_hash(b), "vector and its prefix have equal hashes")
+
+    le_vec_destroy(a);
+    le_vec_destroy(b);
+}
+
+void test_hash_incremental(void) {
+    struct le_vec *v = le_vec_init();
+    struct le_vec_hash_state *h = le_vec_hash_init();
+    ASSERT_EQUAL(le_vec_hash_digest(h), le_vec_hash(v))
+
+    // Appends of assorted sizes, so that updates start and end inside stripes
+    bool all_match = true;
+    int value = 0;
+    for (int step = 1; step < 40; step++) {
+        for (int i = 0; i < step; i++) {
+            le_vec_push_back(v, value++);
+        }
+        ASSERT_EQUAL(le_vec_hash_update(h, v), true)
+        all_match = all_match && le_vec_hash_digest(h) == le_vec_hash(v);
+    }
+    ASSERT(all_match, "incremental hash differs from hash of whole vector")
+
+    ASSERT_EQUAL(le_vec_hash_update(h, v), true)
+    ASSERT_EQUAL(le_vec_hash_digest(h), le_vec_hash(v))
+
+    uint64_t before = le_vec_hash_digest(h);
+    le_vec_pop_back(v);
+    ASSERT_EQUAL(le_vec_hash_update(h, v), false)
+    ASSERT_EQUAL(le_vec_hash_digest(h), before)
+
+    le_vec_hash_destroy(h);
+    le_vec_destroy(v);
+}
+
+// Returns vector of `length` pseudo-random values from [0; range)
+struct le_vec *random_vec(size_t length, unsigned range, unsigned seed) {
+    struct le_vec *v = le_vec_init();
+    for (size_t i = 0; i < length; i++) {
+        seed = seed * 1103515245u + 12345u;
+        le_vec_push_back(v, (int)((seed >> 8) % range));
+    }
+
+    return v;
+}
+
+// Returns sorted vector of values from [0; limit) divisible by step
+struct le_vec *multiples_vec(int step, int limit) {
+    struct le_vec *v = le_vec_init();
+    for (int i = 0; i < limit; i += step) {
+        le_vec_push_back(v, i);
+    }
+
+    return v;
+}
+
+void test_sort(void) {
+    struct le_vec *v = random_vec(5000, 100, 1);
+    size_t count_of_7 = le_vec_count(v, 7);
+
+    le_vec_sort(v);
+
+    ASSERT(le_vec_is_sorted(v), "vector is not sorted")
+    ASSERT_EQUAL(le_vec_get_length(v), 5000)
+    ASSERT_EQUAL(le_vec_count(v, 7), count_of_7)
+
+    le_vec_reverse(v);
+    ASSERT_EQUAL(le_vec_is_sorted(v), false)
+    le_vec_sort(v);
+    ASSERT(le_vec_is_sorted(v), "reversed vector is not sorted")
+
+    le_vec_destroy(v);
+
+    struct le_vec *empty = le_vec_init();
+    le_vec_sort(empty);
+    ASSERT(le_vec_is_sorted(empty), "empty vector is not sorted")
+    le_vec_destroy(empty);
+}
+
+void test_unique(void) {
+    struct le_vec *v = random_vec(1000, 50, 2);
+
+    le_vec_sort(v);
+    ASSERT_EQUAL(le_vec_unique(v), 950)
+    ASSERT_EQUAL(le_vec_get_length(v), 50)
+    for (size_t i = 0; i < 50; i++) {
+        ASSERT_EQUAL(le_vec_get_at(v, i), (int)i)
+    }
+    ASSERT_EQUAL(le_vec_unique(v), 0)
+
+    le_vec_destroy(v);
+}
+
+void test_lower_bound(void) {
+    struct le_vec *v = multiples_vec(2, 100);
+
+    ASSERT_EQUAL(le_vec_lower_bound(v, -5), 0)
+    ASSERT_EQUAL(le_vec_lower_bound(v, 10), 5)
+    ASSERT_EQUAL(le_vec_lower_bound(v, 11), 6)
+    ASSERT_EQUAL(le_vec_lower_bound(v, 1000), 50)
+
+    le_vec_destroy(v);
+}
+
+// Checks that v is a permutation of sorted with sorted[n] at n and nothing out of place around it
+bool is_selected(struct le_vec const *v, struct le_vec const *sorted, size_t n) {
+    struct le_vec *copy = le_vec_copy(v);
+    le_vec_sort(copy);
+    bool ok = le_vec_get_length(copy) == le_vec_get_length(sorted);
+    for (size_t i = 0; ok && i < le_vec_get_length(copy); i++) {
+        ok = le_vec_get_at(copy, i) == le_vec_get_at(sorted, i);
+    }
+    le_vec_destroy(copy);
+
+    int nth = le_vec_get_at(sorted, n);
+    ok = ok && le_vec_get_at(v, n) == nth;
+    for (size_t i = 0; ok && i < le_vec_get_length(v); i++) {
+        ok = i < n ? le_vec_get_at(v, i) <= nth : le_vec_get_at(v, i) >= nth;
+    }
+    return ok;
+}
+
+// Checks that out holds the k largest elements of sorted in descending order
+bool is_top_k(struct le_vec const *out, struct le_vec const *sorted, size_t k) {
+    size_t length = le_vec_get_length(sorted);
+    bool ok = le_vec_get_length(out) == k;
+    for (size_t i = 0; ok && i < k; i++) {
+        ok = le_vec_get_at(out, i) == le_vec_get_at(sorted, length - 1 - i);
+    }
+    return ok;
+}
+
+void test_nth_element(void) {
+    struct le_vec *v = random_vec(5000, 100, 11);
+    struct le_vec *sorted = le_vec_copy(v);
+    le_vec_sort(sorted);
+
+    size_t positions[] = {0, 1, 2500, 4998, 4999};
+    for (size_t i = 0; i < sizeof(positions) / sizeof(positions[0]); i++) {
+        le_vec_nth_element(v, positions[i]);
+        ASSERT(is_selected(v, sorted, positions[i]), "element is not selected")
+    }
+    ASSERT_EQUAL(le_vec_nth_element(v, 5000), false)
+
+    // Distinct values, where partitions don't get help from duplicates
+    struct le_vec *distinct = random_vec(5000, 1000000, 12);
+    le_vec_destroy(sorted);
+    sorted = le_vec_copy(distinct);
+    le_vec_sort(sorted);
+    ASSERT_EQUAL(le_vec_nth_element(distinct, 1234), true)
+    ASSERT(is_selected(distinct, sorted, 1234), "element is not selected")
+
+    le_vec_destroy(distinct);
+    le_vec_destroy(sorted);
+    le_vec_destroy(v);
+}
+
+void test_partial_sort(void) {
+    struct le_vec *v = random_vec(3000, 1000, 13);
+    struct le_vec *sorted = le_vec_copy(v);
+    le_vec_sort(sorted);
+
+    size_t ks[] = {0, 1, 17, 2999, 3000, 5000};
+    for (size_t i = 0; i < sizeof(ks) / sizeof(ks[0]); i++) {
+        le_vec_partial_sort(v, ks[i]);
+
+        bool ok = true;
+        for (size_t j = 0; j < ks[i] && j < 3000; j++) {
+            ok = ok && le_vec_get_at(v, j) == le_vec_get_at(sorted, j);
+        }
+        ASSERT(ok, "prefix is not sorted")
+        if (ks[i] > 0 && ks[i] < 3000) {
+            ASSERT(is_selected(v, sorted, ks[i] - 1), "prefix is not the smallest elements")
+        }
+    }
+
+    le_vec_destroy(sorted);
+    le_vec_destroy(v);
+}
+
+void test_top_k(void) {
+    struct le_vec *v = random_vec(10000, 100000, 14);
+    struct le_vec *before = le_vec_copy(v);
+    struct le_vec *sorted = le_vec_copy(v);
+    le_vec_sort(sorted);
+    struct le_vec *out = le_vec_init();
+
+    // Small k goes through the heap, large through selection
+    size_t ks[] = {1, 10, 156, 157, 5000, 10000};
+    for (size_t i = 0; i < sizeof(ks) / sizeof(ks[0]); i++) {
+        ASSERT_EQUAL(le_vec_top_k(v, ks[i], out), ks[i])
+        ASSERT(is_top_k(out, sorted, ks[i]), "top elements differ")
+    }
+
+    ASSERT_EQUAL(le_vec_top_k(v, 0, out), 0)
+    ASSERT_EQUAL(le_vec_get_length(out), 0)
+    ASSERT_EQUAL(le_vec_top_k(v, 20000, out), 10000)
+    ASSERT(is_top_k(out, sorted, 10000), "top elements differ")
+
+    bool unchanged = true;
+    for (size_t i = 0; i < 10000; i++) {
+        unchanged = unchanged && le_vec_get_at(v, i) == le_vec_get_at(before, i);
+    }
+    ASSERT(unchanged, "input changed")
+
+    // Ascending input makes every element enter the heap
+    struct le_vec *ascending = multiples_vec(1, 10000);
+    ASSERT_EQUAL(le_vec_top_k(ascending, 100, out), 100)
+    ASSERT_EQUAL(le_vec_get_at(out, 0), 9999)
+    ASSERT_EQUAL(le_vec_get_at(out, 99), 9900)
+
+    le_vec_destroy(ascending);
+    le_vec_destroy(out);
+    le_vec_destroy(sorted);
+    le_vec_destroy(before);
+    le_vec_destroy(v);
+}
+
+void test_selection_parallel(void) {
+    le_vec_set_thread_count(4);
+
+    size_t length = 3 * 1000 * 1000 + 7;
+    struct le_vec *v = random_vec(length, 1000000, 15);
+    struct le_vec *sorted = le_vec_copy(v);
+    le_vec_sort(sorted);
+
+    le_vec_nth_element(v, length / 2);
+    ASSERT(is_selected(v, sorted, length / 2), "median is not selected")
+    le_vec_nth_element(v, 3);
+    ASSERT(is_selected(v, sorted, 3), "element is not selected")
+
+    struct le_vec *out = le_vec_init();
+    ASSERT_EQUAL(le_vec_top_k(v, 1000, out), 1000)
+    ASSERT(is_top_k(out, sorted, 1000), "top elements differ")
+    ASSERT_EQUAL(le_vec_top_k(v, length / 3, out), length / 3)
+    ASSERT(is_top_k(out, sorted, length / 3), "top elements differ")
+
+    // Few distinct values: the range shrinks to elements equal to the pivot
+    struct le_vec *repeated = random_vec(length, 3, 16);
+    le_vec_nth_element(repeated, length / 2);
+    le_vec_destroy(sorted);
+    sorted = le_vec_copy(repeated);
+    le_vec_sort(sorted);
+    ASSERT(is_selected(repeated, sorted, length / 2), "element is not selected")
+
+    le_vec_partial_sort(v, 100);
+    ASSERT(le_vec_get_at(v, 0) <= le_vec_get_at(v, 99) && le_vec_get_at(v, 99) <= le_vec_get_at(v, 100), "prefix is not sorted")
+
+    le_vec_destroy(repeated);
+    le_vec_destroy(out);
+    le_vec_destroy(sorted);
+    le_vec_destroy(v);
+    le_vec_set_thread_count(0);
+}
+
+void test_set_union(void) {
+    struct le_vec *a = multiples_vec(2, 1000);
+    struct le_vec *b = multiples_vec(3, 1000);
+    struct le_vec *out = le_vec_init();
+
+    // Multiples of 2 or 3 below 1000: 500 + 334 - 167
+    ASSERT_EQUAL(le_vec_set_union(a, b, out), 667)
+    ASSERT(le_vec_is_sorted(out), "union is not sorted")
+    ASSERT_EQUAL(le_vec_unique(out), 0)
+    ASSERT_EQUAL(le_vec_get_at(out, 3), 4)
+
+    // Galloping path
+    struct le_vec *few = le_vec_init();
+    le_vec_push_back(few, -1);
+    le_vec_push_back(few, 501);
+    le_vec_push_back(few, 502);
+    ASSERT_EQUAL(le_vec_set_union(few, a, out), 502)
+    ASSERT_EQUAL(le_vec_get_at(out, 0), -1)
+    ASSERT_EQUAL(le_vec_get_at(out, 252), 501)
+    ASSERT(le_vec_is_sorted(out), "galloping union is not sorted")
+    ASSERT_EQUAL(le_vec_set_union(a, few, out), 502)
+
+    le_vec_destroy(few);
+    le_vec_destroy(out);
+    le_vec_destroy(b);
+    le_vec_destroy(a);
+}
+
+void test_set_intersection(void) {
+    struct le_vec *a = multiples_vec(2, 10000);
+    struct le_vec *b = multiples_vec(3, 10000);
+    struct le_vec *out = le_vec_init();
+
+    ASSERT_EQUAL(le_vec_set_intersection(a, b, out), 1667)
+    bool all_multiples_of_6 = true;
+    for (size_t i = 0; i < le_vec_get_length(out); i++) {
+        all_multiples_of_6 = all_multiples_of_6 && le_vec_get_at(out, i) == (int)i * 6;
+    }
+    ASSERT(all_multiples_of_6, "intersection is wrong")
+
+    // Galloping path
+    struct le_vec *few = le_vec_init();
+    le_vec_push_back(few, 3);
+    le_vec_push_back(few, 4);
+    le_vec_push_back(few, 9998);
+    le_vec_push_back(few, 20000);
+    ASSERT_EQUAL(le_vec_set_intersection(few, a, out), 2)
+    ASSERT_EQUAL(le_vec_get_at(out, 0), 4)
+    ASSERT_EQUAL(le_vec_get_at(out, 1), 9998)
+    ASSERT_EQUAL(le_vec_set_intersection(a, few, out), 2)
+
+    struct le_vec *empty = le_vec_init();
+    ASSERT_EQUAL(le_vec_set_intersection(a, empty, out), 0)
+
+    le_vec_destroy(empty);
+    le_vec_destroy(few);
+    le_vec_destroy(out);
+    le_vec_destroy(b);
+    le_vec_destroy(a);
+}
+
+void test_set_difference(void) {
+    struct le_vec *a = multiples_vec(2, 1000);
+    struct le_vec *b = multiples_vec(3, 1000);
+    struct le_vec *out = le_vec_init();
+
+    ASSERT_EQUAL(le_vec_set_difference(a, b, out), 333)
+    ASSERT_EQUAL(le_vec_get_at(out, 0), 2)
+    ASSERT_EQUAL(le_vec_get_at(out, 1), 4)
+    ASSERT_EQUAL(le_vec_get_at(out, 2), 8)
+
+    // Galloping paths
+    struct le_vec *few = le_vec_init();
+    le_vec_push_back(few, 1);
+    le_vec_push_back(few, 2);
+    le_vec_push_back(few, 998);
+    ASSERT_EQUAL(le_vec_set_difference(a, few, out), 498)
+    ASSERT_EQUAL(le_vec_get_at(out, 0), 0)
+    ASSERT_EQUAL(le_vec_get_at(out, 1), 4)
+    ASSERT_EQUAL(le_vec_set_difference(few, a, out), 1)
+    ASSERT_EQUAL(le_vec_get_at(out, 0), 1)
+
+    le_vec_destroy(few);
+    le_vec_destroy(out);
+    le_vec_destroy(b);
+    le_vec_destroy(a);
+}
+
+int max_of(int a, int b) {
+    return a > b ? a : b;
+}
+
+void test_inclusive_scan(void) {
+    struct le_vec *v = le_vec_init();
+    for (int i = 1; i <= 20; i++) {
+        le_vec_push_back(v, i);
+    }
+
+    struct le_vec *scanned = le_vec_inclusive_scanned(v);
+    le_vec_inclusive_scan(v);
+
+    ASSERT_EQUAL(le_vec_get_length(v), 20)
+    ASSERT_EQUAL(le_vec_get_length(scanned), 20)
+    for (size_t i = 0; i < 20; i++) {
+        int expected = (int)((i + 1) * (i + 2) / 2);
+        ASSERT_EQUAL(le_vec_get_at(v, i), expected)
+        ASSERT_EQUAL(le_vec_get_at(scanned, i), expected)
+    }
+
+    le_vec_destroy(scanned);
+    le_vec_destroy(v);
+}
+
+void test_exclusive_scan(void) {
+    struct le_vec *v = le_vec_init();
+    for (int i = 1; i <= 20; i++) {
+        le_vec_push_back(v, i);
+    }
+
+    struct le_vec *scanned = le_vec_exclusive_scanned(v);
+    le_vec_exclusive_scan(v);
+
+    for (size_t i = 0; i < 20; i++) {
+        int expected = (int)(i * (i + 1) / 2);
+        ASSERT_EQUAL(le_vec_get_at(v, i), expected)
+        ASSERT_EQUAL(le_vec_get_at(scanned, i), expected)
+    }
+
+    le_vec_destroy(scanned);
+    le_vec_destroy(v);
+
+    struct le_vec *empty = le_vec_init();
+    le_vec_exclusive_scan(empty);
+    struct le_vec *empty_scanned = le_vec_exclusive_scanned(empty);
+    ASSERT_EQUAL(le_vec_get_length(empty_scanned), 0)
+    le_vec_destroy(empty_scanned);
+    le_vec_destroy(empty);
+}
+
+void test_scan(void) {
+    struct le_vec *v = le_vec_init();
+    int values[] = {3, 1, 4, 1, 5, 9, 2, 6, 5, 3};
+    int expected[] = {3, 3, 4, 4, 5, 9, 9, 9, 9, 9};
+    for (size_t i = 0; i < array_length(values); i++) {
+        le_vec_push_back(v, values[i]);
+    }
+
+    struct le_vec *scanned = le_vec_scanned(v, max_of);
+    le_vec_scan(v, max_of);
+
+    for (size_t i = 0; i < array_length(expected); i++) {
+        ASSERT_EQUAL(le_vec_get_at(v, i), expected[i])
+        ASSERT_EQUAL(le_vec_get_at(scanned, i), expected[i])
+    }
+
+    le_vec_destroy(scanned);
+    le_vec_destroy(v);
+}
+
+void test_scan_parallel(void) {
+    le_vec_set_thread_count(4);
+    ASSERT_EQUAL(le_vec_get_thread_count(), 4)
+
+    size_t length = 3 * 1000 * 1000 + 7;
+    struct le_vec *v = random_vec(length, 100, 3);
+
+    struct le_vec *inclusive = le_vec_inclusive_scanned(v);
+    struct le_vec *exclusive = le_vec_exclusive_scanned(v);
+    struct le_vec *maximums = le_vec_scanned(v, max_of);
+
+    bool inclusive_ok = true;
+    bool exclusive_ok = true;
+    bool maximums_ok = true;
+    int sum = 0;
+    int maximum = 0;
+    for (size_t i = 0; i < length; i++) {
+        int value = le_vec_get_at(v, i);
+        exclusive_ok = exclusive_ok && le_vec_get_at(exclusive, i) == sum;
+        sum += value;
+        maximum = max_of(maximum, value);
+        inclusive_ok = inclusive_ok && le_vec_get_at(inclusive, i) == sum;
+        maximums_ok = maximums_ok && le_vec_get_at(maximums, i) == maximum;
+    }
+    ASSERT(inclusive_ok, "parallel inclusive scan is wrong")
+    ASSERT(exclusive_ok, "parallel exclusive scan is wrong")
+    ASSERT(maximums_ok, "parallel scan with op is wrong")
+
+    le_vec_inclusive_scan(v);
+    ASSERT_EQUAL(le_vec_get_at(v, length - 1), sum)
+
+    le_vec_destroy(maximums);
+    le_vec_destroy(exclusive);
+    le_vec_destroy(inclusive);
+    le_vec_destroy(v);
+
+    le_vec_set_thread_count(0);
+}
+
+void test_thread_count_follows_affinity(void) {
+    cpu_set_t allowed;
+    ASSERT_EQUAL(sched_getaffinity(0, sizeof(allowed), &allowed), 0)
+    ASSERT_EQUAL(le_vec_get_thread_count(), (size_t)CPU_COUNT(&allowed))
+
+    cpu_set_t single;
+    CPU_ZERO(&single);
+    CPU_SET(sched_getcpu(), &single);
+    ASSERT_EQUAL(sched_setaffinity(0, sizeof(single), &single), 0)
+    ASSERT_EQUAL(le_vec_get_thread_count(), 1)
+
+    sched_setaffinity(0, sizeof(allowed), &allowed);
+}
+
+void test_gather(void) {
+    struct le_vec *src = multiples_vec(10, 1000);
+    struct le_vec *indexes = random_vec(1000, 100, 5);
+    struct le_vec *dst = le_vec_init();
+
+    ASSERT_EQUAL(le_vec_gather(dst, src, indexes), true)
+    ASSERT_EQUAL(le_vec_get_length(dst), 1000)
+    bool gather_ok = true;
+    for (size_t i = 0; i < 1000; i++) {
+        gather_ok = gather_ok && le_vec_get_at(dst, i) == le_vec_get_at(indexes, i) * 10;
+    }
+    ASSERT(gather_ok, "gather is wrong")
+
+    le_vec_push_back(indexes, 100);
+    ASSERT_EQUAL(le_vec_gather(dst, src, indexes), false)
+    le_vec_set_at(indexes, 1000, -1);
+    ASSERT_EQUAL(le_vec_gather(dst, src, indexes), false)
+    ASSERT_EQUAL(le_vec_get_length(dst), 1000)
+    ASSERT_EQUAL(le_vec_gather(indexes, src, indexes), false)
+
+    le_vec_destroy(dst);
+    le_vec_destroy(indexes);
+    le_vec_destroy(src);
+}
+
+void test_scatter(void) {
+    struct le_vec *dst = multiples_vec(1, 10);
+    struct le_vec *indexes = le_vec_init();
+    struct le_vec *src = le_vec_init();
+    le_vec_push_back(indexes, 9);
+    le_vec_push_back(src, -9);
+    le_vec_push_back(indexes, 0);
+    le_vec_push_back(src, -100);
+
+    ASSERT_EQUAL(le_vec_scatter(dst, indexes, src), true)
+    ASSERT_EQUAL(le_vec_get_at(dst, 9), -9)
+    ASSERT_EQUAL(le_vec_get_at(dst, 0), -100)
+    ASSERT_EQUAL(le_vec_get_at(dst, 5), 5)
+
+    le_vec_push_back(indexes, 10);
+    ASSERT_EQUAL(le_vec_scatter(dst, indexes, src), false)
+    le_vec_push_back(src, 1);
+    ASSERT_EQUAL(le_vec_scatter(dst, indexes, src), false)
+    ASSERT_EQUAL(le_vec_get_at(dst, 9), -9)
+
+    le_vec_destroy(src);
+    le_vec_destroy(indexes);
+    le_vec_destroy(dst);
+}
+
+void test_gather_scatter_parallel(void) {
+    le_vec_set_thread_count(4);
+
+    // Big enough to be prefetched and split between threads
+    size_t length = 2 * 1000 * 1000 + 3;
+    struct le_vec *src = random_vec(length, 1000, 7);
+    struct le_vec *indexes = random_vec(length, (unsigned)length, 8);
+    struct le_vec *dst = le_vec_init();
+
+    ASSERT_EQUAL(le_vec_gather(dst, src, indexes), true)
+    bool gather_ok = true;
+    for (size_t i = 0; i < length; i++) {
+        gather_ok = gather_ok && le_vec_get_at(dst, i) == le_vec_get_at(src, le_vec_get_at(indexes, i));
+    }
+    ASSERT(gather_ok, "parallel gather is wrong")
+
+    // A permutation, so that every index is written once
+    for (size_t i = 0; i < length; i++) {
+        le_vec_set_at(indexes, i, (int)((i * 7919) % length));
+    }
+    ASSERT_EQUAL(le_vec_scatter(dst, indexes, src), true)
+    bool scatter_ok = true;
+    for (size_t i = 0; i < length; i++) {
+        scatter_ok = scatter_ok && le_vec_get_at(dst, le_vec_get_at(indexes, i)) == le_vec_get_at(src, i);
+    }
+    ASSERT(scatter_ok, "parallel scatter is wrong")
+
+    le_vec_destroy(dst);
+    le_vec_destroy(indexes);
+    le_vec_destroy(src);
+
+    le_vec_set_thread_count(0);
+}
+
+// Returns random vector with values in [-range; range)
+struct le_vec *signed_random_vec(size_t length, unsigned range, unsigned seed) {
+    struct le_vec *v = random_vec(length, 2 * range, seed);
+    le_vec_subtract_scalar(v, (int)range);
+
+    return v;
+}
+
+void test_arithmetic(void) {
+    // Lengths around vector widths, so that both main loops and tails are covered
+    size_t lengths[] = {0, 1, 7, 8, 9, 15, 16, 17, 100};
+
+    for (size_t l = 0; l < array_length(lengths); l++) {
+        size_t length = lengths[l];
+        struct le_vec *a = signed_random_vec(length, 1000, 1);
+        struct le_vec *b = signed_random_vec(length, 1000, 2);
+
+        struct le_vec *sums = le_vec_added(a, b);
+        struct le_vec *differences = le_vec_subtracted(a, b);
+        struct le_vec *products = le_vec_multiplied(a, b);
+        struct le_vec *plus = le_vec_added_scalar(a, 5);
+        struct le_vec *minus = le_vec_subtracted_scalar(a, 5);
+        struct le_vec *times = le_vec_multiplied_scalar(a, -3);
+
+        bool ok = le_vec_get_length(sums) == length && le_vec_get_length(times) == length;
+        for (size_t i = 0; i < length; i++) {
+            int x = le_vec_get_at(a, i);
+            int y = le_vec_get_at(b, i);
+            ok = ok && le_vec_get_at(sums, i) == x + y;
+            ok = ok && le_vec_get_at(differences, i) == x - y;
+            ok = ok && le_vec_get_at(products, i) == x * y;
+            ok = ok && le_vec_get_at(plus, i) == x + 5;
+            ok = ok && le_vec_get_at(minus, i) == x - 5;
+            ok = ok && le_vec_get_at(times, i) == x * -3;
+        }
+        ASSERT(ok, "out-of-place arithmetic is wrong")
+
+        struct le_vec *c = le_vec_added_scalar(a, 0);
+        ASSERT_EQUAL(le_vec_add(c, b), true)
+        ASSERT_EQUAL(le_vec_multiply(c, b), true)
+        ASSERT_EQUAL(le_vec_subtract(c, a), true)
+        le_vec_multiply_scalar(c, 2);
+        le_vec_add_scalar(c, 1);
+        ASSERT_EQUAL(le_vec_axpy(c, 4, a), true)
+
+        ok = true;
+        for (size_t i = 0; i < length; i++) {
+            int x = le_vec_get_at(a, i);
+            int y = le_vec_get_at(b, i);
+            ok = ok && le_vec_get_at(c, i) == ((x + y) * y - x) * 2 + 1 + 4 * x;
+        }
+        ASSERT(ok, "in-place arithmetic is wrong")
+
+        le_vec_destroy(c);
+        le_vec_destroy(times);
+        le_vec_destroy(minus);
+        le_vec_destroy(plus);
+        le_vec_destroy(products);
+        le_vec_destroy(differences);
+        le_vec_destroy(sums);
+        le_vec_destroy(b);
+        le_vec_destroy(a);
+    }
+}
+
+void test_arithmetic_invalid(void) {
+    struct le_vec *a = multiples_vec(1, 10);
+    struct le_vec *b = multiples_vec(1, 11);
+
+    ASSERT_EQUAL(le_vec_add(a, b), false)
+    ASSERT_EQUAL(le_vec_subtract(a, b), false)
+    ASSERT_EQUAL(le_vec_multiply(a, b), false)
+    ASSERT_EQUAL(le_vec_axpy(a, 2, b), false)
+    ASSERT_EQUAL(le_vec_added(a, b), NULL)
+    ASSERT_EQUAL(le_vec_subtracted(a, b), NULL)
+    ASSERT_EQUAL(le_vec_multiplied(a, b), NULL)
+    ASSERT_EQUAL(le_vec_get_at(a, 9), 9)
+
+    // Wraps around
+    le_vec_set_at(a, 0, INT_MAX);
+    le_vec_add_scalar(a, 1);
+    ASSERT_EQUAL(le_vec_get_at(a, 0), INT_MIN)
+    ASSERT_EQUAL(le_vec_get_at(a, 9), 10)
+
+    le_vec_destroy(b);
+    le_vec_destroy(a);
+}
+
+void test_clamp_abs(void) {
+    struct le_vec *v = signed_random_vec(37, 100, 3);
+    le_vec_set_at(v, 36, INT_MIN);
+
+    struct le_vec *clamped = le_vec_clamped(v, -10, 20);
+    struct le_vec *absolute = le_vec_absolute(v);
+    ASSERT_EQUAL(le_vec_clamped(v, 1, 0), NULL)
+
+    bool ok = true;
+    for (size_t i = 0; i < 36; i++) {
+        int x = le_vec_get_at(v, i);
+        ok = ok && le_vec_get_at(clamped, i) == (x < -10 ? -10 : x > 20 ? 20 : x);
+        ok = ok && le_vec_get_at(absolute, i) == (x < 0 ? -x : x);
+    }
+    ASSERT(ok, "clamp or abs is wrong")
+    ASSERT_EQUAL(le_vec_get_at(clamped, 36), -10)
+    ASSERT_EQUAL(le_vec_get_at(absolute, 36), INT_MIN)
+
+    ASSERT_EQUAL(le_vec_clamp(v, 5, 4), false)
+    ASSERT_EQUAL(le_vec_clamp(v, 0, 0), true)
+    ASSERT_EQUAL(le_vec_count(v, 0), 37)
+
+    le_vec_set_at(v, 3, -7);
+    le_vec_abs(v);
+    ASSERT_EQUAL(le_vec_get_at(v, 3), 7)
+
+    le_vec_destroy(absolute);
+    le_vec_destroy(clamped);
+    le_vec_destroy(v);
+}
+
+void test_dot(void) {
+    bool success = false;
+    struct le_vec *a = signed_random_vec(101, 1000, 4);
+    struct le_vec *b = signed_random_vec(101, 1000, 5);
+
+    long long expected = 0;
+    for (size_t i = 0; i < 101; i++) {
+        expected += (long long)le_vec_get_at(a, i) * le_vec_get_at(b, i);
+    }
+    ASSERT_EQUAL(le_vec_dot(a, b, &success), expected)
+    ASSERT_EQUAL(success, true)
+
+    // Products and their sum don't fit into int, both in main loops and in tails
+    le_vec_clamp(a, 0, 0);
+    size_t indexes[] = {0, 1, 99, 100};
+    for (size_t i = 0; i < array_length(indexes); i++) {
+        le_vec_set_at(a, indexes[i], i % 2 == 0 ? INT_MAX : INT_MIN);
+        le_vec_set_at(b, indexes[i], INT_MIN);
+    }
+    long long big = (long long)INT_MAX * INT_MIN;
+    long long huge = (long long)INT_MIN * INT_MIN;
+    ASSERT_EQUAL(le_vec_dot(a, b, NULL), 2 * big + 2 * huge)
+
+    le_vec_push_back(b, 1);
+    ASSERT_EQUAL(le_vec_dot(a, b, &success), 0)
+    ASSERT_EQUAL(success, false)
+
+    le_vec_destroy(b);
+    le_vec_destroy(a);
+}
+
+void test_histogram(void) {
+    struct le_vec *v = random_vec(10000, 50, 17);
+    size_t counts[50];
+
+    ASSERT_EQUAL(le_vec_histogram(v, 0, 49, counts), true)
+    bool ok = true;
+    for (int value = 0; value < 50; value++) {
+        ok = ok && counts[value] == le_vec_count(v, value);
+    }
+    ASSERT(ok, "counts differ")
+
+    // Elements outside of the range are skipped, the range may start below all of them
+    ASSERT_EQUAL(le_vec_histogram(v, -5, 4, counts), true)
+    ASSERT_EQUAL(counts[0], 0)
+    ASSERT_EQUAL(counts[5], le_vec_count(v, 0))
+    ASSERT_EQUAL(counts[9], le_vec_count(v, 4))
+    ASSERT_EQUAL(le_vec_histogram(v, 5, 4, counts), false)
+    ASSERT_EQUAL(counts[9], le_vec_count(v, 4))
+
+    // Long runs of one value
+    struct le_vec *runs = le_vec_init();
+    for (int i = 0; i < 1000; i++) {
+        le_vec_push_back(runs, i < 900 ? 7 : INT_MAX);
+    }
+    ASSERT_EQUAL(le_vec_histogram(runs, INT_MAX - 1, INT_MAX, counts), true)
+    ASSERT_EQUAL(counts[0], 0)
+    ASSERT_EQUAL(counts[1], 100)
+    ASSERT_EQUAL(le_vec_histogram(runs, 7, 7, counts), true)
+    ASSERT_EQUAL(counts[0], 900)
+
+    le_vec_destroy(runs);
+    le_vec_destroy(v);
+}
+
+void test_value_counts(void) {
+    struct le_vec *v = signed_random_vec(2000, 1000000, 18);
+    for (int i = 0; i < 100; i++) {
+        le_vec_push_back(v, INT_MIN);
+        le_vec_push_back(v, 42);
+    }
+
+    struct le_vec_value_count *counts;
+    size_t distinct = le_vec_value_counts(v, &counts);
+    ASSERT_BGE(distinct, 3)
+
+    bool ok = counts[0].value == INT_MIN && counts[0].count == 100;
+    size_t total = 0;
+    for (size_t i = 0; i < distinct; i++) {
+        ok = ok && counts[i].count == le_vec_count(v, counts[i].value);
+        ok = ok && (i == 0 || counts[i - 1].value < counts[i].value);
+        total += counts[i].count;
+    }
+    ASSERT(ok, "counts differ")
+    ASSERT_EQUAL(total, 2200)
+    free(counts);
+
+    struct le_vec *empty = le_vec_init();
+    ASSERT_EQUAL(le_vec_value_counts(empty, &counts), 0)
+    ASSERT_EQUAL(counts, NULL)
+
+    le_vec_destroy(empty);
+    le_vec_destroy(v);
+}
+
+void test_count_many(void) {
+    struct le_vec *v = signed_random_vec(5000, 100, 19);
+    le_vec_push_back(v, INT_MAX);
+    size_t counts[6];
+
+    // Dense keys go through a histogram, sparse ones through a hash table
+    LE_VEC_TYPE dense[] = {0, -100, 99, 0, 1000, 50};
+    LE_VEC_TYPE sparse[] = {0, INT_MAX, -100, INT_MAX, INT_MIN, 7};
+    LE_VEC_TYPE const *keys[] = {dense, sparse};
+
+    for (size_t k = 0; k < 2; k++) {
+        le_vec_count_many(v, keys[k], 6, counts);
+        bool ok = true;
+        for (size_t i = 0; i < 6; i++) {
+            ok = ok && counts[i] == le_vec_count(v, keys[k][i]);
+        }
+        ASSERT(ok, "counts differ")
+    }
+    ASSERT_EQUAL(counts[1], 1)
+    ASSERT_EQUAL(counts[4], 0)
+
+    le_vec_destroy(v);
+}
+
+void test_histogram_parallel(void) {
+    size_t length = 3 * 1000 * 1000 + 7;
+    struct le_vec *v = signed_random_vec(length, 5000, 20);
+    LE_VEC_TYPE keys[] = {-5000, 0, 4999, 123456, 17};
+    size_t *counts[2];
+    size_t key_counts[2][5];
+    size_t distinct[2];
+    struct le_vec_value_count *values[2];
+
+    // The same counts with one thread and with four
+    for (size_t run = 0; run < 2; run++) {
+        le_vec_set_thread_count(run == 0 ? 1 : 4);
+        counts[run] = malloc(10000 * sizeof(size_t));
+        le_vec_histogram(v, -5000, 4999, counts[run]);
+        le_vec_count_many(v, keys, 5, key_counts[run]);
+        distinct[run] = le_vec_value_counts(v, &values[run]);
+    }
+    le_vec_set_thread_count(0);
+
+    bool ok = memcmp(counts[0], counts[1], 10000 * sizeof(size_t)) == 0;
+    ok = ok && memcmp(key_counts[0], key_counts[1], sizeof(key_counts[0])) == 0;
+    ok = ok && distinct[0] == distinct[1] && distinct[0] == 10000;
+    for (size_t i = 0; ok && i < distinct[0]; i++) {
+        ok = values[0][i].value == values[1][i].value && values[0][i].count == values[1][i].count;
+        ok = ok && values[0][i].count == counts[0][i];
+    }
+    ASSERT(ok, "parallel counts differ")
+    ASSERT_EQUAL(key_counts[1][3], 0)
+    ASSERT_EQUAL(key_counts[1][0], counts[1][0])
+
+    for (size_t run = 0; run < 2; run++) {
+        free(values[run]);
+        free(counts[run]);
+    }
+    le_vec_destroy(v);
+}
+
+void test_aggregates(void) {
+    bool success = false;
+    struct le_vec *v = le_vec_init();
+
+    ASSERT_EQUAL(le_vec_sum(v), 0)
+    le_vec_min(v, &success);
+    ASSERT_EQUAL(success, false)
+
+    for (int i = 0; i < 100; i++) {
+        le_vec_push_back(v, i - 50);
+    }
+    ASSERT_EQUAL(le_vec_sum(v), -50)
+    ASSERT_EQUAL(le_vec_min(v, &success), -50)
+    ASSERT_EQUAL(success, true)
+    ASSERT_EQUAL(le_vec_max(v, NULL), 49)
+    ASSERT_EQUAL(le_vec_range_sum(v, 50, 53, &success), 3)
+    ASSERT_EQUAL(le_vec_range_max(v, 0, 10, NULL), -41)
+    ASSERT_EQUAL(le_vec_range_sum(v, 10, 101, &success), 0)
+    ASSERT_EQUAL(success, false)
+    le_vec_range_min(v, 5, 5, &success);
+    ASSERT_EQUAL(success, false)
+
+    le_vec_destroy(v);
+}
+
+// Brute-force summary of [start; end) to check tracked aggregates against
+void brute_force_aggregates(struct le_vec *v, size_t start, size_t end, long long *sum, int *min, int *max) {
+    *sum = 0;
+    *min = INT_MAX;
+    *max = INT_MIN;
+    for (size_t i = start; i < end; i++) {
+        int value = le_vec_get_at(v, i);
+        *sum += value;
+        *min = value < *min ? value : *min;
+        *max = value > *max ? value : *max;
+    }
+}
+
+void test_aggregates_tracked(void) {
+    struct le_vec *v = random_vec(1000, 1000, 9);
+    struct le_vec *other = random_vec(300, 1000, 10);
+    le_vec_track_aggregates(v, true);
+    ASSERT_EQUAL(le_vec_is_tracking_aggregates(v), true)
+
+    unsigned seed = 1;
+    bool ok = true;
+    for (int step = 0; step < 3000 && ok; step++) {
+        seed = seed * 1103515245u + 12345u;
+        unsigned r = seed >> 8;
+        size_t length = le_vec_get_length(v);
+
+        switch (r % 9) {
+            case 0:
+                le_vec_push_back(v, (int)(r % 5000) - 2500);
+                break;
+            case 1:
+                if (length > 1) {
+                    le_vec_pop_back(v);
+                }
+                break;
+            case 2:
+            case 3:
+                le_vec_set_at(v, r % length, (int)(r % 7000) - 3500);
+                break;
+            case 4:
+                le_vec_resize(v, 1 + r % 3000);
+                for (size_t i = length; i < le_vec_get_length(v); i++) {
+                    le_vec_set_at(v, i, (int)i);
+                }
+                break;
+            case 5:
+                if (length < 5000) {
+                    le_vec_extend(v, other);
+                }
+                break;
+            case 6:
+                le_vec_replace_all(v, le_vec_get_at(v, r % length), -4000);
+                break;
+            case 7:
+                le_vec_rreplace_n(v, le_vec_get_at(v, r % length), 4000, 2);
+                break;
+            default:
+                if (length > 10) {
+                    le_vec_erase_range(v, r % (length - 10), r % (length - 10) + 5);
+                }
+                break;
+        }
+
+        length = le_vec_get_length(v);
+        size_t start = (r / 7) % length;
+        size_t end = start + (r / 11) % (length - start + 1);
+
+        long long sum;
+        int min;
+        int max;
+        brute_force_aggregates(v, 0, length, &sum, &min, &max);
+        ok = ok && le_vec_sum(v) == sum && le_vec_min(v, NULL) == min && le_vec_max(v, NULL) == max;
+
+        brute_force_aggregates(v, start, end, &sum, &min, &max);
+        ok = ok && le_vec_range_sum(v, start, end, NULL) == sum;
+        ok = ok && (start == end || (le_vec_range_min(v, start, end, NULL) == min && le_vec_range_max(v, start, end, NULL) == max));
+    }
+    ASSERT(ok, "tracked aggregates differ from brute force")
+
+    le_vec_track_aggregates(v, false);
+    ASSERT_EQUAL(le_vec_is_tracking_aggregates(v), false)
+
+    le_vec_destroy(other);
+    le_vec_destroy(v);
+}
+
+void test_init_placed(void) {
+    bool numa = le_vec_numa_node_count() > 1;
+    ASSERT(le_vec_numa_node_count() >= 1, "there must be at least one node")
+
+    ASSERT(le_vec_init_placed(0, LE_VEC_PLACEMENT_DEFAULT, 0) == NULL, "empty vector must not be created")
+
+    enum le_vec_placement placements[] = {
+        LE_VEC_PLACEMENT_DEFAULT,
+        LE_VEC_PLACEMENT_INTERLEAVED,
+        LE_VEC_PLACEMENT_NODE,
+        LE_VEC_PLACEMENT_PARTITIONED,
+    };
+    le_vec_set_thread_count(4);
+
+    for (size_t i = 0; i < array_length(placements); i++) {
+        size_t length = 2 * 1000 * 1000;
+        struct le_vec *v = le_vec_init_placed(length, placements[i], 0);
+
+        ASSERT_EQUAL(le_vec_get_length(v), length)
+        ASSERT_EQUAL(le_vec_count(v, 0), length)
+
+        le_vec_set_at(v, 5, 5);
+        ASSERT_EQUAL(le_vec_place(v, placements[i], 0), numa)
+        ASSERT_EQUAL(le_vec_get_at(v, 5), 5)
+
+        le_vec_destroy(v);
+    }
+
+    struct le_vec *v = le_vec_init_placed(100, LE_VEC_PLACEMENT_NODE, 0);
+    ASSERT_EQUAL(le_vec_place(v, LE_VEC_PLACEMENT_NODE, 100000), false)
+    le_vec_destroy(v);
+
+    le_vec_set_thread_count(0);
+}
+
+void test_parse_ints(void) {
+    struct le_vec *v = le_vec_init();
+    const char *text = "1,-2,+3\n4, 5 ,6\r\n-2147483648,2147483647,0000000000012,";
+    int expected[] = {1, -2, 3, 4, 5, 6, -2147483647 - 1, 2147483647, 12};
+
+    ASSERT_EQUAL(le_vec_parse_ints(v, text, strlen(text), ',', NULL), true)
+    ASSERT_EQUAL(le_vec_get_length(v), array_length(expected))
+    for (size_t i = 0; i < array_length(expected); i++) {
+        ASSERT_EQUAL(le_vec_get_at(v, i), expected[i])
+    }
+
+    ASSERT_EQUAL(le_vec_parse_ints(v, "", 0, ',', NULL), true)
+    ASSERT_EQUAL(le_vec_get_length(v), array_length(expected))
+
+    le_vec_destroy(v);
+
+    struct le_vec *spaces = le_vec_init();
+    ASSERT_EQUAL(le_vec_parse_ints(spaces, "7 8 9", 5, ' ', NULL), true)
+    ASSERT_EQUAL(le_vec_get_length(spaces), 3)
+    ASSERT_EQUAL(le_vec_get_at(spaces, 2), 9)
+    le_vec_destroy(spaces);
+}
+
+void test_parse_ints_errors(void) {
+    const char *texts[] = {
+        "1,,2", "12a", "2147483648", "-2147483649", "99999999999", "1;2", "1,-", ",", "5,\n6",
+        // Long enough for the fast path to see the whole field
+        "1,-2147483649,0000000000000000", "1,12345678x,000000000000000000",
+    };
+    size_t offsets[] = {2, 2, 9, 10, 9, 1, 3, 0, 2, 12, 10};
+    size_t lengths[] = {1, 0, 0, 0, 0, 0, 1, 0, 1, 1, 1};
+
+    for (size_t i = 0; i < array_length(texts); i++) {
+        struct le_vec *v = le_vec_init();
+        size_t offset = 12345;
+
+        ASSERT_EQUAL(le_vec_parse_ints(v, texts[i], strlen(texts[i]), ',', &offset), false)
+        ASSERT_EQUAL(offset, offsets[i])
+        ASSERT_EQUAL(le_vec_get_length(v), lengths[i])
+
+        le_vec_destroy(v);
+    }
+}
+
+// Returns text of `length` numbers separated by sep, numbers are written to values
+char *ints_text(size_t length, char sep, struct le_vec *values) {
+    char *text = malloc(length * 13 + 1);
+    size_t text_length = 0;
+    unsigned seed = 4;
+
+    for (size_t i = 0; i < length; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int value = (int)seed >> (seed % 31);
+        le_vec_push_back(values, value);
+        text_length += (size_t)sprintf(text + text_length, "%d%c", value, i % 10 == 9 ? '\n' : sep);
+    }
+
+    return text;
+}
+
+void test_parse_ints_large(void) {
+    struct le_vec *expected = le_vec_init();
+    char *text = ints_text(100000, ';', expected);
+    struct le_vec *v = le_vec_init();
+
+    ASSERT_EQUAL(le_vec_parse_ints(v, text, strlen(text), ';', NULL), true)
+    ASSERT_EQUAL(le_vec_get_length(v), 100000)
+    bool equal = true;
+    for (size_t i = 0; i < 100000; i++) {
+        equal = equal && le_vec_get_at(v, i) == le_vec_get_at(expected, i);
+    }
+    ASSERT(equal, "parsed values differ")
+
+    le_vec_destroy(v);
+    le_vec_destroy(expected);
+    free(text);
+}
+
+void test_parse_ints_fd(void) {
+    struct le_vec *expected = le_vec_init();
+    char *text = ints_text(100000, ',', expected);
+    size_t text_length = strlen(text);
+
+    FILE *f = tmpfile();
+    fwrite(text, 1, text_length, f);
+    fflush(f);
+    lseek(fileno(f), 0, SEEK_SET);
+
+    struct le_vec *v = le_vec_init();
+    ASSERT_EQUAL(le_vec_parse_ints_fd(v, fileno(f), ',', NULL), true)
+    ASSERT_EQUAL(le_vec_get_length(v), 100000)
+    bool equal = true;
+    for (size_t i = 0; i < 100000; i++) {
+        equal = equal && le_vec_get_at(v, i) == le_vec_get_at(expected, i);
+    }
+    ASSERT(equal, "parsed values differ")
+
+    // Error far beyond the first read
+    size_t bad = text_length - 5;
+    while (text[bad] == ',' || text[bad] == '\n' || text[bad] == '-') {
+        bad--;
+    }
+    text[bad] = 'x';
+    lseek(fileno(f), 0, SEEK_SET);
+    fwrite(text, 1, text_length, f);
+    fflush(f);
+    lseek(fileno(f), 0, SEEK_SET);
+
+    size_t offset = 0;
+    struct le_vec *broken = le_vec_init();
+    ASSERT_EQUAL(le_vec_parse_ints_fd(broken, fileno(f), ',', &offset), false)
+    ASSERT_EQUAL(offset, bad)
+
+    le_vec_destroy(broken);
+    le_vec_destroy(v);
+    le_vec_destroy(expected);
+    fclose(f);
+    free(text);
+}
+
+int negate_odd(int value) {
+    return value % 2 != 0 ? -value : value;
+}
+
+void test_format(void) {
+    struct le_vec *v = le_vec_init();
+    int values[] = {0, 7, -7, 42, 100, -2147483647 - 1, 2147483647, 1000000000};
+    for (size_t i = 0; i < array_length(values); i++) {
+        le_vec_push_back(v, values[i]);
+    }
+    const char *expected = "0,7,-7,42,100,-2147483648,2147483647,1000000000";
+    size_t expected_length = strlen(expected);
+
+    char buf[128];
+    ASSERT_EQUAL(le_vec_format(v, buf, sizeof(buf), ','), expected_length)
+    ASSERT(strcmp(buf, expected) == 0, "formatted text differs")
+
+    // Cut like snprintf()
+    char small[20];
+    ASSERT_EQUAL(le_vec_format(v, small, sizeof(small), ','), expected_length)
+    ASSERT(strncmp(small, expected, sizeof(small) - 1) == 0, "cut text differs")
+    ASSERT_EQUAL(small[sizeof(small) - 1], '\0')
+
+    ASSERT_EQUAL(le_vec_format(v, NULL, 0, ','), expected_length)
+
+    struct le_vec *empty = le_vec_init();
+    ASSERT_EQUAL(le_vec_format(empty, buf, sizeof(buf), ','), 0)
+    ASSERT_EQUAL(buf[0], '\0')
+    le_vec_destroy(empty);
+
+    le_vec_destroy(v);
+}
+
+void test_format_parse_roundtrip(void) {
+    struct le_vec *v = random_vec(10000, 2000000000, 5);
+    le_vec_for_each(v, negate_odd);
+
+    size_t length = le_vec_format(v, NULL, 0, '\n');
+    char *text = malloc(length + 1);
+    ASSERT_EQUAL(le_vec_format(v, text, length + 1, '\n'), length)
+
+    struct le_vec *parsed = le_vec_init();
+    ASSERT_EQUAL(le_vec_parse_ints(parsed, text, length, '\n', NULL), true)
+    ASSERT_EQUAL(le_vec_get_length(parsed), 10000)
+    bool equal = true;
+    for (size_t i = 0; i < 10000; i++) {
+        equal = equal && le_vec_get_at(parsed, i) == le_vec_get_at(v, i);
+    }
+    ASSERT(equal, "parsed values differ from formatted")
+
+    le_vec_destroy(parsed);
+    free(text);
+    le_vec_destroy(v);
+}
+
+void test_write_text_fd(void) {
+    struct le_vec *v = random_vec(300000, 2000000000, 6);
+    le_vec_for_each(v, negate_odd);
+
+    FILE *f = tmpfile();
+    ASSERT_EQUAL(le_vec_write_text_fd(v, fileno(f), ','), true)
+    lseek(fileno(f), 0, SEEK_SET);
+
+    struct le_vec *parsed = le_vec_init();
+    ASSERT_EQUAL(le_vec_parse_ints_fd(parsed, fileno(f), ',', NULL), true)
+    ASSERT_EQUAL(le_vec_get_length(parsed), 300000)
+    bool equal = true;
+    for (size_t i = 0; i < 300000; i++) {
+        equal = equal && le_vec_get_at(parsed, i) == le_vec_get_at(v, i);
+    }
+    ASSERT(equal, "values read back differ")
+
+    ASSERT_EQUAL(le_vec_write_text_fd(v, -1, ','), false)
+
+    le_vec_destroy(parsed);
+    fclose(f);
+    le_vec_destroy(v);
+}
+
+void test_write_text_fd_empty(void) {
+    struct le_vec *v = le_vec_init();
+
+    FILE *f = tmpfile();
+    ASSERT_EQUAL(le_vec_write_text_fd(v, fileno(f), ','), true)
+    lseek(fileno(f), 0, SEEK_SET);
+
+    char buf[4];
+    ASSERT_EQUAL(read(fileno(f), buf, sizeof(buf)), 1)
+    ASSERT_EQUAL(buf[0], '\n')
+
+    fclose(f);
+    le_vec_destroy(v);
+}
+
 void (*TESTS[])(void) = {
     test_init,
     test_init_with_length,
     test_init_with_invalid_length,
+    test_init_with_capacity,
     test_destroy_null,
     test_length_and_capacity_after_push,
     test_push_pop,
@@ -711,6 +3231,11 @@ void (*TESTS[])(void) = {
     test_last_index,
     test_get_at,
     test_resize,
+    test_push_after_resize_to_zero,
+    test_resize_uninit,
+    test_resize_fill,
+    test_iota,
+    test_fill_parallel,
     test_extend,
     test_map,
     test_for_each,
@@ -732,10 +3257,83 @@ void (*TESTS[])(void) = {
     test_rfind,
     test_rfind_invalid,
     test_rfind_n,
+    test_find_block_edges,
+    test_find_parallel,
     test_replace_all,
     test_replace_all_non_present,
     test_replace_n,
     test_rreplace_n,
+    test_insert_at,
+    test_insert_n_at,
+    test_erase_range,
+    test_remove_value,
+    test_remove_if,
+    test_find_all,
+    test_find_all_if,
+    test_equal,
+    test_compare,
+    test_hash,
+    test_hash_incremental,
+    test_sort,
+    test_unique,
+    test_lower_bound,
+    test_nth_element,
+    test_partial_sort,
+    test_top_k,
+    test_selection_parallel,
+    test_set_union,
+    test_set_intersection,
+    test_set_difference,
+    test_inclusive_scan,
+    test_exclusive_scan,
+    test_scan,
+    test_scan_parallel,
+    test_thread_count_follows_affinity,
+    test_gather,
+    test_scatter,
+    test_gather_scatter_parallel,
+    test_arithmetic,
+    test_arithmetic_invalid,
+    test_clamp_abs,
+    test_dot,
+    test_histogram,
+    test_value_counts,
+    test_count_many,
+    test_histogram_parallel,
+    test_aggregates,
+    test_aggregates_tracked,
+    test_init_placed,
+    test_parse_ints,
+    test_parse_ints_errors,
+    test_parse_ints_large,
+    test_parse_ints_fd,
+    test_format,
+    test_format_parse_roundtrip,
+    test_write_text_fd,
+    test_write_text_fd_empty,
+    test_compressed_sorted,
+    test_compressed_round_trip,
+    test_compressed_count_find_sum,
+    test_compressed_empty,
+    test_rle_push_pop,
+    test_rle_set_at,
+    test_rle_count_find_replace,
+    test_bool_push_get_set,
+    test_bool_count_find,
+    test_bool_reverse,
+    test_bool_bitwise,
+    test_table_push_pop,
+    test_table_columns,
+    test_table_gather,
+    test_persistent_push_set_pop,
+    test_persistent_concat_slice,
+    test_persistent_transient,
+    test_jagged_build,
+    test_jagged_edit_compact,
+    test_jagged_from_vecs,
+    test_track_changes,
+    test_track_changes_sparse,
+    test_stats,
 };
 
 int main() {